@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+
+"""
+Convert a compressed (SDLOG_COMPRESS) and/or delta encoded (SDLOG_DELTA) ULog file into a regular ULog file.
+
+Compressed: the ULog header and the flag bits message are stored uncompressed, followed by a sequence of frames:
+uint16 compressed_size, uint16 uncompressed_size, then the compressed data (heatshrink, window size 8,
+lookahead 4). Frames with compressed_size == uncompressed_size are stored as-is.
+
+Delta encoded: 'X' messages contain a msg_id followed by runs of: uint8 number of unchanged bytes, uint8 number of
+changed bytes n, then n bytes XOR'ed with the previous data message of the same msg_id.
+
+Data appended by the hardfault handler (at appended_offsets) is not encoded.
+"""
+
+import argparse
+import struct
+import sys
+
+ULOG_HEADER_SIZE = 16
+FLAG_BITS_SIZE = 43
+FRAMES_START = ULOG_HEADER_SIZE + FLAG_BITS_SIZE
+INCOMPAT_FLAG0_DATA_APPENDED_MASK = 1 << 0
+INCOMPAT_FLAG0_COMPRESSED_MASK = 1 << 1
+INCOMPAT_FLAG0_DELTA_MASK = 1 << 2
+WINDOW_SIZE = 8
+LOOKAHEAD_SIZE = 4
+
+
+def heatshrink_decompress(data, window_size=WINDOW_SIZE, lookahead_size=LOOKAHEAD_SIZE):
+    """ decode a heatshrink stream (the trailing bits of the last byte are padding) """
+    out = bytearray()
+    total_bits = len(data) * 8
+    bit_pos = 0
+
+    def read_bits(count):
+        nonlocal bit_pos
+        if bit_pos + count > total_bits:
+            return None
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | ((data[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1)
+            bit_pos += 1
+        return value
+
+    while True:
+        tag = read_bits(1)
+        if tag is None:
+            break
+        if tag:
+            byte = read_bits(8)
+            if byte is None:
+                break
+            out.append(byte)
+        else:
+            index = read_bits(window_size)
+            if index is None:
+                break
+            count = read_bits(lookahead_size)
+            if count is None:
+                break
+            # the window is zero-initialized, so back-references can point before the start of the stream
+            distance = index + 1
+            for _ in range(count + 1):
+                out.append(out[-distance] if distance <= len(out) else 0)
+    return bytes(out)
+
+
+def read_flag_bits(data):
+    """ returns the flag bits fields and the end of the data section (start of appended data) """
+    if len(data) < FRAMES_START or data[:7] != b'ULog\x01\x12\x35':
+        raise ValueError('not a ULog file')
+
+    msg_size, msg_type, compat_flags, incompat_flags, *appended_offsets = \
+        struct.unpack_from('<HB8s8s3Q', data, ULOG_HEADER_SIZE)
+    if msg_type != ord('B'):
+        raise ValueError('missing flag bits message')
+
+    data_end = len(data)
+    if incompat_flags[0] & INCOMPAT_FLAG0_DATA_APPENDED_MASK and \
+            FRAMES_START <= appended_offsets[0] < len(data):
+        data_end = appended_offsets[0]
+    return msg_size, msg_type, compat_flags, bytearray(incompat_flags), appended_offsets, data_end
+
+
+def replace_data(data, decoded, decoded_flag):
+    """ replace the data section with the decoded data (which includes the file header and the flag bits) """
+    msg_size, msg_type, compat_flags, incompat_flags, appended_offsets, data_end = read_flag_bits(data)
+
+    # move the appended data behind the decoded data
+    decoded_end = len(decoded)
+    for i in range(3):
+        if appended_offsets[i] >= data_end:
+            appended_offsets[i] = appended_offsets[i] - data_end + decoded_end
+    decoded += data[data_end:]
+
+    incompat_flags[0] &= ~decoded_flag
+    struct.pack_into('<HB8s8s3Q', decoded, ULOG_HEADER_SIZE, msg_size, msg_type, compat_flags,
+                     bytes(incompat_flags), *appended_offsets)
+    return bytes(decoded)
+
+
+def decompress_ulog(data):
+    _, _, _, incompat_flags, _, data_end = read_flag_bits(data)
+    if not incompat_flags[0] & INCOMPAT_FLAG0_COMPRESSED_MASK:
+        return data
+
+    out = bytearray(data[:FRAMES_START])
+    offset = FRAMES_START
+    while offset + 4 <= data_end:
+        compressed_size, uncompressed_size = struct.unpack_from('<HH', data, offset)
+        offset += 4
+        if offset + compressed_size > data_end:
+            print('Warning: log ends with an incomplete frame', file=sys.stderr)
+            break
+        frame = data[offset:offset + compressed_size]
+        if compressed_size != uncompressed_size:
+            frame = heatshrink_decompress(frame)
+            if len(frame) != uncompressed_size:
+                print('Warning: corrupt frame at offset {:}, stopping'.format(offset), file=sys.stderr)
+                break
+        out += frame
+        offset += compressed_size
+
+    return replace_data(data, out, INCOMPAT_FLAG0_COMPRESSED_MASK)
+
+
+def expand_deltas(data):
+    _, _, _, incompat_flags, _, data_end = read_flag_bits(data)
+    if not incompat_flags[0] & INCOMPAT_FLAG0_DELTA_MASK:
+        return data
+
+    out = bytearray(data[:FRAMES_START])
+    last_samples = {}  # msg_id -> last payload (including the msg_id)
+    offset = FRAMES_START
+    while offset + 3 <= data_end:
+        msg_size, msg_type = struct.unpack_from('<HB', data, offset)
+        end = offset + 3 + msg_size
+        if end > data_end:
+            break
+        payload = data[offset + 3:end]
+
+        if msg_type == ord('D') and msg_size >= 2:
+            last_samples[payload[:2]] = bytearray(payload)
+            out += data[offset:end]
+        elif msg_type == ord('X') and msg_size >= 2:
+            sample = last_samples.get(payload[:2])
+            if sample is not None and apply_delta(payload[2:], sample):
+                out += struct.pack('<HB', len(sample), ord('D')) + sample
+            else:
+                # cannot be decoded without the previous sample, skip until the next keyframe
+                last_samples.pop(payload[:2], None)
+        else:
+            out += data[offset:end]
+        offset = end
+
+    return replace_data(data, out, INCOMPAT_FLAG0_DELTA_MASK)
+
+
+def apply_delta(delta, sample):
+    """ apply a delta in-place to a sample (which starts with the msg_id) """
+    pos = 2
+    i = 0
+    while i + 2 <= len(delta):
+        unchanged, changed = delta[i], delta[i + 1]
+        i += 2
+        pos += unchanged
+        if i + changed > len(delta) or pos + changed > len(sample):
+            return False
+        for _ in range(changed):
+            sample[pos] ^= delta[i]
+            pos += 1
+            i += 1
+    return i == len(delta)
+
+
+def decode_ulog(data):
+    _, _, _, incompat_flags, _, _ = read_flag_bits(data)
+    if not incompat_flags[0] & (INCOMPAT_FLAG0_COMPRESSED_MASK | INCOMPAT_FLAG0_DELTA_MASK):
+        raise ValueError('file is neither compressed nor delta encoded')
+    return expand_deltas(decompress_ulog(data))
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser(description="""CLI tool to decompress an ulog file\n""")
+    parser.add_argument("ulog_file", help=".ulgz or .ulg file")
+    parser.add_argument("-o", "--output", help="output file (default: .ulgz input file name without the trailing 'z')",
+                        default=None)
+
+    args = parser.parse_args()
+
+    output = args.output
+    if output is None:
+        if not args.ulog_file.endswith('.ulgz'):
+            print('Need an output file name for files not ending with .ulgz')
+            sys.exit(1)
+        output = args.ulog_file[:-1]
+
+    with open(args.ulog_file, 'rb') as f:
+        data = f.read()
+
+    try:
+        decompressed = decode_ulog(data)
+    except ValueError as e:
+        print('Error: {:}'.format(e))
+        sys.exit(1)
+
+    with open(output, 'wb') as f:
+        f.write(decompressed)
+
+    print('Wrote {:} ({:} -> {:} bytes)'.format(output, len(data), len(decompressed)))
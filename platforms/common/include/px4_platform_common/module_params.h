@@ -79,7 +79,8 @@ public:
 protected:
 	/**
 	 * @brief Call this method whenever the module gets a parameter change notification.
-	 *        It will automatically call updateParams() for all children, which then call updateParamsImpl().
+	 *        It will automatically call updateParams() for all children, which then call updateParamsImpl()
+	 *        if any of their parameters changed since the last update.
 	 */
 	virtual void updateParams()
 	{
@@ -87,7 +88,16 @@ protected:
 			child->updateParams();
 		}
 
-		updateParamsImpl();
+		// load the generation first, so that concurrent changes are picked up on the next update
+		const uint32_t generation = param_change_generation();
+
+		if (generation != _param_generation) {
+			if (paramsChangedSince(_param_generation)) {
+				updateParamsImpl();
+			}
+
+			_param_generation = generation;
+		}
 	}
 
 	/**
@@ -95,8 +105,16 @@ protected:
 	 */
 	virtual void updateParamsImpl() {}
 
+	/**
+	 * @brief Check if any of the parameters might have changed after a change generation.
+	 *        The implementation for this is generated with the macro DEFINE_PARAMETERS()
+	 */
+	virtual bool paramsChangedSince(uint32_t generation) const { return false; }
+
 private:
 	/** @list _children The module parameter list of inheriting classes. */
 	List<ModuleParams *> _children;
 	ModuleParams *_parent{nullptr};
+
+	uint32_t _param_generation{param_change_generation()}; ///< parameter change generation of the last update
 };
@@ -73,6 +73,10 @@ public:
 	 */
 	void ScheduleClear();
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	uint32_t RunInterval() const override { return static_cast<uint32_t>(_call.period); }
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 protected:
 
 	ScheduledWorkItem(const char *name, const wq_config_t &config) : WorkItem(name, config) {}
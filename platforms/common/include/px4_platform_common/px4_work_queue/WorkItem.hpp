@@ -36,8 +36,8 @@
 #include "WorkQueueManager.hpp"
 #include "WorkQueue.hpp"
 
-#include <containers/IntrusiveQueue.hpp>
 #include <containers/IntrusiveSortedList.hpp>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
 #include <lib/mathlib/mathlib.h>
@@ -48,7 +48,7 @@
 namespace px4
 {
 
-class WorkItem : public IntrusiveSortedListNode<WorkItem *>, public IntrusiveQueueNode<WorkItem *>
+class WorkItem : public IntrusiveSortedListNode<WorkItem *>
 {
 public:
 
@@ -83,6 +83,52 @@ public:
 
 	const char *ItemName() const { return _item_name; }
 
+	/**
+	 * Set the priority of this item within its WorkQueue. When several items are queued at the
+	 * same time, higher priority items run first, items of equal priority run in FIFO order.
+	 *
+	 * @param run_priority 0 (default, lowest) to 255
+	 */
+	void SetRunPriority(uint8_t run_priority) { _run_priority = run_priority; }
+
+	uint8_t RunPriority() const { return _run_priority; }
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	const WorkItemRunStats &RunStats() const { return _run_stats; }
+
+	/**
+	 * Expected run interval (microseconds), used to detect deadline misses. 0 if unknown.
+	 */
+	virtual uint32_t RunInterval() const { return 0; }
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Notified once when the item starts its next run (used for the uORB callback latency statistics).
+	 */
+	class RunObserver
+	{
+	public:
+		virtual void RunStarted(hrt_abstime now) = 0;
+	protected:
+		~RunObserver() = default;
+	};
+
+	bool HasRunObserver() const { return _run_observer.load() != nullptr; }
+
+	/**
+	 * Register an observer for the start of the next run. Only one observer can be pending at a time.
+	 * @return true if registered
+	 */
+	bool SetRunObserver(RunObserver *observer)
+	{
+		RunObserver *expected = nullptr;
+		return _run_observer.compare_exchange(&expected, observer);
+	}
+
+	void ClearRunObserver(RunObserver *observer) { _run_observer.compare_exchange(&observer, nullptr); }
+#endif // CONFIG_ORB_LATENCY_STATS
+
 protected:
 
 	explicit WorkItem(const char *name, const wq_config_t &config);
@@ -106,9 +152,30 @@ protected:
 		} else {
 			_run_count++;
 		}
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+		_run_start = hrt_absolute_time();
+		RecordLatency(_run_start - _queued_time);
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		RunObserver *observer = _run_observer.load();
+
+		if (observer != nullptr) {
+			observer->RunStarted(hrt_absolute_time());
+			// only released after the observer is done, it can be registered again from here on
+			_run_observer.store(nullptr);
+		}
+
+#endif // CONFIG_ORB_LATENCY_STATS
 	}
 
-	friend void WorkQueue::Run();
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	void RunPostamble(hrt_abstime run_end);
+	void RecordLatency(uint32_t latency_us);
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -134,6 +201,21 @@ private:
 
 	WorkQueue	*_wq{nullptr};
 
+	// WorkQueue run queue linkage, owned by the WorkQueue
+	WorkItem	*_run_queue_next{nullptr};
+	px4::atomic_bool _queued{false};
+	uint8_t		_run_priority{0};
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	hrt_abstime	_queued_time{0};
+	hrt_abstime	_run_start{0};
+	WorkItemRunStats _run_stats{};
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	px4::atomic<RunObserver *> _run_observer{nullptr};
+#endif // CONFIG_ORB_LATENCY_STATS
+
 };
 
 } // namespace px4
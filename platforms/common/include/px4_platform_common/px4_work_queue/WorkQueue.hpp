@@ -37,12 +37,16 @@
 
 #include <containers/BlockingList.hpp>
 #include <containers/List.hpp>
-#include <containers/IntrusiveQueue.hpp>
 #include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/sem.h>
 #include <px4_platform_common/tasks.h>
 
+#if defined(__PX4_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif // __PX4_LINUX
+
 namespace px4
 {
 
@@ -73,6 +77,16 @@ public:
 
 	void print_status(bool last = false);
 
+	size_t item_count();
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	/**
+	 * Copy the run statistics of the index-th attached WorkItem.
+	 * @return false if index is out of range
+	 */
+	bool GetRunStatus(unsigned index, WorkItemRunStatus &status);
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
 
@@ -82,6 +96,31 @@ private:
 
 	inline void SignalWorkerThread();
 
+	/**
+	 * Move all items added since the last call into the priority ordered run queue.
+	 * NOTE: work_lock() must be held.
+	 */
+	void DrainPending();
+
+	/**
+	 * Pop the highest priority item from the run queue.
+	 * NOTE: work_lock() must be held.
+	 */
+	WorkItem *PopRunQueue();
+
+	/**
+	 * Remove an item from the run queue.
+	 * NOTE: work_lock() must be held.
+	 */
+	bool RemoveFromRunQueue(WorkItem *item);
+
+#if defined(__PX4_LINUX)
+	/**
+	 * Track the CPU the worker thread runs on and count migrations between wakeups.
+	 */
+	void UpdateCpu();
+#endif // __PX4_LINUX
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -94,7 +133,10 @@ private:
 	px4_sem_t _qlock;
 #endif
 
-	IntrusiveQueue<WorkItem *>	_q;
+	// Items are added lock-free to the pending stack (multiple producers) and moved by the
+	// worker thread (single consumer) into the run queue, ordered by WorkItem run priority.
+	px4::atomic<WorkItem *>	_pending{nullptr};
+	WorkItem			*_run_queue{nullptr};
 	px4_sem_t			_process_lock;
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
@@ -105,6 +147,16 @@ private:
 	int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	WorkItem			*_running_item{nullptr}; // protected by work_lock()
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+#if defined(__PX4_LINUX)
+	pthread_t			_thread {};
+	px4::atomic_int			_cpu{-1};
+	px4::atomic<uint32_t>		_cpu_migrations{0};
+#endif // __PX4_LINUX
+
 };
 
 } // namespace px4
@@ -33,6 +33,8 @@
 
 #pragma once
 
+#include <px4_platform_common/px4_config.h>
+
 #include <stdint.h>
 
 namespace px4
@@ -72,6 +74,17 @@ static constexpr wq_config_t INS1{"wq:INS1", 6000, -15};
 static constexpr wq_config_t INS2{"wq:INS2", 6000, -16};
 static constexpr wq_config_t INS3{"wq:INS3", 6000, -17};
 
+// one queue per estimator instance (multi-EKF on multi-core targets), same priority as the first INS queue
+static constexpr wq_config_t EKF0{"wq:EKF0", 6000, -14};
+static constexpr wq_config_t EKF1{"wq:EKF1", 6000, -14};
+static constexpr wq_config_t EKF2{"wq:EKF2", 6000, -14};
+static constexpr wq_config_t EKF3{"wq:EKF3", 6000, -14};
+static constexpr wq_config_t EKF4{"wq:EKF4", 6000, -14};
+static constexpr wq_config_t EKF5{"wq:EKF5", 6000, -14};
+static constexpr wq_config_t EKF6{"wq:EKF6", 6000, -14};
+static constexpr wq_config_t EKF7{"wq:EKF7", 6000, -14};
+static constexpr wq_config_t EKF8{"wq:EKF8", 6000, -14};
+
 static constexpr wq_config_t hp_default{"wq:hp_default", 2800, -18};
 
 static constexpr wq_config_t uavcan{"wq:uavcan", 3624, -19};
@@ -96,6 +109,40 @@ static constexpr wq_config_t test2{"wq:test2", 2000, 0};
 
 } // namespace wq_configurations
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+struct WorkItemRunStats {
+	static constexpr int HISTOGRAM_BUCKETS = 10;
+
+	// upper bucket limits (microseconds), the last bucket collects everything above
+	static constexpr uint32_t BUCKET_LIMITS[HISTOGRAM_BUCKETS - 1] {20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+	static int bucket(uint32_t time_us)
+	{
+		int i = 0;
+
+		while ((i < HISTOGRAM_BUCKETS - 1) && (time_us >= BUCKET_LIMITS[i])) {
+			i++;
+		}
+
+		return i;
+	}
+
+	uint32_t execution_time_hist[HISTOGRAM_BUCKETS] {}; // time spent in Run()
+	uint32_t latency_hist[HISTOGRAM_BUCKETS] {}; // time from being queued (ScheduleNow) until Run()
+	uint32_t execution_time_max{0};
+	uint32_t latency_max{0};
+	uint32_t deadline_misses{0}; // runs that didn't finish within the interval of a ScheduledWorkItem
+	uint32_t run_count{0};
+};
+
+struct WorkItemRunStatus {
+	char item_name[24];
+	char wq_name[24];
+	uint32_t interval; // ScheduledWorkItem interval (microseconds), 0 if not scheduled on an interval
+	WorkItemRunStats stats;
+};
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 /**
  * Start the work queue manager task.
  */
@@ -137,5 +184,18 @@ const wq_config_t &serial_port_to_wq(const char *serial);
 
 const wq_config_t &ins_instance_to_wq(uint8_t instance);
 
+const wq_config_t &estimator_instance_to_wq(uint8_t instance);
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+/**
+ * Get the run statistics of a WorkItem.
+ *
+ * @param index		WorkItem index, counted over all work queues.
+ * @param status		Filled with the WorkItem run statistics.
+ * @return		false if index is out of range.
+ */
+bool WorkQueueManagerRunStatus(unsigned index, WorkItemRunStatus &status);
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 
 } // namespace px4
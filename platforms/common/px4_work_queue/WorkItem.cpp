@@ -42,6 +42,10 @@
 namespace px4
 {
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+constexpr uint32_t WorkItemRunStats::BUCKET_LIMITS[];
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 WorkItem::WorkItem(const char *name, const wq_config_t &config) :
 	_item_name(name)
 {
@@ -132,6 +136,37 @@ float WorkItem::average_interval() const
 	return 0.f;
 }
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+void WorkItem::RecordLatency(uint32_t latency_us)
+{
+	_run_stats.latency_hist[WorkItemRunStats::bucket(latency_us)]++;
+
+	if (latency_us > _run_stats.latency_max) {
+		_run_stats.latency_max = latency_us;
+	}
+}
+
+void WorkItem::RunPostamble(hrt_abstime run_end)
+{
+	const uint32_t execution_time = run_end - _run_start;
+
+	_run_stats.execution_time_hist[WorkItemRunStats::bucket(execution_time)]++;
+
+	if (execution_time > _run_stats.execution_time_max) {
+		_run_stats.execution_time_max = execution_time;
+	}
+
+	// deadline: finished before the next interval started
+	const uint32_t interval = RunInterval();
+
+	if ((interval > 0) && (run_end - _queued_time > interval)) {
+		_run_stats.deadline_misses++;
+	}
+
+	_run_stats.run_count++;
+}
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 void WorkItem::print_run_status()
 {
 	PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us\n", _item_name, (double)average_rate(), (double)average_interval());
@@ -105,6 +105,15 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+
+	// the item might be detached (or deleted) from within its own Run()
+	if (_running_item == item) {
+		_running_item = nullptr;
+	}
+
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
@@ -128,7 +137,24 @@ void WorkQueue::Detach(WorkItem *item)
 
 void WorkQueue::Add(WorkItem *item)
 {
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// registration must be ordered with the unregister check in Run()
 	work_lock();
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+
+	// nothing to do if already queued
+	bool queued = false;
+
+	if (!item->_queued.compare_exchange(&queued, true)) {
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+		work_unlock();
+#endif // ENABLE_LOCKSTEP_SCHEDULER
+		return;
+	}
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	item->_queued_time = hrt_absolute_time();
+#endif // CONFIG_PX4_WQ_RUN_STATS
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
@@ -138,8 +164,16 @@ void WorkQueue::Add(WorkItem *item)
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
-	_q.push(item);
+	// push onto the pending stack (lock-free, drained by the worker thread)
+	WorkItem *head = _pending.load();
+
+	do {
+		item->_run_queue_next = head;
+	} while (!_pending.compare_exchange(&head, item));
+
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	work_unlock();
+#endif // ENABLE_LOCKSTEP_SCHEDULER
 
 	SignalWorkerThread();
 }
@@ -153,46 +187,165 @@ void WorkQueue::SignalWorkerThread()
 	}
 }
 
+void WorkQueue::DrainPending()
+{
+	// take the whole pending stack at once
+	WorkItem *pending = _pending.load();
+
+	while (!_pending.compare_exchange(&pending, nullptr)) {}
+
+	// reverse it to restore the order in which the items were added
+	WorkItem *fifo = nullptr;
+
+	while (pending != nullptr) {
+		WorkItem *next = pending->_run_queue_next;
+		pending->_run_queue_next = fifo;
+		fifo = pending;
+		pending = next;
+	}
+
+	// insert each after all items of higher or equal priority
+	while (fifo != nullptr) {
+		WorkItem *item = fifo;
+		fifo = fifo->_run_queue_next;
+
+		WorkItem **pos = &_run_queue;
+
+		while ((*pos != nullptr) && ((*pos)->_run_priority >= item->_run_priority)) {
+			pos = &(*pos)->_run_queue_next;
+		}
+
+		item->_run_queue_next = *pos;
+		*pos = item;
+	}
+}
+
+WorkItem *WorkQueue::PopRunQueue()
+{
+	DrainPending();
+
+	WorkItem *item = _run_queue;
+
+	if (item != nullptr) {
+		_run_queue = item->_run_queue_next;
+		item->_run_queue_next = nullptr;
+
+		// allow the item to be queued again (it might requeue itself while running)
+		item->_queued.store(false);
+	}
+
+	return item;
+}
+
+bool WorkQueue::RemoveFromRunQueue(WorkItem *item)
+{
+	DrainPending();
+
+	for (WorkItem **pos = &_run_queue; *pos != nullptr; pos = &(*pos)->_run_queue_next) {
+		if (*pos == item) {
+			*pos = item->_run_queue_next;
+			item->_run_queue_next = nullptr;
+			item->_queued.store(false);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void WorkQueue::Remove(WorkItem *item)
 {
-	work_lock();
-	_q.remove(item);
-	work_unlock();
+	// An Add() that already claimed the item (_queued set) might not have pushed it onto the pending stack yet.
+	// Wait for the push to land and remove it, otherwise the item would still run after ScheduleClear() or Deinit().
+	// The wait happens outside of the lock (a critical section on NuttX), so that the Add() can complete, even from
+	// an interrupt. If the worker thread pops the item in the meantime, it is no longer queued either.
+	for (;;) {
+		work_lock();
+		const bool add_in_flight = !RemoveFromRunQueue(item) && item->_queued.load();
+		work_unlock();
+
+		if (!add_in_flight) {
+			break;
+		}
+
+		px4_usleep(1);
+	}
 }
 
 void WorkQueue::Clear()
 {
 	work_lock();
 
-	while (!_q.empty()) {
-		_q.pop();
-	}
+	while (PopRunQueue() != nullptr) {}
 
 	work_unlock();
 }
 
+#if defined(__PX4_LINUX)
+void WorkQueue::UpdateCpu()
+{
+	const int cpu = sched_getcpu();
+	const int previous_cpu = _cpu.load();
+
+	if (cpu != previous_cpu) {
+		if (previous_cpu >= 0) {
+			_cpu_migrations.fetch_add(1);
+		}
+
+		_cpu.store(cpu);
+	}
+}
+#endif // __PX4_LINUX
+
 void WorkQueue::Run()
 {
+#if defined(__PX4_LINUX)
+	_thread = pthread_self();
+#endif // __PX4_LINUX
+
 	while (!should_exit()) {
 		// loop as the wait may be interrupted by a signal
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
+#if defined(__PX4_LINUX)
+		UpdateCpu();
+#endif // __PX4_LINUX
+
 		work_lock();
 
 		// process queued work
-		while (!_q.empty()) {
-			WorkItem *work = _q.pop();
+		WorkItem *work = PopRunQueue();
+
+		while (work != nullptr) {
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+			_running_item = work;
+#endif // CONFIG_PX4_WQ_RUN_STATS
 
 			work_unlock(); // unlock work queue to run (item may requeue itself)
 			work->RunPreamble();
 			work->Run();
 			// Note: after Run() we cannot access work anymore, as it might have been deleted
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+			const hrt_abstime run_end = hrt_absolute_time();
+#endif // CONFIG_PX4_WQ_RUN_STATS
 			work_lock(); // re-lock
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+
+			// still valid unless it was detached during Run()
+			if (_running_item != nullptr) {
+				_running_item->RunPostamble(run_end);
+				_running_item = nullptr;
+			}
+
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
+			work = PopRunQueue();
 		}
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		if (_q.empty()) {
+		if ((_run_queue == nullptr) && (_pending.load() == nullptr)) {
 			px4_lockstep_unregister_component(_lockstep_component);
 			_lockstep_component = -1;
 		}
@@ -205,10 +358,53 @@ void WorkQueue::Run()
 	PX4_DEBUG("%s: exiting", _config.name);
 }
 
+size_t WorkQueue::item_count()
+{
+	return _work_items.size();
+}
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+bool WorkQueue::GetRunStatus(unsigned index, WorkItemRunStatus &status)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	unsigned i = 0;
+
+	for (WorkItem *item : _work_items) {
+		if (i == index) {
+			strncpy(status.item_name, item->ItemName(), sizeof(status.item_name) - 1);
+			status.item_name[sizeof(status.item_name) - 1] = '\0';
+			strncpy(status.wq_name, get_name(), sizeof(status.wq_name) - 1);
+			status.wq_name[sizeof(status.wq_name) - 1] = '\0';
+			status.interval = item->RunInterval();
+			status.stats = item->RunStats();
+			return true;
+		}
+
+		i++;
+	}
+
+	return false;
+}
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 void WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
+
+#if defined(__PX4_LINUX)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	const bool pinned = (_cpu.load() >= 0)
+			    && (pthread_getaffinity_np(_thread, sizeof(cpuset), &cpuset) == 0)
+			    && (CPU_COUNT(&cpuset) == 1);
+
+	PX4_INFO_RAW("%-16s cpu: %2d%s migrations: %" PRIu32 "\n", get_name(), _cpu.load(), pinned ? " (pinned)," : ",",
+		     _cpu_migrations.load());
+#else
 	PX4_INFO_RAW("%-16s\n", get_name());
+#endif // __PX4_LINUX
+
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
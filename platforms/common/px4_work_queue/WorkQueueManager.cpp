@@ -226,6 +226,106 @@ const wq_config_t &ins_instance_to_wq(uint8_t instance)
 	return wq_configurations::INS0;
 }
 
+const wq_config_t &estimator_instance_to_wq(uint8_t instance)
+{
+	switch (instance) {
+	case 0: return wq_configurations::EKF0;
+
+	case 1: return wq_configurations::EKF1;
+
+	case 2: return wq_configurations::EKF2;
+
+	case 3: return wq_configurations::EKF3;
+
+	case 4: return wq_configurations::EKF4;
+
+	case 5: return wq_configurations::EKF5;
+
+	case 6: return wq_configurations::EKF6;
+
+	case 7: return wq_configurations::EKF7;
+
+	case 8: return wq_configurations::EKF8;
+	}
+
+	PX4_WARN("no EKF%d wq configuration, using EKF0", instance);
+
+	return wq_configurations::EKF0;
+}
+
+#if defined(__PX4_LINUX) && defined(CONFIG_PX4_WQ_CPU_AFFINITY)
+/**
+ * Look up the CPU a work queue should be pinned to in the core map
+ * ("<wq name>=<cpu>,..."), the PX4_WQ_CPU_AFFINITY environment variable
+ * overrides the board configuration.
+ * @return cpu or -1 if the work queue isn't pinned
+ */
+static int
+WorkQueueCpuAffinity(const char *name)
+{
+	const char *map = getenv("PX4_WQ_CPU_AFFINITY");
+
+	if (map == nullptr) {
+		map = CONFIG_PX4_WQ_CPU_AFFINITY_MAP;
+	}
+
+	const size_t name_len = strlen(name);
+	const char *entry = map;
+
+	while (entry != nullptr) {
+		while ((*entry == ',') || (*entry == ' ')) {
+			entry++;
+		}
+
+		const char *separator = strchr(entry, '=');
+
+		if (separator == nullptr) {
+			break;
+		}
+
+		if (((size_t)(separator - entry) == name_len) && (strncmp(entry, name, name_len) == 0)) {
+			char *end = nullptr;
+			const long cpu = strtol(separator + 1, &end, 10);
+
+			if ((end != separator + 1) && (cpu >= 0) && (cpu < sysconf(_SC_NPROCESSORS_CONF)) && (cpu < CPU_SETSIZE)) {
+				return cpu;
+			}
+
+			PX4_ERR("%s: invalid cpu in core map", name);
+			return -1;
+		}
+
+		entry = strchr(separator, ',');
+	}
+
+	return -1;
+}
+#endif // __PX4_LINUX && CONFIG_PX4_WQ_CPU_AFFINITY
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+bool
+WorkQueueManagerRunStatus(unsigned index, WorkItemRunStatus &status)
+{
+	if (!_wq_manager_running.load()) {
+		return false;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		const size_t num_items = wq->item_count();
+
+		if (index < num_items) {
+			return wq->GetRunStatus(index, status);
+		}
+
+		index -= num_items;
+	}
+
+	return false;
+}
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 static void *
 WorkQueueRunner(void *context)
 {
@@ -319,6 +419,27 @@ WorkQueueManagerRun(int, char **)
 				PX4_ERR("setting sched params for %s failed (%i)", wq->name, ret_setschedparam);
 			}
 
+#if defined(__PX4_LINUX) && defined(CONFIG_PX4_WQ_CPU_AFFINITY)
+			// CPU affinity (cores reserved with isolcpus are allowed)
+			const int cpu = WorkQueueCpuAffinity(wq->name);
+
+			if (cpu >= 0) {
+				cpu_set_t cpuset;
+				CPU_ZERO(&cpuset);
+				CPU_SET(cpu, &cpuset);
+
+				int ret_setaffinity = pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+
+				if (ret_setaffinity == 0) {
+					PX4_DEBUG("%s: pinned to cpu %d", wq->name, cpu);
+
+				} else {
+					PX4_ERR("setting cpu affinity for %s failed (%i)", wq->name, ret_setaffinity);
+				}
+			}
+
+#endif // __PX4_LINUX && CONFIG_PX4_WQ_CPU_AFFINITY
+
 			// create thread
 			pthread_t thread;
 			int ret_create = pthread_create(&thread, &attr, WorkQueueRunner, (void *)wq);
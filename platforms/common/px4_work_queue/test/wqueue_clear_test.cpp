@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "wqueue_clear_test.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+using namespace px4;
+
+px4::atomic_int WQueueClearTest::errors{0};
+px4::atomic_int WQueueClearTest::deleted_count{0};
+pthread_mutex_t WQueueClearTest::target_mutex = PTHREAD_MUTEX_INITIALIZER;
+WQueueClearTarget *WQueueClearTest::target{nullptr};
+
+void WQueueClearTarget::Run()
+{
+	if (_canary != CANARY) {
+		// ran after ScheduleClear() and deletion
+		WQueueClearTest::errors.fetch_add(1);
+		return;
+	}
+
+	if (++_runs >= _runs_before_exit) {
+		// races with the scheduler's ScheduleNow() that might be in flight
+		ScheduleClear();
+
+		WQueueClearTest::release_target();
+		WQueueClearTest::deleted_count.fetch_add(1);
+		delete this;
+	}
+}
+
+void WQueueClearScheduler::Run()
+{
+	WQueueClearTest::schedule_target();
+
+	if (!_should_stop.load()) {
+		ScheduleNow();
+	}
+}
+
+void WQueueClearTest::schedule_target()
+{
+	pthread_mutex_lock(&target_mutex);
+
+	if (target != nullptr) {
+		target->ScheduleNow();
+	}
+
+	pthread_mutex_unlock(&target_mutex);
+}
+
+void WQueueClearTest::release_target()
+{
+	pthread_mutex_lock(&target_mutex);
+	target = nullptr;
+	pthread_mutex_unlock(&target_mutex);
+}
+
+int WQueueClearTest::main()
+{
+	errors.store(0);
+	deleted_count.store(0);
+
+	WQueueClearScheduler scheduler;
+	scheduler.start();
+
+	bool timeout = false;
+
+	for (int i = 0; (i < ROUNDS) && !timeout; i++) {
+		WQueueClearTarget *new_target = new WQueueClearTarget(1 + i % 4);
+
+		if (new_target == nullptr) {
+			PX4_ERR("alloc failed");
+			break;
+		}
+
+		pthread_mutex_lock(&target_mutex);
+		target = new_target;
+		pthread_mutex_unlock(&target_mutex);
+
+		// wait for the target to delete itself
+		const hrt_abstime timeout_time = hrt_absolute_time() + 1000000;
+
+		while (deleted_count.load() <= i) {
+			if (hrt_absolute_time() > timeout_time) {
+				PX4_ERR("round %d: timeout", i);
+				release_target();
+				timeout = true;
+				break;
+			}
+
+			px4_usleep(100);
+		}
+	}
+
+	scheduler.stop();
+
+	// let any (erroneously) remaining runs happen
+	px4_usleep(10000);
+
+	if (timeout || (errors.load() != 0)) {
+		PX4_ERR("WQueueClearTest failed, %d runs after deletion", errors.load());
+		return 1;
+	}
+
+	PX4_INFO("WQueueClearTest finished");
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+#include <pthread.h>
+
+using namespace px4;
+
+// Deletes itself from within Run() after a few runs, like a module exiting (ScheduleClear() followed by deletion)
+class WQueueClearTarget : public px4::WorkItem
+{
+public:
+	WQueueClearTarget(int runs_before_exit) :
+		px4::WorkItem("WQueueClearTarget", px4::wq_configurations::test1),
+		_runs_before_exit(runs_before_exit)
+	{}
+
+	~WQueueClearTarget() override { _canary = 0; }
+
+private:
+
+	static constexpr uint32_t CANARY = 0xC1EA4ED0;
+
+	void Run() override;
+
+	uint32_t _canary{CANARY};
+	int _runs_before_exit;
+	int _runs{0};
+};
+
+// Races ScheduleNow() from another work queue against the target clearing and deleting itself
+class WQueueClearTest
+{
+public:
+	WQueueClearTest() = default;
+	~WQueueClearTest() = default;
+
+	int main();
+
+	/**
+	 * Schedule the current target (if any), called by the scheduler.
+	 */
+	static void schedule_target();
+
+	/**
+	 * Unpublish the target, after this schedule_target() no longer accesses it.
+	 */
+	static void release_target();
+
+	static px4::atomic_int errors;
+	static px4::atomic_int deleted_count;
+
+private:
+
+	static constexpr int ROUNDS = 2000;
+
+	static pthread_mutex_t target_mutex;
+	static WQueueClearTarget *target;
+};
+
+// Keeps calling ScheduleNow() on the current target by requeuing itself
+class WQueueClearScheduler : public px4::WorkItem
+{
+public:
+	WQueueClearScheduler() : px4::WorkItem("WQueueClearScheduler", px4::wq_configurations::test2) {}
+	~WQueueClearScheduler() = default;
+
+	void start() { _should_stop.store(false); ScheduleNow(); }
+	void stop() { _should_stop.store(true); }
+
+private:
+
+	void Run() override;
+
+	px4::atomic_bool _should_stop{true};
+};
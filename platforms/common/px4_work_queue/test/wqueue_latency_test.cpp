@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "wqueue_latency_test.h"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+using namespace px4;
+
+void WQueueLatencyLoad::Run()
+{
+	// simulate a short cycle of a lower priority item
+	const hrt_abstime start = hrt_absolute_time();
+
+	while (hrt_elapsed_time(&start) < 100) {}
+
+	if (!_should_stop.load()) {
+		ScheduleNow();
+	}
+}
+
+void WQueueLatencyTest::Run()
+{
+	perf_set_elapsed(_latency_perf, hrt_absolute_time() - _add_time.load());
+	_run_count.fetch_add(1);
+}
+
+bool WQueueLatencyTest::measure(const char *name)
+{
+	_latency_perf = perf_alloc(PC_ELAPSED, name);
+	_run_count.store(0);
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		_add_time.store(hrt_absolute_time());
+		ScheduleNow();
+
+		// wait for the item to run
+		const hrt_abstime timeout = hrt_absolute_time() + 100000;
+
+		while (_run_count.load() <= i) {
+			if (hrt_absolute_time() > timeout) {
+				PX4_ERR("%s: timeout", name);
+				perf_free(_latency_perf);
+				return false;
+			}
+
+			px4_usleep(100);
+		}
+	}
+
+	perf_print_counter(_latency_perf);
+	perf_free(_latency_perf);
+	_latency_perf = nullptr;
+
+	return true;
+}
+
+int WQueueLatencyTest::main()
+{
+	bool ret = measure("add to run latency (idle)");
+
+	for (auto &load : _load) {
+		load.start();
+	}
+
+	SetRunPriority(0);
+	ret = ret && measure("add to run latency (loaded, run priority 0)");
+
+	SetRunPriority(UINT8_MAX);
+	ret = ret && measure("add to run latency (loaded, run priority 255)");
+
+	for (auto &load : _load) {
+		load.stop();
+	}
+
+	// let the load items finish
+	px4_usleep(10000);
+
+	PX4_INFO("WQueueLatencyTest finished");
+
+	return ret ? 0 : 1;
+}
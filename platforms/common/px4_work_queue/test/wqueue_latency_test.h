@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+using namespace px4;
+
+// Keeps the work queue busy by requeuing itself
+class WQueueLatencyLoad : public px4::WorkItem
+{
+public:
+	WQueueLatencyLoad() : px4::WorkItem("WQueueLatencyLoad", px4::wq_configurations::test1) {}
+	~WQueueLatencyLoad() = default;
+
+	void start() { _should_stop.store(false); ScheduleNow(); }
+	void stop() { _should_stop.store(true); }
+
+private:
+
+	void Run() override;
+
+	px4::atomic_bool _should_stop{true};
+};
+
+// Measures the time from WorkQueue::Add() (ScheduleNow) until Run() is called
+class WQueueLatencyTest : public px4::WorkItem
+{
+public:
+	WQueueLatencyTest() : px4::WorkItem("WQueueLatencyTest", px4::wq_configurations::test1) {}
+	~WQueueLatencyTest() = default;
+
+	int main();
+
+private:
+
+	static constexpr int NUM_LOAD_ITEMS = 4;
+	static constexpr int ITERATIONS = 1000;
+
+	void Run() override;
+
+	bool measure(const char *name);
+
+	WQueueLatencyLoad _load[NUM_LOAD_ITEMS] {};
+
+	px4::atomic<hrt_abstime> _add_time{0};
+	px4::atomic_int _run_count{0};
+
+	perf_counter_t _latency_perf{nullptr};
+};
@@ -32,6 +32,8 @@
  ****************************************************************************/
 
 #include "wqueue_test.h"
+#include "wqueue_clear_test.h"
+#include "wqueue_latency_test.h"
 #include "wqueue_scheduled_test.h"
 
 #include <px4_platform_common/log.h>
@@ -51,6 +53,14 @@ int PX4_MAIN(int argc, char **argv)
 	WQueueScheduledTest wq2;
 	wq2.main();
 
+	PX4_INFO("wqueue test 3 (add to run latency)");
+	WQueueLatencyTest wq3;
+	wq3.main();
+
+	PX4_INFO("wqueue test 4 (ScheduleClear and delete while scheduled)");
+	WQueueClearTest wq4;
+	wq4.main();
+
 	PX4_INFO("wqueue test complete, exiting");
 
 	return 0;
@@ -113,6 +113,38 @@ public:
 
 		return (Manager::orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
+
+	/**
+	 * Loan the next message buffer inside the topic queue to fill in place (zero-copy).
+	 * The buffer holds stale data and the topic is locked until commit() is called,
+	 * so every successful loan() must be followed by commit().
+	 * @return nullptr if loaning isn't available, use publish() instead
+	 */
+	T *loan()
+	{
+#if defined(__PX4_POSIX)
+
+		if (!advertised()) {
+			advertise();
+		}
+
+		return static_cast<T *>(Manager::orb_loan(get_topic(), _handle));
+#else
+		return nullptr;
+#endif // __PX4_POSIX
+	}
+
+	/**
+	 * Publish the buffer returned by loan().
+	 */
+	bool commit()
+	{
+#if defined(__PX4_POSIX)
+		return (Manager::orb_commit(_handle) == PX4_OK);
+#else
+		return false;
+#endif // __PX4_POSIX
+	}
 };
 
 /**
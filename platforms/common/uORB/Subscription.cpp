@@ -73,6 +73,56 @@ void Subscription::unsubscribe()
 	_last_generation = 0;
 }
 
+bool Subscription::borrow(Borrowed &borrowed)
+{
+#if defined(CONFIG_ORB_SEQLOCK)
+
+	if (!valid()) {
+		subscribe();
+	}
+
+	if (valid()) {
+		borrowed.generation = _last_generation;
+		borrowed.data = uORB::Manager::orb_data_borrow(_node, borrowed.generation, borrowed.seq);
+		return borrowed.data != nullptr;
+	}
+
+#endif // CONFIG_ORB_SEQLOCK
+
+	borrowed.data = nullptr;
+	return false;
+}
+
+bool Subscription::release(const Borrowed &borrowed)
+{
+#if defined(CONFIG_ORB_SEQLOCK)
+
+	if (valid() && (borrowed.data != nullptr) && uORB::Manager::orb_data_borrow_valid(_node, borrowed.seq)) {
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		const unsigned generation_before = _last_generation;
+		_last_generation = borrowed.generation;
+		count_lost_messages(generation_before);
+#else
+		_last_generation = borrowed.generation;
+#endif // CONFIG_ORB_LATENCY_STATS
+		return true;
+	}
+
+#endif // CONFIG_ORB_SEQLOCK
+
+	return false;
+}
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+void Subscription::count_lost_messages(unsigned generation_before)
+{
+	// with a queue length of 1 only the latest message is of interest, skipped ones are not lost
+	if ((_last_generation != generation_before) && (Manager::orb_get_queue_size(_node) > 1)) {
+		_lost_messages += _last_generation - generation_before - 1;
+	}
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
 bool Subscription::ChangeInstance(uint8_t instance)
 {
 	if (instance != _instance) {
@@ -155,7 +155,18 @@ public:
 			subscribe();
 		}
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		const unsigned generation_before = _last_generation;
+
+		if (valid() && Manager::orb_data_copy(_node, dst, _last_generation, true)) {
+			count_lost_messages(generation_before);
+			return true;
+		}
+
+		return false;
+#else
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, true) : false;
+#endif // CONFIG_ORB_LATENCY_STATS
 	}
 
 	/**
@@ -168,9 +179,44 @@ public:
 			subscribe();
 		}
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		const unsigned generation_before = _last_generation;
+
+		if (valid() && Manager::orb_data_copy(_node, dst, _last_generation, false)) {
+			count_lost_messages(generation_before);
+			return true;
+		}
+
+		return false;
+#else
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, false) : false;
+#endif // CONFIG_ORB_LATENCY_STATS
 	}
 
+	/**
+	 * Read-only view of a message inside the topic buffer, see borrow().
+	 */
+	struct Borrowed {
+		const void *data{nullptr};
+		unsigned generation{0};
+		unsigned seq{0};
+	};
+
+	/**
+	 * Borrow the next update in place instead of copying it (zero-copy).
+	 * A publisher can overwrite the data at any time, so the reader must call
+	 * release() once done and discard whatever it read if that returns false.
+	 * @param borrowed Filled with the view on success.
+	 * @return false if there is no update or borrowing isn't available (use update() instead)
+	 */
+	bool borrow(Borrowed &borrowed);
+
+	/**
+	 * Release a view obtained with borrow() and mark it as read if it is still valid.
+	 * @return true if the data was not modified while it was borrowed
+	 */
+	bool release(const Borrowed &borrowed);
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
@@ -183,6 +229,13 @@ public:
 
 	ORB_ID orb_id() const { return _orb_id; }
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Number of queued messages that were overwritten before this subscription could read them.
+	 */
+	uint32_t lost_messages() const { return _lost_messages; }
+#endif // CONFIG_ORB_LATENCY_STATS
+
 protected:
 
 	friend class SubscriptionCallback;
@@ -196,6 +249,12 @@ protected:
 
 	ORB_ID _orb_id{ORB_ID::INVALID};
 	uint8_t _instance{0};
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	void count_lost_messages(unsigned generation_before);
+
+	uint32_t _lost_messages{0};
+#endif // CONFIG_ORB_LATENCY_STATS
 };
 
 // Subscription wrapper class with data
@@ -135,14 +135,28 @@ public:
 
 	bool registered() const { return _registered; }
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Set by the publisher right before call(), the publication time of the new message.
+	 */
+	void set_publish_time(hrt_abstime publish_time) { _publish_time = publish_time; }
+#endif // CONFIG_ORB_LATENCY_STATS
+
 protected:
 
 	bool _registered{false};
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	hrt_abstime _publish_time{0};
+#endif // CONFIG_ORB_LATENCY_STATS
+
 };
 
 // Subscription with callback that schedules a WorkItem
 class SubscriptionCallbackWorkItem : public SubscriptionCallback
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	, private px4::WorkItem::RunObserver
+#endif // CONFIG_ORB_LATENCY_STATS
 {
 public:
 	/**
@@ -158,7 +172,14 @@ public:
 	{
 	}
 
-	virtual ~SubscriptionCallbackWorkItem() = default;
+	virtual ~SubscriptionCallbackWorkItem()
+	{
+		unregisterCallback();
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		_work_item->ClearRunObserver(this);
+#endif // CONFIG_ORB_LATENCY_STATS
+	}
 
 	void call() override
 	{
@@ -166,6 +187,15 @@ public:
 		if ((_required_updates == 0)
 		    || (Manager::updates_available(_subscription.get_node(), _subscription.get_last_generation()) >= _required_updates)) {
 			if (updated()) {
+#if defined(CONFIG_ORB_LATENCY_STATS)
+
+				// only written while this is not the pending run observer (read in RunStarted())
+				if ((_publish_time != 0) && !_work_item->HasRunObserver()) {
+					_dispatch_publish_time = _publish_time;
+					_work_item->SetRunObserver(this);
+				}
+
+#endif // CONFIG_ORB_LATENCY_STATS
 				_work_item->ScheduleNow();
 			}
 		}
@@ -183,6 +213,18 @@ public:
 	}
 
 private:
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	// called by the WorkItem when it starts running after a publication of this topic scheduled it
+	void RunStarted(hrt_abstime now) override
+	{
+		if (now >= _dispatch_publish_time) {
+			Manager::orb_record_callback_latency(_subscription.get_node(), now - _dispatch_publish_time);
+		}
+	}
+
+	hrt_abstime _dispatch_publish_time{0};
+#endif // CONFIG_ORB_LATENCY_STATS
+
 	px4::WorkItem *_work_item;
 
 	uint8_t _required_updates{0};
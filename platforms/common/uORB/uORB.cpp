@@ -113,6 +113,23 @@ int uorb_top(char **topic_filter, int num_filters)
 	return OK;
 }
 
+int uorb_latency(char **topic_filter, int num_filters)
+{
+#if defined(CONFIG_ORB_LATENCY_STATS) && (!defined(__PX4_NUTTX) || defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+
+	if (g_dev != nullptr) {
+		g_dev->printLatencyStatistics(topic_filter, num_filters);
+
+	} else {
+		PX4_INFO("uorb is not running");
+	}
+
+#else
+	PX4_INFO("latency statistics not available (CONFIG_ORB_LATENCY_STATS)");
+#endif
+	return OK;
+}
+
 orb_advert_t orb_advertise(const struct orb_metadata *meta, const void *data)
 {
 	return uORB::Manager::get_instance()->orb_advertise(meta, data);
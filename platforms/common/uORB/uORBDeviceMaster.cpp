@@ -431,6 +431,79 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 #undef CLEAR_LINE
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+void uORB::DeviceMaster::printLatencyStatistics(char **topic_filter, int num_filters)
+{
+	/* Add all nodes to a list while locked, and then print them in unlocked state, to avoid potential
+	 * dead-locks (where printing blocks) */
+	lock();
+	DeviceNodeStatisticsData *first_node = nullptr;
+	DeviceNodeStatisticsData *cur_node = nullptr;
+	size_t max_topic_name_length = 0;
+	int num_topics = 0;
+	int ret = addNewDeviceNodes(&first_node, num_topics, max_topic_name_length, topic_filter, num_filters);
+	unlock();
+
+	if (ret != 0) {
+		PX4_ERR("addNewDeviceNodes failed (%i)", ret);
+	}
+
+	PX4_INFO_RAW("latency histogram buckets [us]: <%" PRIu32, LatencyHistogram::BUCKET_LIMITS_US[0]);
+
+	for (int i = 1; i < LatencyHistogram::NUM_BUCKETS - 1; i++) {
+		PX4_INFO_RAW(" <%" PRIu32, LatencyHistogram::BUCKET_LIMITS_US[i]);
+	}
+
+	PX4_INFO_RAW(" >=%" PRIu32 "\n", LatencyHistogram::BUCKET_LIMITS_US[LatencyHistogram::NUM_BUCKETS - 2]);
+	PX4_INFO_RAW("%-*s INST #SUB   LOST     HISTOGRAM\n", (int)max_topic_name_length - 2, "TOPIC NAME");
+
+	cur_node = first_node;
+
+	while (cur_node) {
+		orb_latency_s stats{};
+
+		if (cur_node->node->get_latency_statistics(stats)) {
+			PX4_INFO_RAW("%-*s %2i %4i %6" PRIu32 " copy:", (int)max_topic_name_length, cur_node->node->get_meta()->o_name,
+				     (int)stats.instance, (int)stats.subscriber_count, stats.lost_messages);
+
+			for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+				PX4_INFO_RAW(" %6" PRIu32, stats.copy_latency_hist[i]);
+			}
+
+			PX4_INFO_RAW("\n%-*s %14s   cb:", (int)max_topic_name_length, "", "");
+
+			for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+				PX4_INFO_RAW(" %6" PRIu32, stats.callback_latency_hist[i]);
+			}
+
+			PX4_INFO_RAW("\n");
+		}
+
+		DeviceNodeStatisticsData *prev = cur_node;
+		cur_node = cur_node->next;
+		delete prev;
+	}
+}
+
+bool uORB::DeviceMaster::getLatencyStatistics(int index, orb_latency_s &stats)
+{
+	lock();
+
+	for (const auto &node : _node_list) {
+		if (node->get_latency_statistics(stats)) {
+			if (index-- == 0) {
+				unlock();
+				return true;
+			}
+		}
+	}
+
+	unlock();
+
+	return false;
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 {
 	lock();
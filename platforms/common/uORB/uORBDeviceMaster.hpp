@@ -53,6 +53,10 @@ class Manager;
 #include <containers/IntrusiveSortedList.hpp>
 #include <px4_platform_common/atomic_bitset.h>
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+#include <uORB/topics/orb_latency.h>
+#endif // CONFIG_ORB_LATENCY_STATS
+
 using px4::AtomicBitset;
 
 /**
@@ -115,6 +119,22 @@ public:
 	 */
 	void showTop(char **topic_filter, int num_filters);
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Print the latency histograms and lost messages of each topic with recorded statistics.
+	 * @param topic_filter list of topic filters: if set, each string can be a substring for topics to match.
+	 * @param num_filters
+	 */
+	void printLatencyStatistics(char **topic_filter, int num_filters);
+
+	/**
+	 * Get the latency statistics of the n-th topic (in node list order) with recorded statistics.
+	 * @param index position of the topic, starting at 0
+	 * @return false if there are less than index + 1 topics with statistics
+	 */
+	bool getLatencyStatistics(int index, orb_latency_s &stats);
+#endif // CONFIG_ORB_LATENCY_STATS
+
 private:
 	// Private constructor, uORB::Manager takes care of its creation
 	DeviceMaster();
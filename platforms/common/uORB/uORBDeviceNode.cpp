@@ -59,6 +59,10 @@ uORB::DeviceNode::~DeviceNode()
 {
 	free(_data);
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	free(_publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
+
 	const char *devname = get_devname();
 
 	if (devname) {
@@ -136,18 +140,9 @@ uORB::DeviceNode::read(cdev::file_t *filp, char *buffer, size_t buflen)
 	return filp_to_subscription(filp)->copy(buffer) ? _meta->o_size : 0;
 }
 
-ssize_t
-uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
+bool
+uORB::DeviceNode::allocate_data()
 {
-	/*
-	 * Writes are legal from interrupt context as long as the
-	 * object has already been initialised from thread context.
-	 *
-	 * Writes outside interrupt context will allocate the object
-	 * if it has not yet been allocated.
-	 *
-	 * Note that filp will usually be NULL.
-	 */
 	if (nullptr == _data) {
 
 #ifdef __PX4_NUTTX
@@ -165,6 +160,11 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 				if (_data) {
 					memset(_data, 0, data_size);
 				}
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+				// statistics are best effort, publishing works without them
+				_publish_time = (hrt_abstime *)calloc(_meta->o_queue, sizeof(hrt_abstime));
+#endif // CONFIG_ORB_LATENCY_STATS
 			}
 
 			unlock();
@@ -176,10 +176,29 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 		/* failed or could not allocate */
 		if (nullptr == _data) {
-			return -ENOMEM;
+			return false;
 		}
 	}
 
+	return true;
+}
+
+ssize_t
+uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
+{
+	/*
+	 * Writes are legal from interrupt context as long as the
+	 * object has already been initialised from thread context.
+	 *
+	 * Writes outside interrupt context will allocate the object
+	 * if it has not yet been allocated.
+	 *
+	 * Note that filp will usually be NULL.
+	 */
+	if (!allocate_data()) {
+		return -ENOMEM;
+	}
+
 	/* If write size does not match, that is an error */
 	if (_meta->o_size != buflen) {
 		return -EIO;
@@ -187,13 +206,37 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 	/* Perform an atomic copy. */
 	ATOMIC_ENTER;
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	// mark write in progress (odd) before touching the data, lock-free readers retry
+	_seq.fetch_add(1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif // CONFIG_ORB_SEQLOCK
+
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
 	unsigned generation = _generation.fetch_add(1);
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	const hrt_abstime publish_time = hrt_absolute_time();
+
+	if (_publish_time != nullptr) {
+		_publish_time[generation % _meta->o_queue] = publish_time;
+	}
+
+#endif // CONFIG_ORB_LATENCY_STATS
+
 	memcpy(_data + (_meta->o_size * (generation % _meta->o_queue)), buffer, _meta->o_size);
 
+#if defined(CONFIG_ORB_SEQLOCK)
+	// write complete (even)
+	_seq.fetch_add(1);
+#endif // CONFIG_ORB_SEQLOCK
+
 	// callbacks
 	for (auto item : _callbacks) {
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		item->set_publish_time(publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
 		item->call();
 	}
 
@@ -291,6 +334,84 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	return PX4_OK;
 }
 
+#if defined(__PX4_POSIX)
+void *
+uORB::DeviceNode::loan(const orb_metadata *meta, orb_advert_t handle)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr) || (devnode->_meta->o_id != meta->o_id)) {
+		return nullptr;
+	}
+
+	if (!devnode->allocate_data()) {
+		return nullptr;
+	}
+
+	// held until commit(), subscribers wait for (or retry) the write like for a regular publication
+	devnode->lock();
+	devnode->_loaned.store(true);
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	devnode->_seq.fetch_add(1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif // CONFIG_ORB_SEQLOCK
+
+	return devnode->_data + (meta->o_size * (devnode->_generation.load() % meta->o_queue));
+}
+
+int
+uORB::DeviceNode::commit(orb_advert_t handle)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if (devnode == nullptr) {
+		return PX4_ERROR;
+	}
+
+	// commit() without an outstanding loan() must neither publish nor unlock
+	bool loaned = true;
+
+	if (!devnode->_loaned.compare_exchange(&loaned, false)) {
+		return PX4_ERROR;
+	}
+
+	const unsigned generation = devnode->_generation.fetch_add(1);
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	const hrt_abstime publish_time = hrt_absolute_time();
+
+	if (devnode->_publish_time != nullptr) {
+		devnode->_publish_time[generation % devnode->_meta->o_queue] = publish_time;
+	}
+
+#else
+	(void)generation;
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	devnode->_seq.fetch_add(1);
+#endif // CONFIG_ORB_SEQLOCK
+
+	// callbacks
+	for (auto item : devnode->_callbacks) {
+#if defined(CONFIG_ORB_LATENCY_STATS)
+		item->set_publish_time(publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
+		item->call();
+	}
+
+	devnode->_data_valid = true;
+
+	devnode->unlock();
+
+	/* notify any poll waiters */
+	devnode->poll_notify(POLLIN);
+
+	return PX4_OK;
+}
+#endif // __PX4_POSIX
+
 int uORB::DeviceNode::unadvertise(orb_advert_t handle)
 {
 	if (handle == nullptr) {
@@ -364,6 +485,55 @@ uORB::DeviceNode::print_statistics(int max_topic_length)
 	return true;
 }
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+constexpr uint32_t uORB::LatencyHistogram::BUCKET_LIMITS_US[];
+
+void uORB::DeviceNode::update_copy_statistics(unsigned generation_before, unsigned generation_after,
+		hrt_abstime publish_time)
+{
+	if ((generation_after == generation_before) || (publish_time == 0)) {
+		// nothing new was copied
+		return;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (now >= publish_time) {
+		_copy_latency.record(now - publish_time);
+	}
+
+	// with a queue length of 1 only the latest message is of interest, skipped ones are not lost
+	if (_meta->o_queue > 1) {
+		const unsigned lost = generation_after - generation_before - 1;
+
+		if (lost > 0) {
+			_lost_messages.fetch_add(lost);
+		}
+	}
+}
+
+bool uORB::DeviceNode::get_latency_statistics(orb_latency_s &stats) const
+{
+	if (!_advertised || (_copy_latency.total() == 0 && _callback_latency.total() == 0)) {
+		return false;
+	}
+
+	stats.orb_id = _meta->o_id;
+	stats.instance = _instance;
+	stats.subscriber_count = _subscriber_count;
+	stats.lost_messages = _lost_messages.load();
+
+	static_assert(orb_latency_s::HISTOGRAM_BUCKETS == LatencyHistogram::NUM_BUCKETS, "histogram size mismatch");
+
+	for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+		stats.copy_latency_hist[i] = _copy_latency.get(i);
+		stats.callback_latency_hist[i] = _callback_latency.get(i);
+	}
+
+	return true;
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
 void uORB::DeviceNode::add_internal_subscriber()
 {
 	lock();
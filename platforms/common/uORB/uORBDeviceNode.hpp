@@ -43,6 +43,12 @@
 #include <px4_platform_common/atomic.h>
 #include <px4_platform_common/px4_config.h>
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+#include "uORBLatency.hpp"
+
+#include <uORB/topics/orb_latency.h>
+#endif // CONFIG_ORB_LATENCY_STATS
+
 namespace uORB
 {
 class DeviceNode;
@@ -225,43 +231,134 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
-			if (_meta->o_queue == 1) {
-				ATOMIC_ENTER;
-				memcpy(dst, _data, _meta->o_size);
-				generation = _generation.load();
-				ATOMIC_LEAVE;
-				return true;
-
-			} else {
-				ATOMIC_ENTER;
-				const unsigned current_generation = _generation.load();
-
-				if (current_generation == generation) {
-					/* The subscriber already read the latest message, but nothing new was published yet.
-					* Return the previous message
-					*/
-					--generation;
-				}
+#if defined(CONFIG_ORB_LATENCY_STATS)
+			const unsigned generation_before = generation;
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_ORB_SEQLOCK)
+
+			// optimistic read, retried if a publisher was writing concurrently
+			for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+				const unsigned seq = _seq.load();
 
-				// Compatible with normal and overflow conditions
-				if (!is_in_range(current_generation - _meta->o_queue, generation, current_generation - 1)) {
-					// Reader is too far behind: some messages are lost
-					generation = current_generation - _meta->o_queue;
+				if (seq & 1) {
+					// write in progress
+					continue;
 				}
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _meta->o_queue)), _meta->o_size);
-				ATOMIC_LEAVE;
+				unsigned copy_generation = generation;
+				const unsigned slot = copy_unlocked(dst, copy_generation);
 
-				++generation;
+#if defined(CONFIG_ORB_LATENCY_STATS)
+				const hrt_abstime publish_time = get_publish_time(slot);
+#else
+				(void)slot;
+#endif // CONFIG_ORB_LATENCY_STATS
 
-				return true;
+				// order the data reads before re-checking the sequence
+				__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+				if (_seq.load() == seq) {
+					generation = copy_generation;
+#if defined(CONFIG_ORB_LATENCY_STATS)
+					update_copy_statistics(generation_before, generation, publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
+					return true;
+				}
 			}
+
+			// the publisher held the node for too long (e.g. it was preempted), wait for it on the node lock
+#endif // CONFIG_ORB_SEQLOCK
+
+			ATOMIC_ENTER;
+			const unsigned slot = copy_unlocked(dst, generation);
+#if defined(CONFIG_ORB_LATENCY_STATS)
+			const hrt_abstime publish_time = get_publish_time(slot);
+#else
+			(void)slot;
+#endif // CONFIG_ORB_LATENCY_STATS
+			ATOMIC_LEAVE;
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+			update_copy_statistics(generation_before, generation, publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
+
+			return true;
 		}
 
 		return false;
 
 	}
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Fill in the latency statistics of this node.
+	 * @return false if nothing was recorded yet
+	 */
+	bool get_latency_statistics(orb_latency_s &stats) const;
+
+	/**
+	 * Record the time from a publication until a callback it triggered started running.
+	 */
+	void record_callback_latency(hrt_abstime latency) { _callback_latency.record(latency); }
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(__PX4_POSIX)
+	/**
+	 * Loan the next queue slot to a publisher so it can write the message in place.
+	 * The node stays locked until the loan is committed, every successful loan()
+	 * must be followed by commit().
+	 *
+	 * @return pointer to the slot (containing stale data), nullptr on failure.
+	 */
+	static void *loan(const orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Publish the message written into the slot returned by loan() and unlock the node.
+	 * @return PX4_ERROR if there is no outstanding loan
+	 */
+	static int commit(orb_advert_t handle);
+#endif // __PX4_POSIX
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	/**
+	 * Borrow a read-only view of the message following 'generation' without copying it.
+	 * The view must be validated with borrow_valid() after reading, as a publisher
+	 * can overwrite it at any time.
+	 *
+	 * @param generation
+	 *   The generation that was borrowed.
+	 * @param seq
+	 *   Sequence to pass to borrow_valid().
+	 * @return pointer to the message, nullptr if a publisher is currently writing.
+	 */
+	const void *borrow(unsigned &generation, unsigned &seq)
+	{
+		if (_data == nullptr) {
+			return nullptr;
+		}
+
+		seq = _seq.load();
+
+		if (seq & 1) {
+			// write in progress
+			return nullptr;
+		}
+
+		return slot_unlocked(generation);
+	}
+
+	/**
+	 * Check that no publication happened since borrow() returned 'seq'.
+	 */
+	bool borrow_valid(unsigned seq) const
+	{
+		// order the data reads before re-checking the sequence
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return _seq.load() == seq;
+	}
+#endif // CONFIG_ORB_SEQLOCK
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -277,11 +374,87 @@ protected:
 private:
 	friend uORBTest::UnitTest;
 
+	/**
+	 * Returns the index of the queue slot following 'generation' and advances 'generation'
+	 * past it, without any synchronization.
+	 * The caller is responsible for holding the node lock or validating the read.
+	 */
+	unsigned slot_index_unlocked(unsigned &generation) const
+	{
+		if (_meta->o_queue == 1) {
+			generation = _generation.load();
+			return 0;
+		}
+
+		const unsigned current_generation = _generation.load();
+
+		if (current_generation == generation) {
+			/* The subscriber already read the latest message, but nothing new was published yet.
+			* Return the previous message
+			*/
+			--generation;
+		}
+
+		// Compatible with normal and overflow conditions
+		if (!is_in_range(current_generation - _meta->o_queue, generation, current_generation - 1)) {
+			// Reader is too far behind: some messages are lost
+			generation = current_generation - _meta->o_queue;
+		}
+
+		const unsigned slot = generation % _meta->o_queue;
+
+		++generation;
+
+		return slot;
+	}
+
+	const uint8_t *slot_unlocked(unsigned &generation) const
+	{
+		return _data + (_meta->o_size * slot_index_unlocked(generation));
+	}
+
+	/**
+	 * Copies data and the corresponding generation without any synchronization.
+	 * The caller is responsible for holding the node lock or validating the copy.
+	 * @return the queue slot index that was copied
+	 */
+	unsigned copy_unlocked(void *dst, unsigned &generation)
+	{
+		const unsigned slot = slot_index_unlocked(generation);
+		memcpy(dst, _data + (_meta->o_size * slot), _meta->o_size);
+		return slot;
+	}
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	hrt_abstime get_publish_time(unsigned slot) const { return (_publish_time != nullptr) ? _publish_time[slot] : 0; }
+
+	void update_copy_statistics(unsigned generation_before, unsigned generation_after, hrt_abstime publish_time);
+#endif // CONFIG_ORB_LATENCY_STATS
+
+	/**
+	 * Allocate the queue buffer on first use.
+	 * @return true if the buffer is available
+	 */
+	bool allocate_data();
+
 	const orb_metadata *_meta; /**< object metadata information */
 
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	hrt_abstime *_publish_time{nullptr}; /**< publication time of each queue slot */
+	LatencyHistogram _copy_latency;
+	LatencyHistogram _callback_latency;
+	px4::atomic<uint32_t> _lost_messages{0};
+#endif // CONFIG_ORB_LATENCY_STATS
+#if defined(CONFIG_ORB_SEQLOCK)
+	static constexpr int SEQLOCK_READ_ATTEMPTS {8};
+	px4::atomic<unsigned>  _seq{0};  /**< sequence counter, odd while a publisher is writing */
+#endif // CONFIG_ORB_SEQLOCK
+#if defined(__PX4_POSIX)
+	px4::atomic_bool _loaned {false}; /**< a loan() is waiting for commit() */
+#endif // __PX4_POSIX
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBLatency.hpp
+ *
+ * Fixed bucket latency histogram used for the optional per-topic statistics (CONFIG_ORB_LATENCY_STATS).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+
+namespace uORB
+{
+
+class LatencyHistogram
+{
+public:
+	static constexpr int NUM_BUCKETS = 10;
+
+	// upper bucket limits in microseconds, the last bucket is unbounded
+	static constexpr uint32_t BUCKET_LIMITS_US[NUM_BUCKETS - 1] {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+	LatencyHistogram() = default;
+	~LatencyHistogram() = default;
+
+	void record(hrt_abstime latency_us)
+	{
+		int bucket = 0;
+
+		while ((bucket < NUM_BUCKETS - 1) && (latency_us >= BUCKET_LIMITS_US[bucket])) {
+			bucket++;
+		}
+
+		_buckets[bucket].fetch_add(1);
+	}
+
+	uint32_t get(int bucket) const { return _buckets[bucket].load(); }
+
+	uint32_t total() const
+	{
+		uint32_t sum = 0;
+
+		for (int i = 0; i < NUM_BUCKETS; i++) {
+			sum += _buckets[i].load();
+		}
+
+		return sum;
+	}
+
+private:
+	px4::atomic<uint32_t> _buckets[NUM_BUCKETS] {};
+};
+
+} // namespace uORB
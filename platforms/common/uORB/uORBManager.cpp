@@ -375,6 +375,35 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return uORB::DeviceNode::publish(meta, handle, data);
 }
 
+#if defined(__PX4_POSIX)
+void *uORB::Manager::orb_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr; // orb_publish() pretends success
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+
+	// remote proxies need a copy of every publication
+	if (get_instance()->get_uorb_communicator() != nullptr) {
+		return nullptr;
+	}
+
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	return uORB::DeviceNode::loan(meta, handle);
+}
+
+int uORB::Manager::orb_commit(orb_advert_t handle)
+{
+	return uORB::DeviceNode::commit(handle);
+}
+#endif // __PX4_POSIX
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -458,6 +487,40 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+#if defined(CONFIG_ORB_SEQLOCK)
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &seq)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	if (!static_cast<const uORB::DeviceNode *>(node_handle)->updates_available(generation)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation, seq);
+}
+
+bool uORB::Manager::orb_data_borrow_valid(const void *node_handle, unsigned seq)
+{
+	return static_cast<const DeviceNode *>(node_handle)->borrow_valid(seq);
+}
+#endif // CONFIG_ORB_SEQLOCK
+
+#if defined(CONFIG_ORB_LATENCY_STATS)
+bool uORB::Manager::orb_get_latency_statistics(int index, orb_latency_s &stats)
+{
+	uORB::DeviceMaster *dev = uORB::Manager::get_instance()->get_device_master();
+
+	return (dev != nullptr) && dev->getLatencyStatistics(index, stats);
+}
+
+void uORB::Manager::orb_record_callback_latency(void *node_handle, hrt_abstime latency)
+{
+	static_cast<DeviceNode *>(node_handle)->record_callback_latency(latency);
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
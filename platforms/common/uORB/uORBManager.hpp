@@ -279,6 +279,29 @@ public:
 	 */
 	static int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
 
+#if defined(__PX4_POSIX)
+	/**
+	 * Loan a message buffer inside the topic queue to publish without copying.
+	 *
+	 * The topic is locked until orb_commit() is called, keep the time in between short.
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    Pointer to the buffer to fill in, nullptr if loaning is not possible
+	 *      (use orb_publish() instead).
+	 */
+	static void *orb_loan(const struct orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Publish the buffer returned by orb_loan().
+	 *
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    OK on success, PX4_ERROR otherwise.
+	 */
+	static int  orb_commit(orb_advert_t handle);
+#endif // __PX4_POSIX
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -442,12 +465,31 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+#if defined(CONFIG_ORB_SEQLOCK)
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation, unsigned &seq);
+
+	static bool orb_data_borrow_valid(const void *node_handle, unsigned seq);
+#endif // CONFIG_ORB_SEQLOCK
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static uint8_t orb_get_instance(const void *node_handle);
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/**
+	 * Get the latency statistics of the n-th topic with recorded statistics.
+	 * @return false if index is out of range
+	 */
+	static bool orb_get_latency_statistics(int index, orb_latency_s &stats);
+
+	/**
+	 * Record the time from a publication until the callback it triggered started running.
+	 */
+	static void orb_record_callback_latency(void *node_handle, hrt_abstime latency);
+#endif // CONFIG_ORB_LATENCY_STATS
+
 #if defined(CONFIG_BUILD_FLAT)
 	/* These are optimized by inlining in NuttX Flat build */
 	static unsigned updates_available(const void *node_handle, unsigned last_generation) { return is_advertised(node_handle) ? static_cast<const DeviceNode *>(node_handle)->updates_available(last_generation) : 0; }
@@ -302,6 +302,18 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return data.ret;
 }
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+bool uORB::Manager::orb_get_latency_statistics(int index, orb_latency_s &stats)
+{
+	// node statistics live in kernel memory
+	return false;
+}
+
+void uORB::Manager::orb_record_callback_latency(void *node_handle, hrt_abstime latency)
+{
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
 	orbiocdevregcallback_t data = {node_handle, callback_sub, false};
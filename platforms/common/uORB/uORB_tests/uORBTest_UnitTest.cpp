@@ -39,7 +39,9 @@
 #include <errno.h>
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
+#include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
@@ -206,6 +208,12 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
+	ret = test_loan();
+
+	if (ret != OK) {
+		return ret;
+	}
+
 	return test_queue_poll_notify();
 }
 
@@ -814,6 +822,122 @@ int uORBTest::UnitTest::test_SubscriptionMulti()
 	return test_note("PASS orb SubscriptionMulti");
 }
 
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing orb loan and borrow");
+
+	uORB::Publication<orb_test_large_s> pub{ORB_ID(orb_test_large)};
+	uORB::Subscription sub{ORB_ID(orb_test_large)};
+
+	pub.advertise();
+
+	// data left from a previous run
+	orb_test_large_s previous{};
+	sub.update(&previous);
+
+	// commit() without a loan must be rejected and publish nothing
+	if (pub.commit()) {
+		return test_fail("commit without loan succeeded");
+	}
+
+	if (sub.updated()) {
+		return test_fail("commit without loan published");
+	}
+
+	for (int i = 0; i < 3; i++) {
+		orb_test_large_s *msg = pub.loan();
+
+		if (msg == nullptr) {
+#if defined(__PX4_POSIX)
+			return test_fail("loan failed");
+#else
+			return test_note("SKIP orb loan (not supported)");
+#endif // __PX4_POSIX
+		}
+
+		msg->timestamp = hrt_absolute_time();
+		msg->val = i;
+		msg->junk[sizeof(msg->junk) - 1] = i;
+
+		if (!pub.commit()) {
+			return test_fail("commit failed");
+		}
+
+		// a duplicate commit() must not publish again (or unlock the node twice)
+		if (pub.commit()) {
+			return test_fail("duplicate commit succeeded");
+		}
+
+		if (!sub.updated()) {
+			return test_fail("update flag not set after commit %d", i);
+		}
+
+#if defined(CONFIG_ORB_SEQLOCK)
+		uORB::Subscription::Borrowed borrowed{};
+
+		if (!sub.borrow(borrowed)) {
+			return test_fail("borrow failed");
+		}
+
+		const orb_test_large_s *view = static_cast<const orb_test_large_s *>(borrowed.data);
+		const int val = view->val;
+		const int junk = view->junk[sizeof(view->junk) - 1];
+
+		if (!sub.release(borrowed)) {
+			return test_fail("borrowed data invalidated without publication");
+		}
+
+		if ((val != i) || (junk != i)) {
+			return test_fail("borrow mismatch: %d expected %d", val, i);
+		}
+
+		if (sub.updated()) {
+			return test_fail("spurious updated flag after borrow");
+		}
+
+		// nothing new to borrow
+		if (sub.borrow(borrowed)) {
+			return test_fail("borrow succeeded without update");
+		}
+
+#else
+		orb_test_large_s copy{};
+
+		if (!sub.update(&copy) || (copy.val != i) || (copy.junk[sizeof(copy.junk) - 1] != i)) {
+			return test_fail("copy mismatch: %d expected %d", copy.val, i);
+		}
+
+#endif // CONFIG_ORB_SEQLOCK
+	}
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	// a publication while borrowed must invalidate the view
+	orb_test_large_s msg{};
+	msg.val = 10;
+	pub.publish(msg);
+
+	uORB::Subscription::Borrowed borrowed{};
+
+	if (!sub.borrow(borrowed)) {
+		return test_fail("borrow failed");
+	}
+
+	msg.val = 11;
+	pub.publish(msg);
+
+	if (sub.release(borrowed)) {
+		return test_fail("borrowed data not invalidated by publication");
+	}
+
+	if (!sub.updated()) {
+		return test_fail("invalid borrow marked data as read");
+	}
+
+#endif // CONFIG_ORB_SEQLOCK
+
+	return test_note("PASS orb loan and borrow");
+}
+
 int uORBTest::UnitTest::test_queue()
 {
 	test_note("Testing orb queuing");
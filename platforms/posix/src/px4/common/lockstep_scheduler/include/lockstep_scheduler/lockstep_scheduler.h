@@ -76,28 +76,43 @@ private:
 			}
 
 			// If a thread quickly exits after a cond_timedwait(), the
-			// thread_local object can still be in the linked list. In that case
-			// we need to wait until it's removed.
-			while (!removed) {
-				system_usleep(5000);
+			// thread_local object can still be in the heap. In that case
+			// we remove it, as it might otherwise only expire much later.
+			if (!removed && scheduler) {
+				scheduler->remove_timed_wait(this);
 			}
 		}
 
 		pthread_cond_t *passed_cond{nullptr};
 		pthread_mutex_t *passed_lock{nullptr};
+		LockstepScheduler *scheduler{nullptr};
 		uint64_t time_us{0};
 		bool timeout{false};
 		std::atomic<bool> done{false};
 		std::atomic<bool> removed{true};
 
-		TimedWait *next{nullptr}; ///< linked list
+		size_t heap_index{0}; ///< position in _timed_waits
 	};
 
+	// min-heap operations on _timed_waits (ordered by time_us), _timed_waits_mutex must be held
+	void heap_push(TimedWait *timed_wait);
+	void heap_remove(size_t index);
+	void heap_update(size_t index);
+	void heap_sift_up(size_t index);
+	void heap_sift_down(size_t index);
+	void heap_set(size_t index, TimedWait *timed_wait)
+	{
+		_timed_waits[index] = timed_wait;
+		timed_wait->heap_index = index;
+	}
+
+	void remove_timed_wait(TimedWait *timed_wait);
+
 	LockstepComponents _components;
 
 	std::atomic<uint64_t> _time_us{0};
 
-	TimedWait *_timed_waits{nullptr}; ///< head of linked list
+	std::vector<TimedWait *> _timed_waits; ///< min-heap, the earliest wait is at the front
 	std::mutex _timed_waits_mutex;
 	std::atomic<bool> _setting_time{false}; ///< true if set_absolute_time() is currently being executed
 };
@@ -35,16 +35,18 @@
 
 #include <px4_platform_common/log.h>
 
+#include <cassert>
+
 LockstepScheduler::~LockstepScheduler()
 {
-	// cleanup the linked list
+	// cleanup the heap
 	std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 
-	while (_timed_waits) {
-		TimedWait *tmp = _timed_waits;
-		_timed_waits = _timed_waits->next;
-		tmp->removed = true;
+	for (TimedWait *timed_wait : _timed_waits) {
+		timed_wait->removed = true;
 	}
+
+	_timed_waits.clear();
 }
 
 void LockstepScheduler::set_absolute_time(uint64_t time_us)
@@ -59,28 +61,14 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 		std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 		_setting_time = true;
 
-		TimedWait *timed_wait = _timed_waits;
-		TimedWait *timed_wait_prev = nullptr;
-
-		while (timed_wait) {
-			// Clean up the ones that are already done from last iteration.
-			if (timed_wait->done) {
-				// Erase from the linked list
-				if (timed_wait_prev) {
-					timed_wait_prev->next = timed_wait->next;
-
-				} else {
-					_timed_waits = timed_wait->next;
-				}
+		// Only the waits that are due are touched. The ones that are already done
+		// (signaled through their condition) stay in the heap until they expire,
+		// or until the thread waits again, which re-uses the entry.
+		while (!_timed_waits.empty() && _timed_waits.front()->time_us <= time_us) {
+			TimedWait *timed_wait = _timed_waits.front();
+			heap_remove(0);
 
-				TimedWait *tmp = timed_wait;
-				timed_wait = timed_wait->next;
-				tmp->removed = true;
-				continue;
-			}
-
-			if (timed_wait->time_us <= time_us &&
-			    !timed_wait->timeout) {
+			if (!timed_wait->done) {
 				// We are abusing the condition here to signal that the time
 				// has passed.
 				pthread_mutex_lock(timed_wait->passed_lock);
@@ -89,8 +77,7 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 				pthread_mutex_unlock(timed_wait->passed_lock);
 			}
 
-			timed_wait_prev = timed_wait;
-			timed_wait = timed_wait->next;
+			timed_wait->removed = true;
 		}
 
 		_setting_time = false;
@@ -102,6 +89,13 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 	// A TimedWait object might still be in timed_waits_ after we return, so its lifetime needs to be
 	// longer. And using thread_local is more efficient than malloc.
 	static thread_local TimedWait timed_wait;
+
+	// The entry can still be in the heap of another scheduler instance that this thread waited on before.
+	// Take it out of there first, its heap index is meaningless in our heap.
+	if (!timed_wait.removed && (timed_wait.scheduler != this)) {
+		timed_wait.scheduler->remove_timed_wait(&timed_wait);
+	}
+
 	{
 		std::lock_guard<std::mutex> lock_timed_waits(_timed_waits_mutex);
 
@@ -116,11 +110,16 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 		timed_wait.timeout = false;
 		timed_wait.done = false;
 
-		// Add to linked list if not removed yet (otherwise just re-use the object)
+		// Add to the heap if removed already (otherwise re-use the entry and restore the heap order)
+		assert(timed_wait.removed || (timed_wait.scheduler == this));
+		timed_wait.scheduler = this;
+
 		if (timed_wait.removed) {
 			timed_wait.removed = false;
-			timed_wait.next = _timed_waits;
-			_timed_waits = &timed_wait;
+			heap_push(&timed_wait);
+
+		} else {
+			heap_update(timed_wait.heap_index);
 		}
 	}
 
@@ -155,8 +154,9 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 
 int LockstepScheduler::usleep_until(uint64_t time_us)
 {
-	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
-	pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+	// Nobody else ever uses these, so they can be re-used for every call from the same thread.
+	static thread_local pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	static thread_local pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
 
 	pthread_mutex_lock(&lock);
 
@@ -171,3 +171,89 @@ int LockstepScheduler::usleep_until(uint64_t time_us)
 
 	return result;
 }
+
+void LockstepScheduler::remove_timed_wait(TimedWait *timed_wait)
+{
+	std::lock_guard<std::mutex> lock_timed_waits(_timed_waits_mutex);
+
+	if (!timed_wait->removed) {
+		heap_remove(timed_wait->heap_index);
+		timed_wait->removed = true;
+	}
+}
+
+void LockstepScheduler::heap_push(TimedWait *timed_wait)
+{
+	_timed_waits.push_back(timed_wait);
+	timed_wait->heap_index = _timed_waits.size() - 1;
+	heap_sift_up(timed_wait->heap_index);
+}
+
+void LockstepScheduler::heap_remove(size_t index)
+{
+	const size_t last = _timed_waits.size() - 1;
+
+	if (index != last) {
+		heap_set(index, _timed_waits[last]);
+		_timed_waits.pop_back();
+		heap_update(index);
+
+	} else {
+		_timed_waits.pop_back();
+	}
+}
+
+void LockstepScheduler::heap_update(size_t index)
+{
+	if (index > 0 && _timed_waits[index]->time_us < _timed_waits[(index - 1) / 2]->time_us) {
+		heap_sift_up(index);
+
+	} else {
+		heap_sift_down(index);
+	}
+}
+
+void LockstepScheduler::heap_sift_up(size_t index)
+{
+	TimedWait *timed_wait = _timed_waits[index];
+
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+
+		if (_timed_waits[parent]->time_us <= timed_wait->time_us) {
+			break;
+		}
+
+		heap_set(index, _timed_waits[parent]);
+		index = parent;
+	}
+
+	heap_set(index, timed_wait);
+}
+
+void LockstepScheduler::heap_sift_down(size_t index)
+{
+	TimedWait *timed_wait = _timed_waits[index];
+	const size_t size = _timed_waits.size();
+
+	while (true) {
+		size_t child = 2 * index + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && _timed_waits[child + 1]->time_us < _timed_waits[child]->time_us) {
+			++child;
+		}
+
+		if (timed_wait->time_us <= _timed_waits[child]->time_us) {
+			break;
+		}
+
+		heap_set(index, _timed_waits[child]);
+		index = child;
+	}
+
+	heap_set(index, timed_wait);
+}
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file lockstep_scheduler_benchmark.cpp
+ *
+ * Measures the maximum simulation speed factor (PX4_SIM_SPEED_FACTOR) the
+ * LockstepScheduler can sustain. A number of threads emulate SITL modules
+ * running at typical rates via usleep_until(), while the main thread acts as
+ * the simulator: it advances the time in fixed steps and, as in lockstep,
+ * only continues once every thread that was due has run and re-armed its wait.
+ * Optionally, idle threads can be added that wait with a long timeout (like
+ * a driver or work queue waiting for data that does not arrive in SITL).
+ *
+ * Usage: lockstep_scheduler_benchmark [num_threads] [simulated_seconds] [num_idle_threads]
+ */
+
+#include <lockstep_scheduler/lockstep_scheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static constexpr uint64_t start_time_us = 1000000;
+static constexpr uint64_t sim_step_us = 4000; // 250 Hz, the usual lockstep IMU rate
+
+// Typical module intervals in SITL (1 kHz down to 1 Hz)
+static constexpr uint64_t module_intervals_us[] = {
+	1000, 2500, 4000, 5000, 10000, 20000, 50000, 100000, 200000, 1000000
+};
+static constexpr int num_module_intervals = sizeof(module_intervals_us) / sizeof(module_intervals_us[0]);
+
+struct Module {
+	uint64_t interval_us{0};
+	std::atomic<uint64_t> next_wakeup_us{0};
+	std::atomic<uint64_t> runs{0};
+	std::atomic<bool> exited{false};
+	std::thread thread;
+};
+
+int main(int argc, char *argv[])
+{
+	const int num_threads = argc > 1 ? atoi(argv[1]) : 32;
+	const double sim_seconds = argc > 2 ? atof(argv[2]) : 20.;
+	const int num_idle_threads = argc > 3 ? atoi(argv[3]) : 0;
+
+	if (num_threads <= 0 || sim_seconds <= 0. || num_idle_threads < 0) {
+		printf("usage: %s [num_threads] [simulated_seconds] [num_idle_threads]\n", argv[0]);
+		return 1;
+	}
+
+	LockstepScheduler ls;
+	ls.set_absolute_time(start_time_us);
+
+	std::atomic<bool> should_exit{false};
+	std::vector<std::unique_ptr<Module>> modules;
+
+	for (int i = 0; i < num_threads; ++i) {
+		modules.emplace_back(new Module());
+		Module &module = *modules.back();
+		module.interval_us = module_intervals_us[i % num_module_intervals];
+		module.next_wakeup_us = start_time_us + module.interval_us;
+
+		module.thread = std::thread([&ls, &module, &should_exit]() {
+			while (!should_exit) {
+				ls.usleep_until(module.next_wakeup_us);
+				module.runs++;
+				module.next_wakeup_us += module.interval_us;
+			}
+
+			module.exited = true;
+		});
+	}
+
+	const uint64_t end_time_us = start_time_us + (uint64_t)(sim_seconds * 1e6);
+
+	for (int i = 0; i < num_idle_threads; ++i) {
+		modules.emplace_back(new Module());
+		Module &module = *modules.back();
+		module.next_wakeup_us = end_time_us + 1;
+
+		module.thread = std::thread([&ls, &module, &should_exit]() {
+			pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+			pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+			pthread_mutex_lock(&lock);
+
+			while (!should_exit) {
+				ls.cond_timedwait(&cond, &lock, module.next_wakeup_us);
+			}
+
+			pthread_mutex_unlock(&lock);
+			module.exited = true;
+		});
+	}
+
+	uint64_t set_time_ns = 0;
+	uint64_t ticks = 0;
+
+	const auto wall_start = std::chrono::steady_clock::now();
+
+	for (uint64_t time_us = start_time_us + sim_step_us; time_us <= end_time_us; time_us += sim_step_us) {
+		const auto set_time_start = std::chrono::steady_clock::now();
+		ls.set_absolute_time(time_us);
+		set_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+				set_time_start).count();
+		++ticks;
+
+		// lockstep: wait until every module that was due has run
+		for (auto &module : modules) {
+			while (module->next_wakeup_us <= time_us) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+	should_exit = true;
+
+	// wake up all threads, whatever they are waiting for
+	ls.set_absolute_time(UINT64_MAX);
+
+	uint64_t runs = 0;
+
+	for (auto &module : modules) {
+		while (!module->exited) {
+			std::this_thread::yield();
+		}
+
+		// the thread's wait entry needs to be released before it can exit
+		ls.set_absolute_time(ls.get_absolute_time());
+		module->thread.join();
+
+		runs += module->runs;
+	}
+
+	const double sim_s = (double)(ticks * sim_step_us) * 1e-6;
+
+	printf("threads: %i (+%i idle), simulated: %.1f s, wall: %.3f s, module runs: %" PRIu64 "\n",
+	       num_threads, num_idle_threads, sim_s, wall_s, runs);
+	printf("set_absolute_time: %.2f us avg over %" PRIu64 " ticks\n", (double)set_time_ns / ticks * 1e-3, ticks);
+	printf("max speed factor: %.1f\n", sim_s / wall_s);
+
+	return 0;
+}
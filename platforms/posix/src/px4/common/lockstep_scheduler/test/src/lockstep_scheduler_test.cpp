@@ -307,6 +307,62 @@ void test_usleep()
 	thread.join(ls);
 }
 
+void test_waiting_on_different_schedulers()
+{
+	pthread_cond_t cond;
+	pthread_cond_init(&cond, NULL);
+
+	pthread_mutex_t lock;
+	pthread_mutex_init(&lock, NULL);
+
+	LockstepScheduler ls1;
+	ls1.set_absolute_time(some_time_us);
+
+	LockstepScheduler ls2;
+	ls2.set_absolute_time(some_time_us);
+
+	enum class Step {
+		Init,
+		WaitingOnFirst,
+		SignaledOnFirst,
+		WaitingOnSecond,
+	};
+
+	std::atomic<Step> step{Step::Init};
+
+	TestThread thread([&]() {
+		pthread_mutex_lock(&lock);
+		step = Step::WaitingOnFirst;
+
+		// signaled through the condition, the thread's entry stays in the heap of ls1 until it expires
+		EXPECT_EQ(ls1.cond_timedwait(&cond, &lock, some_time_us + 1000), 0);
+		EXPECT_EQ(pthread_mutex_unlock(&lock), 0);
+		step = Step::SignaledOnFirst;
+
+		// the same entry is now used for ls2
+		step = Step::WaitingOnSecond;
+		EXPECT_EQ(ls2.usleep_until(some_time_us + 500), 0);
+	});
+
+	// the lock is released once the thread waits
+	WAIT_FOR(step == Step::WaitingOnFirst);
+	pthread_mutex_lock(&lock);
+	pthread_cond_broadcast(&cond);
+	pthread_mutex_unlock(&lock);
+
+	WAIT_FOR(step == Step::WaitingOnSecond);
+	std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+	// expiring the old wait on ls1 must not touch the entry anymore
+	ls1.set_absolute_time(some_time_us + 1500);
+
+	ls2.set_absolute_time(some_time_us + 500);
+	thread.join(ls2);
+
+	pthread_mutex_destroy(&lock);
+	pthread_cond_destroy(&cond);
+}
+
 TEST(LockstepScheduler, All)
 {
 	for (unsigned iteration = 1; iteration <= 100; ++iteration) {
@@ -316,5 +372,6 @@ TEST(LockstepScheduler, All)
 		test_locked_semaphore_getting_unlocked();
 		test_usleep();
 		test_multiple_semaphores_waiting();
+		test_waiting_on_different_schedulers();
 	}
 }
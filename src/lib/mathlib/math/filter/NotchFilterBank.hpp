@@ -0,0 +1,366 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file NotchFilterBank.hpp
+ *
+ * @brief Cascade of notch filters applied to the three axes of a sensor at once.
+ *
+ * Coefficients and filter states are kept as a structure of arrays with the
+ * axes padded to four lanes, so every filter stage is evaluated for all axes
+ * with a single SSE/NEON operation per sample. Each stage and axis behaves
+ * exactly like a math::NotchFilter<float> (same parameter handling, same
+ * Direct Form I evaluation order and the same lazy reset on the first sample).
+ */
+
+#pragma once
+
+#include "NotchFilter.hpp"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace math
+{
+
+// samples are filtered interleaved as [sample][axis], axes padded to four lanes
+static constexpr int NOTCH_FILTER_BANK_AXES = 3;
+static constexpr int NOTCH_FILTER_BANK_LANES = 4;
+
+template<int STAGES>
+class NotchFilterBank
+{
+	struct Parameters;
+	class Section;
+
+public:
+	static constexpr int AXES = NOTCH_FILTER_BANK_AXES;
+	static constexpr int LANES = NOTCH_FILTER_BANK_LANES;
+
+	/**
+	 * Handle to a single stage/axis of the bank, providing the math::NotchFilter parameter interface.
+	 */
+	class Filter
+	{
+	public:
+		Filter(NotchFilterBank &bank, int stage, int axis) : _bank(bank), _stage(stage), _axis(axis) {}
+
+		bool setParameters(float sample_freq, float notch_freq, float bandwidth)
+		{
+			Section section{_bank, _stage, _axis};
+			const bool ret = section.setParameters(sample_freq, notch_freq, bandwidth);
+			section.store(_bank, _stage, _axis);
+			return ret;
+		}
+
+		void disable()
+		{
+			Section section{_bank, _stage, _axis};
+			section.disable();
+			section.store(_bank, _stage, _axis);
+		}
+
+		// reinitialize the filter state with the next sample
+		void reset() { parameters().initialized = false; }
+
+		float getNotchFreq() const { return parameters().notch_freq; }
+		float getBandwidth() const { return parameters().bandwidth; }
+		bool initialized() const { return parameters().initialized; }
+
+	private:
+		Parameters &parameters() { return _bank._parameters[_stage][_axis]; }
+		const Parameters &parameters() const { return _bank._parameters[_stage][_axis]; }
+
+		NotchFilterBank &_bank;
+		const int _stage;
+		const int _axis;
+	};
+
+	NotchFilterBank()
+	{
+		for (int stage = 0; stage < STAGES; stage++) {
+			for (int lane = 0; lane < LANES; lane++) {
+				// passthrough, padding lane included
+				State &state = _states[stage];
+				state.b0[lane] = 1.f;
+				state.b1[lane] = state.b2[lane] = state.a1[lane] = state.a2[lane] = 0.f;
+				state.x1[lane] = state.x2[lane] = state.y1[lane] = state.y2[lane] = 0.f;
+			}
+
+			_enabled[stage] = false;
+		}
+	}
+
+	~NotchFilterBank() = default;
+
+	Filter filter(int stage, int axis) { return Filter{*this, stage, axis}; }
+
+	bool enabled() const
+	{
+		for (int stage = 0; stage < STAGES; stage++) {
+			if (_enabled[stage]) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Filter interleaved samples in place, all enabled stages in order.
+	 *
+	 * @param samples samples[n][axis], the padding lane is filtered as passthrough
+	 */
+	void applyArray(float samples[][LANES], int num_samples)
+	{
+		if (num_samples <= 0) {
+			return;
+		}
+
+		for (int stage = 0; stage < STAGES; stage++) {
+			if (!_enabled[stage]) {
+				continue;
+			}
+
+			State &state = _states[stage];
+
+			for (int axis = 0; axis < AXES; axis++) {
+				Parameters &parameters = _parameters[stage][axis];
+
+				// same as NotchFilter::applyArray(), disabled axes are passed through untouched
+				if ((parameters.notch_freq > 0.f) && !parameters.initialized) {
+					Section section{*this, stage, axis};
+					section.resetState(samples[0][axis], state, axis);
+					parameters.initialized = true;
+				}
+			}
+
+			applyStage(state, samples, num_samples);
+		}
+	}
+
+private:
+	struct State {
+		float b0[LANES];
+		float b1[LANES];
+		float b2[LANES];
+		float a1[LANES];
+		float a2[LANES];
+
+		float x1[LANES];
+		float x2[LANES];
+		float y1[LANES];
+		float y2[LANES];
+	};
+
+	// parameters of a single stage/axis, its coefficients and filter state are kept in State
+	struct Parameters {
+		float notch_freq{0.f};
+		float bandwidth{0.f};
+		float sample_freq{0.f};
+		bool initialized{false};
+	};
+
+	// temporary NotchFilter for the parameter handling and reset of a single stage/axis
+	class Section final : public NotchFilter<float>
+	{
+	public:
+		Section(const NotchFilterBank &bank, int stage, int axis)
+		{
+			const Parameters &parameters = bank._parameters[stage][axis];
+			_notch_freq = parameters.notch_freq;
+			_bandwidth = parameters.bandwidth;
+			_sample_freq = parameters.sample_freq;
+			_initialized = parameters.initialized;
+
+			const State &state = bank._states[stage];
+			_b0 = state.b0[axis];
+			_b1 = state.b1[axis];
+			_b2 = state.b2[axis];
+			_a1 = state.a1[axis];
+			_a2 = state.a2[axis];
+		}
+
+		void store(NotchFilterBank &bank, int stage, int axis) const
+		{
+			Parameters &parameters = bank._parameters[stage][axis];
+			parameters.notch_freq = _notch_freq;
+			parameters.bandwidth = _bandwidth;
+			parameters.sample_freq = _sample_freq;
+			parameters.initialized = _initialized;
+
+			State &state = bank._states[stage];
+			state.b0[axis] = _b0;
+			state.b1[axis] = _b1;
+			state.b2[axis] = _b2;
+			state.a1[axis] = _a1;
+			state.a2[axis] = _a2;
+
+			bank.updateEnabled(stage);
+		}
+
+		void resetState(float sample, State &state, int axis)
+		{
+			reset(sample);
+			state.x1[axis] = _delay_element_1;
+			state.x2[axis] = _delay_element_2;
+			state.y1[axis] = _delay_element_output_1;
+			state.y2[axis] = _delay_element_output_2;
+		}
+	};
+
+	void updateEnabled(int stage)
+	{
+		_enabled[stage] = false;
+
+		for (int axis = 0; axis < AXES; axis++) {
+			if (_parameters[stage][axis].notch_freq > 0.f) {
+				_enabled[stage] = true;
+			}
+		}
+	}
+
+	static void applyStage(State &state, float samples[][LANES], int num_samples)
+	{
+		// Direct Form I, same evaluation order as NotchFilter::applyInternal()
+#if defined(__SSE__)
+		const __m128 b0 = _mm_loadu_ps(state.b0);
+		const __m128 b1 = _mm_loadu_ps(state.b1);
+		const __m128 b2 = _mm_loadu_ps(state.b2);
+		const __m128 a1 = _mm_loadu_ps(state.a1);
+		const __m128 a2 = _mm_loadu_ps(state.a2);
+
+		__m128 x1 = _mm_loadu_ps(state.x1);
+		__m128 x2 = _mm_loadu_ps(state.x2);
+		__m128 y1 = _mm_loadu_ps(state.y1);
+		__m128 y2 = _mm_loadu_ps(state.y2);
+
+		for (int n = 0; n < num_samples; n++) {
+			const __m128 x = _mm_loadu_ps(samples[n]);
+
+			__m128 y = _mm_add_ps(_mm_mul_ps(b0, x), _mm_mul_ps(b1, x1));
+			y = _mm_add_ps(y, _mm_mul_ps(b2, x2));
+			y = _mm_sub_ps(y, _mm_mul_ps(a1, y1));
+			y = _mm_sub_ps(y, _mm_mul_ps(a2, y2));
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+
+			_mm_storeu_ps(samples[n], y);
+		}
+
+		_mm_storeu_ps(state.x1, x1);
+		_mm_storeu_ps(state.x2, x2);
+		_mm_storeu_ps(state.y1, y1);
+		_mm_storeu_ps(state.y2, y2);
+
+#elif defined(__ARM_NEON)
+		const float32x4_t b0 = vld1q_f32(state.b0);
+		const float32x4_t b1 = vld1q_f32(state.b1);
+		const float32x4_t b2 = vld1q_f32(state.b2);
+		const float32x4_t a1 = vld1q_f32(state.a1);
+		const float32x4_t a2 = vld1q_f32(state.a2);
+
+		float32x4_t x1 = vld1q_f32(state.x1);
+		float32x4_t x2 = vld1q_f32(state.x2);
+		float32x4_t y1 = vld1q_f32(state.y1);
+		float32x4_t y2 = vld1q_f32(state.y2);
+
+		for (int n = 0; n < num_samples; n++) {
+			const float32x4_t x = vld1q_f32(samples[n]);
+
+			// separate multiply and add (no fused multiply-accumulate) to match the scalar filter
+			float32x4_t y = vaddq_f32(vmulq_f32(b0, x), vmulq_f32(b1, x1));
+			y = vaddq_f32(y, vmulq_f32(b2, x2));
+			y = vsubq_f32(y, vmulq_f32(a1, y1));
+			y = vsubq_f32(y, vmulq_f32(a2, y2));
+
+			x2 = x1;
+			x1 = x;
+			y2 = y1;
+			y1 = y;
+
+			vst1q_f32(samples[n], y);
+		}
+
+		vst1q_f32(state.x1, x1);
+		vst1q_f32(state.x2, x2);
+		vst1q_f32(state.y1, y1);
+		vst1q_f32(state.y2, y2);
+
+#else
+		// scalar fallback, the padding lane is skipped
+		for (int axis = 0; axis < AXES; axis++) {
+			const float b0 = state.b0[axis];
+			const float b1 = state.b1[axis];
+			const float b2 = state.b2[axis];
+			const float a1 = state.a1[axis];
+			const float a2 = state.a2[axis];
+
+			float x1 = state.x1[axis];
+			float x2 = state.x2[axis];
+			float y1 = state.y1[axis];
+			float y2 = state.y2[axis];
+
+			for (int n = 0; n < num_samples; n++) {
+				const float x = samples[n][axis];
+				const float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
+
+				samples[n][axis] = y;
+			}
+
+			state.x1[axis] = x1;
+			state.x2[axis] = x2;
+			state.y1[axis] = y1;
+			state.y2[axis] = y2;
+		}
+
+#endif
+	}
+
+	State _states[STAGES];
+	Parameters _parameters[STAGES][AXES] {};
+	bool _enabled[STAGES];
+};
+
+} // namespace math
@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the Notch filter bank
+ * Run this test only using make tests TESTFILTER=NotchFilterBank
+ */
+
+#include <gtest/gtest.h>
+
+#include <lib/mathlib/math/filter/NotchFilter.hpp>
+#include <lib/mathlib/math/filter/NotchFilterBank.hpp>
+
+#include <cstdlib>
+
+using namespace math;
+
+static constexpr int STAGES = 8;
+static constexpr int AXES = NOTCH_FILTER_BANK_AXES;
+static constexpr int LANES = NOTCH_FILTER_BANK_LANES;
+
+class NotchFilterBankTest : public ::testing::Test
+{
+public:
+	void setParameters(int stage, int axis, float notch_freq, float bandwidth)
+	{
+		const bool ret_bank = _bank.filter(stage, axis).setParameters(_sample_freq, notch_freq, bandwidth);
+		const bool ret_reference = _reference[stage][axis].setParameters(_sample_freq, notch_freq, bandwidth);
+		EXPECT_EQ(ret_bank, ret_reference);
+	}
+
+	void disable(int stage, int axis)
+	{
+		_bank.filter(stage, axis).disable();
+		_reference[stage][axis].disable();
+	}
+
+	// filter a batch of samples through both the bank and the scalar reference filters and compare
+	void applyAndCompare(int num_samples)
+	{
+		float samples[32][LANES] {};
+		float reference[AXES][32] {};
+
+		for (int n = 0; n < num_samples; n++) {
+			_time += 1.f / _sample_freq;
+
+			for (int axis = 0; axis < AXES; axis++) {
+				const float sample = sinf(2.f * M_PI_F * 40.f * _time + axis) + 0.5f * sinf(2.f * M_PI_F * 125.f * _time)
+						     + 0.2f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+				samples[n][axis] = sample;
+				reference[axis][n] = sample;
+			}
+		}
+
+		_bank.applyArray(samples, num_samples);
+
+		for (int axis = 0; axis < AXES; axis++) {
+			for (int stage = 0; stage < STAGES; stage++) {
+				if (_reference[stage][axis].getNotchFreq() > 0.f) {
+					_reference[stage][axis].applyArray(reference[axis], num_samples);
+				}
+			}
+
+			for (int n = 0; n < num_samples; n++) {
+				EXPECT_NEAR(samples[n][axis], reference[axis][n], 1e-5f);
+			}
+
+			for (int stage = 0; stage < STAGES; stage++) {
+				EXPECT_EQ(_bank.filter(stage, axis).initialized(), _reference[stage][axis].initialized());
+				EXPECT_EQ(_bank.filter(stage, axis).getNotchFreq(), _reference[stage][axis].getNotchFreq());
+			}
+		}
+	}
+
+	NotchFilterBank<STAGES> _bank;
+	NotchFilter<float> _reference[STAGES][AXES] {};
+
+	const float _sample_freq = 1000.f;
+	float _time{0.f};
+};
+
+TEST_F(NotchFilterBankTest, disabledPassthrough)
+{
+	EXPECT_FALSE(_bank.enabled());
+
+	float samples[4][LANES] {};
+
+	for (int n = 0; n < 4; n++) {
+		for (int axis = 0; axis < AXES; axis++) {
+			samples[n][axis] = n + 0.1f * axis;
+		}
+	}
+
+	_bank.applyArray(samples, 4);
+
+	for (int n = 0; n < 4; n++) {
+		for (int axis = 0; axis < AXES; axis++) {
+			EXPECT_EQ(samples[n][axis], n + 0.1f * axis);
+		}
+	}
+}
+
+TEST_F(NotchFilterBankTest, singleStage)
+{
+	setParameters(0, 0, 50.f, 15.f);
+	setParameters(0, 1, 80.f, 20.f);
+	setParameters(0, 2, 120.f, 10.f);
+	EXPECT_TRUE(_bank.enabled());
+
+	for (int i = 0; i < 100; i++) {
+		applyAndCompare(8);
+	}
+}
+
+TEST_F(NotchFilterBankTest, cascadeMatchesNotchFilter)
+{
+	srand(1);
+
+	// ESC RPM style harmonics, stage 3 left disabled on all axes and stage 5 only on the z axis
+	for (int stage = 0; stage < STAGES; stage++) {
+		for (int axis = 0; axis < AXES; axis++) {
+			if ((stage != 3) && !((stage == 5) && (axis != 2))) {
+				setParameters(stage, axis, 40.f + 30.f * stage, 10.f + axis);
+			}
+		}
+	}
+
+	for (int i = 0; i < 200; i++) {
+		applyAndCompare(1 + (i % 32));
+
+		if (i == 50) {
+			// small frequency change keeping the filter history
+			setParameters(1, 0, 72.f, 10.f);
+
+			// large frequency change forcing a reset
+			setParameters(2, 1, 300.f, 11.f);
+
+		} else if (i == 100) {
+			disable(4, 2);
+			_bank.filter(6, 0).reset();
+			_reference[6][0].reset();
+
+		} else if (i == 150) {
+			setParameters(3, 1, 250.f, 12.f);
+			setParameters(4, 2, 200.f, 12.f);
+
+			// invalid parameters disable the filter
+			setParameters(7, 0, 600.f, 12.f);
+		}
+	}
+}
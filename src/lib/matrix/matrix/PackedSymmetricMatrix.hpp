@@ -0,0 +1,355 @@
+/**
+ * @file PackedSymmetricMatrix.hpp
+ *
+ * Symmetric square matrix storing only its upper triangle
+ *
+ * Holds M * (M + 1) / 2 instead of M * M elements, e.g. 300 instead of 576 for a 24 states
+ * covariance matrix. Element (i, j) and (j, i) refer to the same storage, so writing one
+ * of them keeps the matrix symmetric by construction.
+ */
+
+#pragma once
+
+#include "SparseVector.hpp"
+#include "SquareMatrix.hpp"
+
+namespace matrix
+{
+
+template <typename Type, size_t M, size_t Width>
+class PackedSymmetricBlock;
+
+template <typename Type, size_t M>
+class PackedSymmetricMatrix
+{
+public:
+	static constexpr size_t N = M * (M + 1) / 2;
+
+	PackedSymmetricMatrix() = default;
+
+	// other is assumed to be symmetric, only its upper triangle is used
+	explicit PackedSymmetricMatrix(const Matrix<Type, M, M> &other)
+	{
+		*this = other;
+	}
+
+	// other is assumed to be symmetric, only its upper triangle is used
+	PackedSymmetricMatrix<Type, M> &operator=(const Matrix<Type, M, M> &other)
+	{
+		size_t idx = 0;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = i; j < M; j++) {
+				_data[idx++] = other(i, j);
+			}
+		}
+
+		return *this;
+	}
+
+	// row-major index of the upper triangle
+	static constexpr size_t index(size_t i, size_t j)
+	{
+		return (i <= j) ? i * (2 * M - i - 1) / 2 + j : j * (2 * M - j - 1) / 2 + i;
+	}
+
+	inline Type operator()(size_t i, size_t j) const
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return _data[index(i, j)];
+	}
+
+	inline Type &operator()(size_t i, size_t j)
+	{
+		assert(i < M);
+		assert(j < M);
+
+		return _data[index(i, j)];
+	}
+
+	void setZero()
+	{
+		memset(_data, 0, sizeof(_data));
+	}
+
+	inline void zero()
+	{
+		setZero();
+	}
+
+	SquareMatrix<Type, M> dense() const
+	{
+		SquareMatrix<Type, M> res;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t j = 0; j < M; j++) {
+				res(i, j) = self(i, j);
+			}
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> diag() const
+	{
+		Vector<Type, M> res;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			res(i) = self(i, i);
+		}
+
+		return res;
+	}
+
+	Vector<Type, M> col(size_t j) const
+	{
+		Vector<Type, M> res;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			res(i) = self(i, j);
+		}
+
+		return res;
+	}
+
+	template <size_t Width>
+	Type trace(size_t first) const
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		Type res = 0;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = first; i < (first + Width); i++) {
+			res += self(i, i);
+		}
+
+		return res;
+	}
+
+	// square blocks only, as an off-diagonal block of a symmetric matrix is not symmetric itself
+	template <size_t P, size_t Q>
+	SquareMatrix<Type, P> slice(size_t x0, size_t y0) const
+	{
+		static_assert(P == Q, "only square blocks are supported");
+		assert(x0 + P <= M);
+		assert(y0 + P <= M);
+
+		SquareMatrix<Type, P> res;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < P; i++) {
+			for (size_t j = 0; j < P; j++) {
+				res(i, j) = self(x0 + i, y0 + j);
+			}
+		}
+
+		return res;
+	}
+
+	template <size_t P, size_t Q>
+	PackedSymmetricBlock<Type, M, P> slice(size_t x0, size_t y0)
+	{
+		static_assert(P == Q, "only square blocks are supported");
+		assert(x0 + P <= M);
+		assert(y0 + P <= M);
+
+		return {x0, y0, this};
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, const Vector<Type, Width> &vec)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		PackedSymmetricMatrix<Type, M> &self = *this;
+
+		// zero rows and columns, the columns share the storage of the rows
+		for (size_t i = first; i < first + Width; i++) {
+			for (size_t j = 0; j < M; j++) {
+				self(i, j) = Type(0);
+			}
+		}
+
+		// set diagonals
+		unsigned vec_idx = 0;
+
+		for (size_t idx = first; idx < first + Width; idx++) {
+			self(idx, idx) = vec(vec_idx);
+			vec_idx ++;
+		}
+	}
+
+	template <size_t Width>
+	void uncorrelateCovarianceSetVariance(size_t first, Type val)
+	{
+		static_assert(Width <= M, "Width bigger than matrix");
+		assert(first + Width <= M);
+
+		PackedSymmetricMatrix<Type, M> &self = *this;
+
+		// zero rows and columns, the columns share the storage of the rows
+		for (size_t i = first; i < first + Width; i++) {
+			for (size_t j = 0; j < M; j++) {
+				self(i, j) = Type(0);
+			}
+		}
+
+		// set diagonals
+		for (size_t idx = first; idx < first + Width; idx++) {
+			self(idx, idx) = val;
+		}
+	}
+
+	Vector<Type, M> operator*(const Vector<Type, M> &vec) const
+	{
+		Vector<Type, M> res;
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (size_t i = 0; i < M; i++) {
+			Type accum(0);
+
+			for (size_t j = 0; j < M; j++) {
+				accum += self(i, j) * vec(j);
+			}
+
+			res(i) = accum;
+		}
+
+		return res;
+	}
+
+	// same layout as Matrix::print(), the upper triangle being redundant it is left empty
+	void print() const
+	{
+		printf("  ");
+
+		for (unsigned i = 0; i < M; i++) {
+			printf("|%2u      ", i);
+		}
+
+		printf("\n");
+
+		const PackedSymmetricMatrix<Type, M> &self = *this;
+
+		for (unsigned i = 0; i < M; i++) {
+			printf("%2u|", i); // print row numbering
+
+			for (unsigned j = 0; j <= i; j++) {
+				double d = static_cast<double>(self(i, j));
+
+				// avoid -0.0 for display
+				if (fabs(d - 0.0) < 1e-9) {
+					// print fixed width zero
+					printf(" 0       ");
+
+				} else if ((fabs(d) < 1e-4) || (fabs(d) >= 10.0)) {
+					printf("% .1e ", d);
+
+				} else {
+					printf("% 6.5f ", d);
+				}
+			}
+
+			printf("\n");
+		}
+	}
+
+private:
+	Type _data[N] {};
+};
+
+// writable view on a diagonal block of a PackedSymmetricMatrix
+template <typename Type, size_t M, size_t Width>
+class PackedSymmetricBlock
+{
+public:
+	PackedSymmetricBlock(size_t x0, size_t y0, PackedSymmetricMatrix<Type, M> *data) :
+		_x0(x0),
+		_y0(y0),
+		_data(data)
+	{}
+
+	// other is assumed to be symmetric if the block lies on the diagonal
+	PackedSymmetricBlock &operator=(const Matrix<Type, Width, Width> &other)
+	{
+		for (size_t i = 0; i < Width; i++) {
+			for (size_t j = 0; j < Width; j++) {
+				(*_data)(_x0 + i, _y0 + j) = other(i, j);
+			}
+		}
+
+		return *this;
+	}
+
+	operator SquareMatrix<Type, Width>() const
+	{
+		const PackedSymmetricMatrix<Type, M> &data = *_data;
+		return data.template slice<Width, Width>(_x0, _y0);
+	}
+
+	Vector<Type, Width> diag() const
+	{
+		Vector<Type, Width> res;
+
+		for (size_t i = 0; i < Width; i++) {
+			res(i) = (*_data)(_x0 + i, _y0 + i);
+		}
+
+		return res;
+	}
+
+private:
+	size_t _x0, _y0;
+	PackedSymmetricMatrix<Type, M> *_data;
+};
+
+template<typename Type, size_t M, size_t ... Idxs>
+matrix::Vector<Type, M> operator*(const matrix::PackedSymmetricMatrix<Type, M> &mat,
+				  const matrix::SparseVector<Type, M, Idxs...> &vec)
+{
+	matrix::Vector<Type, M> res;
+
+	for (size_t i = 0; i < M; i++) {
+		Type accum(0);
+
+		for (size_t j = 0; j < vec.non_zeros(); j++) {
+			accum += mat(i, vec.index(j)) * vec.atCompressedIndex(j);
+		}
+
+		res(i) = accum;
+	}
+
+	return res;
+}
+
+// returns x.T * A * x
+template<typename Type, size_t M, size_t ... Idxs>
+Type quadraticForm(const matrix::PackedSymmetricMatrix<Type, M> &A, const matrix::SparseVector<Type, M, Idxs...> &x)
+{
+	Type res = Type(0);
+
+	for (size_t i = 0; i < x.non_zeros(); i++) {
+		Type tmp = Type(0);
+
+		for (size_t j = 0; j < x.non_zeros(); j++) {
+			tmp += A(x.index(i), x.index(j)) * x.atCompressedIndex(j);
+		}
+
+		res += x.atCompressedIndex(i) * tmp;
+	}
+
+	return res;
+}
+
+template<size_t M>
+using PackedSymmetricMatrixf = PackedSymmetricMatrix<float, M>;
+
+} // namespace matrix
@@ -8,6 +8,7 @@
 #include "helper_functions.hpp"
 #include "LeastSquaresSolver.hpp"
 #include "Matrix.hpp"
+#include "PackedSymmetricMatrix.hpp"
 #include "PseudoInverse.hpp"
 #include "Quaternion.hpp"
 #include "Scalar.hpp"
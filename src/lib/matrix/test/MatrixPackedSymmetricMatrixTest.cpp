@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <matrix/math.hpp>
+
+using namespace matrix;
+
+static SquareMatrix<float, 5> createSymmetricMatrix()
+{
+	SquareMatrix<float, 5> A;
+
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = i; j < 5; j++) {
+			A(i, j) = A(j, i) = static_cast<float>(10 * i + j) * 0.1f;
+		}
+	}
+
+	return A;
+}
+
+TEST(MatrixPackedSymmetricMatrixTest, storageSize)
+{
+	EXPECT_EQ(sizeof(PackedSymmetricMatrixf<24>), 300 * sizeof(float));
+	EXPECT_EQ((PackedSymmetricMatrixf<24>::index(0, 0)), 0);
+	EXPECT_EQ((PackedSymmetricMatrixf<24>::index(0, 23)), 23);
+	EXPECT_EQ((PackedSymmetricMatrixf<24>::index(1, 1)), 24);
+	EXPECT_EQ((PackedSymmetricMatrixf<24>::index(23, 23)), 299);
+}
+
+TEST(MatrixPackedSymmetricMatrixTest, elementAccessIsSymmetric)
+{
+	const SquareMatrix<float, 5> A = createSymmetricMatrix();
+	PackedSymmetricMatrixf<5> P(A);
+
+	EXPECT_TRUE(isEqual(P.dense(), A, 0.f));
+
+	// writing the lower triangle writes the upper one
+	P(4, 1) = -1.f;
+	EXPECT_FLOAT_EQ(P(1, 4), -1.f);
+
+	P.zero();
+	EXPECT_TRUE(isEqual(P.dense(), SquareMatrix<float, 5>(), 0.f));
+}
+
+TEST(MatrixPackedSymmetricMatrixTest, sameResultsAsSquareMatrix)
+{
+	const SquareMatrix<float, 5> A = createSymmetricMatrix();
+	const PackedSymmetricMatrixf<5> P(A);
+
+	EXPECT_TRUE(isEqual(P.diag(), A.diag(), 0.f));
+	EXPECT_TRUE(isEqual(P.col(3), Vector<float, 5>(A.col(3)), 0.f));
+	EXPECT_FLOAT_EQ(P.trace<3>(1), A.trace<3>(1));
+	EXPECT_TRUE(isEqual(P.slice<2, 2>(1, 1), SquareMatrix<float, 2>(A.slice<2, 2>(1, 1)), 0.f));
+
+	const float x_data[5] = {1.f, -2.f, 3.f, 0.5f, 2.f};
+	const Vector<float, 5> x(x_data);
+	EXPECT_TRUE(isEqual(P * x, Vector<float, 5>(A * x), 1e-5f));
+
+	const float data[2] = {2.f, -3.f};
+	const SparseVectorf<5, 1, 3> x_sparse(data);
+	EXPECT_TRUE(isEqual(P * x_sparse, A * x_sparse, 0.f));
+	EXPECT_FLOAT_EQ(quadraticForm(P, x_sparse), quadraticForm(A, x_sparse));
+}
+
+TEST(MatrixPackedSymmetricMatrixTest, uncorrelateCovarianceSetVariance)
+{
+	SquareMatrix<float, 5> A = createSymmetricMatrix();
+	PackedSymmetricMatrixf<5> P(A);
+
+	A.uncorrelateCovarianceSetVariance<2>(1, Vector2f(7.f, 8.f));
+	P.uncorrelateCovarianceSetVariance<2>(1, Vector2f(7.f, 8.f));
+	EXPECT_TRUE(isEqual(P.dense(), A, 0.f));
+
+	A.uncorrelateCovarianceSetVariance<1>(4, 9.f);
+	P.uncorrelateCovarianceSetVariance<1>(4, 9.f);
+	EXPECT_TRUE(isEqual(P.dense(), A, 0.f));
+}
+
+TEST(MatrixPackedSymmetricMatrixTest, diagonalBlockAssignment)
+{
+	SquareMatrix<float, 5> A = createSymmetricMatrix();
+	PackedSymmetricMatrixf<5> P(A);
+
+	SquareMatrix<float, 3> cov;
+	cov.setIdentity();
+	cov(0, 2) = cov(2, 0) = 0.5f;
+
+	A.slice<3, 3>(2, 2) = cov;
+	P.slice<3, 3>(2, 2) = cov;
+	EXPECT_TRUE(isEqual(P.dense(), A, 0.f));
+	EXPECT_TRUE(isEqual(P.slice<3, 3>(2, 2).diag(), Vector3f(1.f, 1.f, 1.f), 0.f));
+}
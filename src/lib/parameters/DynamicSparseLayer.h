@@ -35,105 +35,145 @@
 
 #include "ParamLayer.h"
 
+#include <containers/LockGuard.hpp>
 #include <px4_platform_common/atomic.h>
+#include <pthread.h>
 
+/**
+ * Sparse parameter layer with a lock-free read path.
+ *
+ * The slots are double buffered: readers only access the active buffer, while writers adding or
+ * removing a parameter fill the spare buffer and then publish it (read-copy-update). Readers never
+ * block, but retry if a writer published in between.
+ *
+ * Reclamation: every buffer counts the readers inside it. A reader only accesses the slots after
+ * registering and checking that the buffer is still the active one. A writer only writes to, grows or
+ * frees the slots of the spare buffer once its reader count dropped to zero, which is the grace
+ * period for the readers that were still using it when the other buffer got published.
+ *
+ * Value changes of already contained parameters are an atomic store into the active buffer.
+ *
+ * Memory: the spare buffer is allocated on the first insertion or removal, and then grows with the
+ * active one. From then on the layer takes twice the slot memory of a single buffer (see byteSize()).
+ */
 class DynamicSparseLayer : public ParamLayer
 {
 public:
 	DynamicSparseLayer(ParamLayer *parent, int n_prealloc = 32, int n_grow = 4) : ParamLayer(parent),
-		_n_slots(n_prealloc), _n_grow(n_grow)
+		_n_grow(n_grow)
 	{
-		Slot *slots = (Slot *)malloc(sizeof(Slot) * n_prealloc);
-
-		if (slots == nullptr) {
+		// the spare buffer is only allocated once needed
+		if (!_reserve(_buffers[0], n_prealloc)) {
 			PX4_ERR("Failed to allocate memory for dynamic sparse layer");
-			_n_slots = 0;
-			return;
-		}
-
-		for (int i = 0; i < _n_slots; i++) {
-			slots[i] = {UINT16_MAX, param_value_u{}};
 		}
-
-		_slots.store(slots);
 	}
 
 	virtual ~DynamicSparseLayer()
 	{
-		if (_slots.load()) {
-			free(_slots.load());
-		}
+		free(_buffers[0].slots);
+		free(_buffers[1].slots);
 	}
 
 	bool store(param_t param, param_value_u value) override
 	{
-		AtomicTransaction transaction;
-		Slot *slots = _slots.load();
+		const LockGuard lg{_write_mutex};
+		SlotBuffer *active = _active.load();
+
+		const int index = _getIndex(*active, param);
+
+		if (index < active->count) { // already exists
+			__atomic_store(&active->slots[index].value, &value, __ATOMIC_RELAXED);
+			return true;
+		}
 
-		const int index = _getIndex(param);
+		SlotBuffer *spare = _acquireSpare(active->count + 1);
 
-		if (index < _next_slot) { // already exists
-			slots[index].value = value;
+		if (spare == nullptr) {
+			return false;
+		}
 
-		} else if (_next_slot < _n_slots) {
-			slots[_next_slot++] = {param, value};
-			_sort();
+		// copy with the new parameter inserted in order
+		int n = 0;
 
-		} else {
-			if (!_grow(transaction)) {
-				return false;
+		for (int i = 0; i < active->count; i++) {
+			if ((n == i) && (active->slots[i].param > param)) {
+				spare->slots[n++] = {param, value};
 			}
 
-			_slots.load()[_next_slot++] = {param, value};
-			_sort();
+			spare->slots[n++] = active->slots[i];
 		}
 
+		if (n == active->count) {
+			spare->slots[n++] = {param, value};
+		}
+
+		spare->count = n;
+		_active.store(spare);
 		return true;
 	}
 
 	bool contains(param_t param) const override
 	{
-		const AtomicTransaction transaction;
-		return _getIndex(param) < _next_slot;
+		const SlotBuffer *buffer = _acquireActive();
+		const bool contained = _getIndex(*buffer, param) < buffer->count;
+		_release(buffer);
+		return contained;
 	}
 
 	px4::AtomicBitset<PARAM_COUNT> containedAsBitset() const override
 	{
 		px4::AtomicBitset<PARAM_COUNT> set;
-		const AtomicTransaction transaction;
-		Slot *slots = _slots.load();
+		const SlotBuffer *buffer = _acquireActive();
 
-		for (int i = 0; i < _next_slot; i++) {
-			set.set(slots[i].param);
+		for (int i = 0; i < buffer->count; i++) {
+			set.set(buffer->slots[i].param);
 		}
 
+		_release(buffer);
 		return set;
 	}
 
 	param_value_u get(param_t param) const override
 	{
-		const AtomicTransaction transaction;
-		Slot *slots = _slots.load();
-
-		const int index = _getIndex(param);
-
-		if (index < _next_slot) { // exists in our data structure
-			return slots[index].value;
+		const SlotBuffer *buffer = _acquireActive();
+		const int index = _getIndex(*buffer, param);
+
+		if (index < buffer->count) { // exists in our data structure
+			param_value_u value;
+			__atomic_load(&buffer->slots[index].value, &value, __ATOMIC_RELAXED);
+			_release(buffer);
+			return value;
 		}
 
+		_release(buffer);
 		return _parent->get(param);
 	}
 
 	void reset(param_t param) override
 	{
-		const AtomicTransaction transaction;
-		int index = _getIndex(param);
-		Slot *slots = _slots.load();
-
-		if (index < _next_slot) {
-			slots[index] = {UINT16_MAX, param_value_u{}};
-			_sort();
-			_next_slot--;
+		const LockGuard lg{_write_mutex};
+		SlotBuffer *active = _active.load();
+
+		const int index = _getIndex(*active, param);
+
+		if (index < active->count) {
+			SlotBuffer *spare = _acquireSpare(active->count - 1);
+
+			if (spare == nullptr) {
+				return;
+			}
+
+			// copy without the removed parameter
+			int n = 0;
+
+			for (int i = 0; i < active->count; i++) {
+				if (i != index) {
+					spare->slots[n++] = active->slots[i];
+				}
+			}
+
+			spare->count = n;
+			_active.store(spare);
 		}
 	}
 
@@ -144,12 +184,16 @@ public:
 
 	int size() const override
 	{
-		return _next_slot;
+		const SlotBuffer *buffer = _acquireActive();
+		const int count = buffer->count;
+		_release(buffer);
+		return count;
 	}
 
 	int byteSize() const override
 	{
-		return _n_slots * sizeof(Slot);
+		const LockGuard lg{_write_mutex};
+		return (_buffers[0].capacity + _buffers[1].capacity) * sizeof(Slot);
 	}
 
 private:
@@ -158,88 +202,104 @@ private:
 		param_value_u value;
 	};
 
-	static int _slotCompare(const void *a, const void *b)
+	struct SlotBuffer {
+		Slot *slots{nullptr};
+		int capacity{0};
+		int count{0};
+		mutable px4::atomic<int> readers{0};
+	};
+
+	/**
+	 * Enter the read side: get the active buffer, which is not modified (apart from value stores)
+	 * until released again.
+	 */
+	const SlotBuffer *_acquireActive() const
 	{
-		return ((int)((Slot *)a)->param) - ((int)((Slot *)b)->param);
+		while (true) {
+			SlotBuffer *buffer = _active.load();
+			buffer->readers.fetch_add(1);
+
+			// a writer might have published the other buffer in the meantime
+			if (buffer == _active.load()) {
+				return buffer;
+			}
+
+			buffer->readers.fetch_sub(1);
+		}
 	}
 
-	void _sort()
+	void _release(const SlotBuffer *buffer) const
 	{
-		qsort(_slots.load(), _n_slots, sizeof(Slot), _slotCompare);
+		buffer->readers.fetch_sub(1);
 	}
 
-	int _getIndex(param_t param) const
+	/**
+	 * Get the spare buffer for writing, once all readers left it (with _write_mutex held).
+	 * It is allocated on first use, and grown if it can't hold count slots.
+	 */
+	SlotBuffer *_acquireSpare(int count)
 	{
-		int left = 0;
-		int right = _next_slot - 1;
-		Slot *slots = _slots.load();
+		const SlotBuffer *active = _active.load();
+		SlotBuffer *spare = (active == &_buffers[0]) ? &_buffers[1] : &_buffers[0];
 
-		while (left <= right) {
-			int mid = (left + right) / 2;
+		// grace period: readers stay only for a lookup, but can be preempted, so don't busy wait
+		while (spare->readers.load() != 0) {
+			system_usleep(1);
+		}
 
-			if (slots[mid].param == param) {
-				return mid;
+		if (count > spare->capacity) {
+			int capacity = active->capacity;
 
-			} else if (slots[mid].param < param) {
-				left = mid + 1;
+			if (count > capacity) {
+				capacity = (count > capacity + _n_grow) ? count : capacity + _n_grow;
+			}
 
-			} else {
-				right = mid - 1;
+			if (!_reserve(*spare, capacity)) {
+				return nullptr;
 			}
 		}
 
-		return _next_slot;
+		return spare;
 	}
 
-	bool _grow(AtomicTransaction &transaction)
+	bool _reserve(SlotBuffer &buffer, int capacity)
 	{
-		if (_n_slots == 0) {
+		Slot *slots = (Slot *)malloc(sizeof(Slot) * capacity);
+
+		if (slots == nullptr) {
 			return false;
 		}
 
-		int max_retries = 5;
-
-		// As malloc uses locking, so we need to re-enable IRQ's during malloc/free and
-		// then atomically exchange the buffer
-		while (_next_slot >= _n_slots && max_retries-- > 0) {
-			Slot *previous_slots = nullptr;
-			Slot *new_slots = nullptr;
-
-			do {
-				previous_slots = _slots.load();
-				transaction.unlock();
-
-				if (new_slots) {
-					free(new_slots);
-				}
+		free(buffer.slots);
+		buffer.slots = slots;
+		buffer.capacity = capacity;
+		return true;
+	}
 
-				new_slots = (Slot *) malloc(sizeof(Slot) * (_n_slots + _n_grow));
-				transaction.lock();
+	static int _getIndex(const SlotBuffer &buffer, param_t param)
+	{
+		int left = 0;
+		int right = buffer.count - 1;
 
-				if (new_slots == nullptr) {
-					return false;
-				}
+		while (left <= right) {
+			int mid = (left + right) / 2;
 
-			} while (!_slots.compare_exchange(&previous_slots, new_slots));
+			if (buffer.slots[mid].param == param) {
+				return mid;
 
-			memcpy(new_slots, previous_slots, sizeof(Slot) * _n_slots);
+			} else if (buffer.slots[mid].param < param) {
+				left = mid + 1;
 
-			for (int i = _n_slots; i < _n_slots + _n_grow; i++) {
-				new_slots[i] = {UINT16_MAX, param_value_u{}};
+			} else {
+				right = mid - 1;
 			}
-
-			_n_slots += _n_grow;
-
-			transaction.unlock();
-			free(previous_slots);
-			transaction.lock();
 		}
 
-		return _next_slot < _n_slots;
+		return buffer.count;
 	}
 
-	int _next_slot = 0;
-	int _n_slots = 0;
+	SlotBuffer _buffers[2] {};
+	px4::atomic<SlotBuffer *> _active{&_buffers[0]};
+	mutable pthread_mutex_t _write_mutex = PTHREAD_MUTEX_INITIALIZER;
 	const int _n_grow;
-	px4::atomic<Slot *> _slots{nullptr};
 };
@@ -0,0 +1,487 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file DynamicSparseLayerTest.cpp
+ *
+ * Tests and read contention benchmark for the lock-free DynamicSparseLayer.
+ */
+
+#include <gtest/gtest.h>
+
+#include <parameters/px4_parameters.hpp>
+
+#include "ConstLayer.h"
+#include "DynamicSparseLayer.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * DynamicSparseLayer before the lock-free read path (every access under the global AtomicTransaction
+ * lock), kept as the baseline for the contention benchmark.
+ */
+class LockedDynamicSparseLayer : public ParamLayer
+{
+public:
+	LockedDynamicSparseLayer(ParamLayer *parent, int n_prealloc = 32, int n_grow = 4) : ParamLayer(parent),
+		_n_slots(n_prealloc), _n_grow(n_grow)
+	{
+		Slot *slots = (Slot *)malloc(sizeof(Slot) * n_prealloc);
+
+		if (slots == nullptr) {
+			PX4_ERR("Failed to allocate memory for dynamic sparse layer");
+			_n_slots = 0;
+			return;
+		}
+
+		for (int i = 0; i < _n_slots; i++) {
+			slots[i] = {UINT16_MAX, param_value_u{}};
+		}
+
+		_slots.store(slots);
+	}
+
+	virtual ~LockedDynamicSparseLayer()
+	{
+		if (_slots.load()) {
+			free(_slots.load());
+		}
+	}
+
+	bool store(param_t param, param_value_u value) override
+	{
+		AtomicTransaction transaction;
+		Slot *slots = _slots.load();
+
+		const int index = _getIndex(param);
+
+		if (index < _next_slot) { // already exists
+			slots[index].value = value;
+
+		} else if (_next_slot < _n_slots) {
+			slots[_next_slot++] = {param, value};
+			_sort();
+
+		} else {
+			if (!_grow(transaction)) {
+				return false;
+			}
+
+			_slots.load()[_next_slot++] = {param, value};
+			_sort();
+		}
+
+		return true;
+	}
+
+	bool contains(param_t param) const override
+	{
+		const AtomicTransaction transaction;
+		return _getIndex(param) < _next_slot;
+	}
+
+	px4::AtomicBitset<PARAM_COUNT> containedAsBitset() const override
+	{
+		px4::AtomicBitset<PARAM_COUNT> set;
+		const AtomicTransaction transaction;
+		Slot *slots = _slots.load();
+
+		for (int i = 0; i < _next_slot; i++) {
+			set.set(slots[i].param);
+		}
+
+		return set;
+	}
+
+	param_value_u get(param_t param) const override
+	{
+		const AtomicTransaction transaction;
+		Slot *slots = _slots.load();
+
+		const int index = _getIndex(param);
+
+		if (index < _next_slot) { // exists in our data structure
+			return slots[index].value;
+		}
+
+		return _parent->get(param);
+	}
+
+	void reset(param_t param) override
+	{
+		const AtomicTransaction transaction;
+		int index = _getIndex(param);
+		Slot *slots = _slots.load();
+
+		if (index < _next_slot) {
+			slots[index] = {UINT16_MAX, param_value_u{}};
+			_sort();
+			_next_slot--;
+		}
+	}
+
+	void refresh(param_t param) override
+	{
+		_parent->refresh(param);
+	}
+
+	int size() const override
+	{
+		return _next_slot;
+	}
+
+	int byteSize() const override
+	{
+		return _n_slots * sizeof(Slot);
+	}
+
+private:
+	struct Slot {
+		param_t param;
+		param_value_u value;
+	};
+
+	static int _slotCompare(const void *a, const void *b)
+	{
+		return ((int)((Slot *)a)->param) - ((int)((Slot *)b)->param);
+	}
+
+	void _sort()
+	{
+		qsort(_slots.load(), _n_slots, sizeof(Slot), _slotCompare);
+	}
+
+	int _getIndex(param_t param) const
+	{
+		int left = 0;
+		int right = _next_slot - 1;
+		Slot *slots = _slots.load();
+
+		while (left <= right) {
+			int mid = (left + right) / 2;
+
+			if (slots[mid].param == param) {
+				return mid;
+
+			} else if (slots[mid].param < param) {
+				left = mid + 1;
+
+			} else {
+				right = mid - 1;
+			}
+		}
+
+		return _next_slot;
+	}
+
+	bool _grow(AtomicTransaction &transaction)
+	{
+		if (_n_slots == 0) {
+			return false;
+		}
+
+		int max_retries = 5;
+
+		// As malloc uses locking, so we need to re-enable IRQ's during malloc/free and
+		// then atomically exchange the buffer
+		while (_next_slot >= _n_slots && max_retries-- > 0) {
+			Slot *previous_slots = nullptr;
+			Slot *new_slots = nullptr;
+
+			do {
+				previous_slots = _slots.load();
+				transaction.unlock();
+
+				if (new_slots) {
+					free(new_slots);
+				}
+
+				new_slots = (Slot *) malloc(sizeof(Slot) * (_n_slots + _n_grow));
+				transaction.lock();
+
+				if (new_slots == nullptr) {
+					return false;
+				}
+
+			} while (!_slots.compare_exchange(&previous_slots, new_slots));
+
+			memcpy(new_slots, previous_slots, sizeof(Slot) * _n_slots);
+
+			for (int i = _n_slots; i < _n_slots + _n_grow; i++) {
+				new_slots[i] = {UINT16_MAX, param_value_u{}};
+			}
+
+			_n_slots += _n_grow;
+
+			transaction.unlock();
+			free(previous_slots);
+			transaction.lock();
+		}
+
+		return _next_slot < _n_slots;
+	}
+
+	int _next_slot = 0;
+	int _n_slots = 0;
+	const int _n_grow;
+	px4::atomic<Slot *> _slots{nullptr};
+};
+
+static param_value_u int_value(int32_t i)
+{
+	param_value_u value{};
+	value.i = i;
+	return value;
+}
+
+TEST(DynamicSparseLayerTest, storeGetReset)
+{
+	ConstLayer defaults;
+	DynamicSparseLayer layer{&defaults, 2, 2};
+	const param_t count = (ParamLayer::PARAM_COUNT < 100) ? ParamLayer::PARAM_COUNT : (param_t)100;
+
+	// GIVEN: parameters stored in an order that requires inserting and growing
+	for (param_t param = count; param-- > 0;) {
+		if (param % 3 != 0) {
+			EXPECT_TRUE(layer.store(param, int_value(param)));
+		}
+	}
+
+	// THEN: all stored parameters are contained with their value, others come from the parent
+	for (param_t param = 0; param < count; param++) {
+		EXPECT_EQ(param % 3 != 0, layer.contains(param));
+
+		if (param % 3 != 0) {
+			EXPECT_EQ((int32_t)param, layer.get(param).i);
+
+		} else {
+			EXPECT_EQ(defaults.get(param).i, layer.get(param).i);
+		}
+	}
+
+	// WHEN: updating an existing value and removing every other parameter
+	EXPECT_TRUE(layer.store(1, int_value(-1)));
+	EXPECT_EQ(-1, layer.get(1).i);
+
+	const int size = layer.size();
+	int removed = 0;
+
+	for (param_t param = 0; param < count; param += 2) {
+		if (layer.contains(param)) {
+			layer.reset(param);
+			removed++;
+		}
+
+		EXPECT_FALSE(layer.contains(param));
+	}
+
+	// THEN: the remaining parameters are untouched
+	EXPECT_EQ(size - removed, layer.size());
+	EXPECT_EQ(layer.size(), (int)layer.containedAsBitset().count());
+	EXPECT_EQ(-1, layer.get(1).i);
+	EXPECT_EQ(5, layer.get(5).i);
+}
+
+/**
+ * Reads through the layer from several threads while another thread keeps adding and removing
+ * parameters, which republishes the slot buffers. Readers must always see a consistent value.
+ */
+TEST(DynamicSparseLayerTest, concurrentReadsWhileResizing)
+{
+	static constexpr int NUM_READERS = 4;
+	static constexpr int WRITER_ROUNDS = 2000;
+	const param_t count = (ParamLayer::PARAM_COUNT < 64) ? ParamLayer::PARAM_COUNT : (param_t)64;
+
+	ConstLayer defaults;
+	DynamicSparseLayer layer{&defaults};
+
+	// even parameters stay, odd parameters are added and removed by the writer
+	for (param_t param = 0; param < count; param += 2) {
+		layer.store(param, int_value(param));
+	}
+
+	std::atomic<bool> run{true};
+	std::atomic<int> errors{0};
+	std::vector<std::thread> readers;
+
+	for (int n = 0; n < NUM_READERS; n++) {
+		readers.emplace_back([&]() {
+			while (run.load()) {
+				for (param_t param = 0; param < count; param += 2) {
+					if (layer.get(param).i != (int32_t)param) {
+						errors++;
+					}
+				}
+			}
+		});
+	}
+
+	for (int round = 0; round < WRITER_ROUNDS; round++) {
+		for (param_t param = 1; param < count; param += 2) {
+			layer.store(param, int_value(param));
+		}
+
+		for (param_t param = 1; param < count; param += 2) {
+			layer.reset(param);
+		}
+	}
+
+	run.store(false);
+
+	for (auto &reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_EQ(0, errors.load());
+
+	for (param_t param = 0; param < count; param++) {
+		EXPECT_EQ(param % 2 == 0, layer.contains(param));
+	}
+}
+
+TEST(DynamicSparseLayerTest, spareBufferAllocatedOnFirstInsertion)
+{
+	ConstLayer defaults;
+	DynamicSparseLayer layer{&defaults, 8, 4};
+	const int single_buffer = layer.byteSize();
+	EXPECT_GT(single_buffer, 0);
+
+	// WHEN: only reading
+	EXPECT_FALSE(layer.contains(0));
+	EXPECT_EQ(defaults.get(0).i, layer.get(0).i);
+
+	// THEN: no spare buffer is allocated
+	EXPECT_EQ(single_buffer, layer.byteSize());
+
+	// WHEN: inserting a parameter
+	EXPECT_TRUE(layer.store(0, int_value(7)));
+
+	// THEN: the spare buffer has the size of the active one
+	EXPECT_EQ(2 * single_buffer, layer.byteSize());
+	EXPECT_EQ(7, layer.get(0).i);
+}
+
+/**
+ * Contention benchmark: several reader threads while a writer keeps changing values of contained
+ * parameters and adding and removing others, for the lock-free layer and for the previous
+ * implementation. Readers must always see one of the written values. The read rates are recorded
+ * as test properties (e.g. in the --gtest_output=xml report).
+ */
+template<typename Layer>
+static uint64_t readContention(Layer &layer, param_t count, int num_readers, int run_time_ms, int &errors)
+{
+	// even parameters stay and alternate between two values, odd parameters are added and removed
+	for (param_t param = 0; param < count; param += 2) {
+		layer.store(param, int_value(param));
+	}
+
+	std::atomic<bool> run{true};
+	std::atomic<uint64_t> reads{0};
+	std::atomic<int> inconsistent{0};
+	std::vector<std::thread> readers;
+
+	for (int n = 0; n < num_readers; n++) {
+		readers.emplace_back([&]() {
+			uint64_t local_reads = 0;
+
+			while (run.load()) {
+				for (param_t param = 0; param < count; param += 2) {
+					const int32_t value = layer.get(param).i;
+
+					if ((value != (int32_t)param) && (value != -(int32_t)param)) {
+						inconsistent++;
+					}
+				}
+
+				local_reads += count / 2;
+			}
+
+			reads += local_reads;
+		});
+	}
+
+	std::thread writer([&]() {
+		for (int32_t sign = -1; run.load(); sign = -sign) {
+			for (param_t param = 0; param < count; param++) {
+				if (param % 2 == 0) {
+					layer.store(param, int_value(sign * param));
+
+				} else if (sign > 0) {
+					layer.store(param, int_value(param));
+
+				} else {
+					layer.reset(param);
+				}
+			}
+		}
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(run_time_ms));
+	run.store(false);
+
+	for (auto &reader : readers) {
+		reader.join();
+	}
+
+	writer.join();
+
+	errors = inconsistent.load();
+	return reads.load() * 1000 / run_time_ms;
+}
+
+TEST(DynamicSparseLayerTest, readContentionBenchmark)
+{
+	static constexpr int NUM_READERS = 4;
+	static constexpr int RUN_TIME_MS = 200;
+	const param_t count = (ParamLayer::PARAM_COUNT < 64) ? ParamLayer::PARAM_COUNT : (param_t)64;
+
+	ConstLayer defaults;
+	int errors = 0;
+
+	DynamicSparseLayer lock_free{&defaults};
+	const uint64_t lock_free_reads = readContention(lock_free, count, NUM_READERS, RUN_TIME_MS, errors);
+	EXPECT_EQ(0, errors);
+
+	LockedDynamicSparseLayer locked{&defaults};
+	const uint64_t locked_reads = readContention(locked, count, NUM_READERS, RUN_TIME_MS, errors);
+	EXPECT_EQ(0, errors);
+
+	EXPECT_GT(lock_free_reads, 0u);
+	EXPECT_GT(locked_reads, 0u);
+	::testing::Test::RecordProperty("lock_free_reads_per_s", std::to_string(lock_free_reads));
+	::testing::Test::RecordProperty("locked_reads_per_s", std::to_string(locked_reads));
+}
@@ -36,6 +36,8 @@
 #include <uORB/topics/obstacle_distance.h>
 #include <uORB/uORBManager.hpp>
 
+#include <drivers/drv_hrt.h>
+
 #include <gtest/gtest.h>
 
 class ParameterTest : public ::testing::Test
@@ -78,6 +80,218 @@ TEST_F(ParameterTest, testParamReadWrite)
 	EXPECT_FLOAT_EQ(42.f, value2);
 }
 
+TEST_F(ParameterTest, testParamChangeGeneration)
+{
+	// GIVEN: a parameter and the current change generation
+	const param_t param = param_handle(px4::params::CP_DIST);
+	const uint32_t generation = param_change_generation();
+
+	// WHEN: we set the parameter to its current value
+	float value = -1.f;
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// THEN: nothing changed
+	EXPECT_EQ(generation, param_change_generation());
+	EXPECT_FALSE(param_changed_since(param, generation));
+
+	// WHEN: we change the parameter
+	value = 5.f;
+	EXPECT_EQ(0, param_set_no_notification(param, &value));
+
+	// THEN: the change is tracked
+	EXPECT_NE(generation, param_change_generation());
+	EXPECT_TRUE(param_changed_since(param, generation));
+	EXPECT_FALSE(param_changed_since(param, param_change_generation()));
+
+	// WHEN: we reset the parameter
+	const uint32_t generation_set = param_change_generation();
+	EXPECT_NE(0, param_reset_no_notification(param));
+
+	// THEN: the change is tracked as well
+	EXPECT_TRUE(param_changed_since(param, generation_set));
+}
+
+class ParameterTestModule : public ModuleParams
+{
+public:
+	ParameterTestModule() : ModuleParams(nullptr) {}
+
+	void update() { updateParams(); }
+
+	float getDist() const { return _param_cp_dist.get(); }
+	void setDist(float dist) { _param_cp_dist.set(dist); }
+
+private:
+	DEFINE_PARAMETERS(
+		(ParamFloat<px4::params::CP_DIST>) _param_cp_dist,
+		(ParamFloat<px4::params::CP_DELAY>) _param_cp_delay
+	)
+};
+
+TEST_F(ParameterTest, testModuleParamsIncrementalUpdate)
+{
+	// GIVEN: a module with parameters, with a local (not committed) value
+	ParameterTestModule module;
+	EXPECT_FLOAT_EQ(-1.f, module.getDist());
+	module.setDist(3.f);
+
+	// WHEN: the module updates without any parameter change
+	module.update();
+
+	// THEN: the parameters are not reloaded
+	EXPECT_FLOAT_EQ(3.f, module.getDist());
+
+	// WHEN: another parameter of the module changes
+	float delay = 0.5f;
+	EXPECT_EQ(0, param_set(param_handle(px4::params::CP_DELAY), &delay));
+	module.update();
+
+	// THEN: all parameters of the module are reloaded
+	EXPECT_FLOAT_EQ(-1.f, module.getDist());
+}
+
+TEST_F(ParameterTest, testParamFind)
+{
+	// GIVEN: all parameter names
+	for (unsigned i = 0; i < param_count(); i++) {
+		const param_t param = param_for_index(i);
+
+		// WHEN: we look up the parameter by name
+		// THEN: we get the same handle back
+		EXPECT_EQ(param, param_find_no_notification(param_name(param)));
+	}
+
+	// AND: unknown names, prefixes and extensions of existing names are not found
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification(""));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("NOT_A_PARAM"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("CP_DIS"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("CP_DIST_"));
+}
+
+static param_t param_find_binary_search(const char *name)
+{
+	// reference: binary search over the sorted parameter names
+	unsigned front = 0;
+	unsigned last = param_count();
+
+	while (front < last) {
+		const unsigned middle = front + (last - front) / 2;
+		const int ret = strcmp(name, param_name(param_for_index(middle)));
+
+		if (ret == 0) {
+			return param_for_index(middle);
+
+		} else if (ret < 0) {
+			last = middle;
+
+		} else {
+			front = middle + 1;
+		}
+	}
+
+	return PARAM_INVALID;
+}
+
+TEST_F(ParameterTest, testParamFindStartupBenchmark)
+{
+	// GIVEN: the lookups done at startup, where every module resolves its parameters by name
+	static constexpr int ITERATIONS = 20;
+	const unsigned count = param_count();
+
+	// WHEN: we look up all parameters
+	const hrt_abstime find_start = hrt_absolute_time();
+
+	for (int n = 0; n < ITERATIONS; n++) {
+		for (unsigned i = 0; i < count; i++) {
+			ASSERT_NE(PARAM_INVALID, param_find_no_notification(param_name(param_for_index(i))));
+		}
+	}
+
+	const hrt_abstime find_elapsed = hrt_elapsed_time(&find_start);
+
+	const hrt_abstime reference_start = hrt_absolute_time();
+
+	for (int n = 0; n < ITERATIONS; n++) {
+		for (unsigned i = 0; i < count; i++) {
+			ASSERT_NE(PARAM_INVALID, param_find_binary_search(param_name(param_for_index(i))));
+		}
+	}
+
+	const hrt_abstime reference_elapsed = hrt_elapsed_time(&reference_start);
+
+	// THEN: report the time per startup (all parameters looked up once)
+	printf("param_find: %u params, %.1f us per startup (binary search %.1f us)\n", count,
+	       (double)find_elapsed / ITERATIONS, (double)reference_elapsed / ITERATIONS);
+}
+
+#if defined(CONFIG_PARAM_JOURNAL)
+TEST_F(ParameterTest, testJournaledSaveLoad)
+{
+	// GIVEN: a parameter file without journal
+	static constexpr char filename[] = "param_journal_test.bson";
+	char *previous_file = param_get_default_file() ? strdup(param_get_default_file()) : nullptr;
+	unlink(filename);
+	unlink("param_journal_test.bson.journal");
+	ASSERT_EQ(0, param_set_default_file(filename));
+
+	const param_t dist = param_handle(px4::params::CP_DIST);
+	const param_t delay = param_handle(px4::params::CP_DELAY);
+	const param_t no_data = param_handle(px4::params::CP_GO_NO_DATA);
+	float value = 1.5f;
+	int32_t value_int = 1;
+	EXPECT_EQ(0, param_set(dist, &value));
+	EXPECT_EQ(0, param_set(no_data, &value_int));
+	EXPECT_EQ(0, param_save_default(true));
+
+	// WHEN: parameters are changed and reset, and saved into the journal
+	value = 2.5f;
+	EXPECT_EQ(0, param_set(dist, &value));
+	value = 0.7f;
+	EXPECT_EQ(0, param_set(delay, &value));
+	EXPECT_NE(0, param_reset(no_data));
+	EXPECT_EQ(0, param_save_default(true));
+
+	// THEN: loading the file and replaying the journal restores all of them
+	param_reset_all();
+	EXPECT_EQ(0, param_load_default());
+	EXPECT_EQ(0, param_get(dist, &value));
+	EXPECT_FLOAT_EQ(2.5f, value);
+	EXPECT_EQ(0, param_get(delay, &value));
+	EXPECT_FLOAT_EQ(0.7f, value);
+	EXPECT_TRUE(param_value_is_default(no_data));
+
+	// WHEN: the file is rewritten, but the journal is not cleared afterwards (power loss)
+	FILE *journal = fopen("param_journal_test.bson.journal", "rb");
+	ASSERT_NE(nullptr, journal);
+	uint8_t stale_journal[512];
+	const size_t stale_journal_size = fread(stale_journal, 1, sizeof(stale_journal), journal);
+	fclose(journal);
+
+	param_reset_all();
+	value = 3.5f;
+	EXPECT_EQ(0, param_set(dist, &value));
+	EXPECT_EQ(0, param_save_default(true));
+
+	journal = fopen("param_journal_test.bson.journal", "wb");
+	ASSERT_NE(nullptr, journal);
+	EXPECT_EQ(stale_journal_size, fwrite(stale_journal, 1, stale_journal_size, journal));
+	fclose(journal);
+
+	// THEN: the stale journal is not replayed on top of the new file
+	param_reset_all();
+	EXPECT_EQ(0, param_load_default());
+	EXPECT_EQ(0, param_get(dist, &value));
+	EXPECT_FLOAT_EQ(3.5f, value);
+	EXPECT_TRUE(param_value_is_default(delay));
+
+	unlink(filename);
+	unlink("param_journal_test.bson.journal");
+
+	// restore the default file, also if there was none
+	param_set_default_file(previous_file);
+	free(previous_file);
+}
+#endif // CONFIG_PARAM_JOURNAL
 
 TEST_F(ParameterTest, testUorbSendReceive)
 {
@@ -285,6 +285,25 @@ __EXPORT int		param_set_no_remote_update(param_t param, const void *val, bool no
  */
 __EXPORT void		param_notify_changes(void);
 
+/**
+ * Get the parameter change generation. It is incremented every time a parameter value changes
+ * (set, reset, import or a changed default).
+ *
+ * @return		The current change generation.
+ */
+__EXPORT uint32_t	param_change_generation(void);
+
+/**
+ * Test whether a parameter value might have changed after a given change generation.
+ * Parameters share the change tracking, so this can report a change that did not happen,
+ * but never misses one.
+ *
+ * @param param		A handle returned by param_find or passed by param_foreach.
+ * @param generation	A generation previously returned by param_change_generation().
+ * @return		True if the parameter (possibly) changed after generation.
+ */
+__EXPORT bool		param_changed_since(param_t param, uint32_t generation);
+
 /**
  * Reset a parameter to its default value.
  *
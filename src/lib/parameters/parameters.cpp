@@ -55,6 +55,7 @@
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/atomic_bitset.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -94,6 +95,38 @@ inline static int flash_param_import() { return -1; }
 static char *param_default_file = nullptr;
 static char *param_backup_file = nullptr;
 
+#if defined(CONFIG_PARAM_JOURNAL)
+/**
+ * Parameter journal: on save, changed parameters are appended to a journal next to the default
+ * file instead of rewriting the whole file. The default file is only rewritten (and the journal
+ * cleared) when the journal got too long, or after bulk changes like an import or reset.
+ * The journal header holds the size and crc32 of the default file it was started on, so that a
+ * journal left over from before a rewrite of the file is never replayed on top of the new file.
+ */
+struct __attribute__((packed)) param_journal_record_s {
+	uint8_t type;			///< param_type_t of the value, or PARAM_JOURNAL_RESET
+	char name[16];			///< parameter name, not terminated if it has the maximum length
+	int32_t value;			///< int32 value or float bits
+	uint32_t crc;			///< crc32 over all preceding fields
+};
+
+struct __attribute__((packed)) param_journal_header_s {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t base_size;		///< size of the default file the records apply to
+	uint32_t base_crc;		///< crc32 of the default file the records apply to
+};
+
+static constexpr uint32_t PARAM_JOURNAL_MAGIC = 0x4c4e4a50; // "PJNL"
+static constexpr uint16_t PARAM_JOURNAL_VERSION = 2;
+static constexpr uint8_t PARAM_JOURNAL_RESET = 0xff;
+
+static char *param_journal_file = nullptr;
+static int param_journal_records = 0;
+static bool param_journal_compact = true; ///< the journal can't be used, the next save rewrites the default file
+#endif // CONFIG_PARAM_JOURNAL
+
 #include "autosave.h"
 static ParamAutosave *autosave_instance {nullptr};
 
@@ -104,6 +137,14 @@ static ConstLayer firmware_defaults;
 static DynamicSparseLayer runtime_defaults{&firmware_defaults};
 DynamicSparseLayer user_config{&runtime_defaults};
 
+/**
+ * Parameter change tracking (see param_changed_since()). Every parameter maps to one of the
+ * buckets, which store the generation of the last change of any of its parameters.
+ */
+static constexpr uint16_t PARAM_CHANGE_BUCKETS = 128;
+static px4::atomic<uint32_t> param_generation{0};
+static px4::atomic<uint32_t> param_bucket_generation[PARAM_CHANGE_BUCKETS] {};
+
 /** parameter update topic handle */
 #if not defined(CONFIG_PARAM_REMOTE)
 static orb_advert_t param_topic = nullptr;
@@ -167,6 +208,7 @@ param_notify_changes()
 	pup.active = params_active.count();
 	pup.changed = user_config.size();
 	pup.custom_default = runtime_defaults.size();
+	pup.generation = param_change_generation();
 	pup.timestamp = hrt_absolute_time();
 
 	if (param_topic == nullptr) {
@@ -179,10 +221,100 @@ param_notify_changes()
 #endif
 }
 
+static void param_mark_changed(param_t param)
+{
+	// update the bucket before the global generation, readers load the global generation first
+	AtomicTransaction transaction;
+	const uint32_t generation = param_generation.load() + 1;
+	param_bucket_generation[param % PARAM_CHANGE_BUCKETS].store(generation);
+	param_generation.store(generation);
+}
+
+uint32_t param_change_generation()
+{
+	return param_generation.load();
+}
+
+bool param_changed_since(param_t param, uint32_t generation)
+{
+	if (handle_in_range(param)) {
+		// wrap-around safe comparison
+		return (int32_t)(param_bucket_generation[param % PARAM_CHANGE_BUCKETS].load() - generation) > 0;
+	}
+
+	return false;
+}
+
+#if defined(CONFIG_PARAM_HASH_LOOKUP)
+static constexpr uint16_t param_hash_bucket_count = sizeof(px4::parameters_hash_seed) / sizeof(int16_t);
+static_assert(sizeof(px4::parameters_hash_index) / sizeof(uint16_t) == param_info_count, "invalid parameter hash");
+
+/**
+ * Hash a parameter name, this must match param_name_hash() in px_generate_params.py.
+ *
+ * FNV-1a with the seed mixed into the offset basis, followed by the murmur3 finalizer.
+ */
+static inline uint32_t param_name_hash(const char *name, uint32_t seed)
+{
+	uint32_t hash = 0x811c9dc5u ^ (seed * 0x9e3779b9u);
+
+	for (; *name != '\0'; ++name) {
+		hash ^= static_cast<uint8_t>(*name);
+		hash *= 0x01000193u;
+	}
+
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/**
+ * Lookup a parameter by name through the generated perfect hash.
+ *
+ * @param name			The parameter name.
+ * @return			The parameter handle, or PARAM_INVALID if the name is unknown.
+ */
+static param_t param_find_hashed(const char *name)
+{
+	const int16_t seed = px4::parameters_hash_seed[param_name_hash(name, 0) % param_hash_bucket_count];
+	param_t param;
+
+	if (seed < 0) {
+		// bucket with a single parameter
+		param = static_cast<param_t>(-seed - 1);
+
+	} else {
+		param = px4::parameters_hash_index[param_name_hash(name, seed) % param_info_count];
+	}
+
+	// any name hashes to some slot, so always verify the match
+	if (handle_in_range(param) && (strcmp(name, px4::parameters[param].name) == 0)) {
+		return param;
+	}
+
+	return PARAM_INVALID;
+}
+#endif // CONFIG_PARAM_HASH_LOOKUP
+
 static param_t param_find_internal(const char *name, bool notification)
 {
 	perf_count(param_find_perf);
 
+#if defined(CONFIG_PARAM_HASH_LOOKUP)
+	const param_t param = param_find_hashed(name);
+
+	if (param != PARAM_INVALID) {
+		if (notification) {
+			param_set_used(param);
+		}
+
+		return param;
+	}
+
+#else
 	param_t middle;
 	param_t front = 0;
 	param_t last = param_info_count;
@@ -212,6 +344,8 @@ static param_t param_find_internal(const char *name, bool notification)
 		}
 	}
 
+#endif // CONFIG_PARAM_HASH_LOOKUP
+
 	/* not found */
 	return PARAM_INVALID;
 }
@@ -437,6 +571,10 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		params_unsaved.set(param, !mark_saved);
 		result = PX4_OK;
 
+		if (memcmp(&user_config_value, &new_value, sizeof(new_value)) != 0) {
+			param_mark_changed(param);
+		}
+
 	} else {
 		PX4_ERR("param_set failed to store param %s", param_name(param));
 		result = PX4_ERROR;
@@ -590,6 +728,11 @@ int param_set_default_value(param_t param, const void *val)
 	}
 
 
+	if (result == PX4_OK) {
+		// the value changes unless it's overridden by the user config
+		param_mark_changed(param);
+	}
+
 	if ((result == PX4_OK) && param_used(param)) {
 		// send notification if param is already in use
 		param_notify_changes();
@@ -609,6 +752,11 @@ static int param_reset_internal(param_t param, bool notify = true, bool autosave
 
 	if (handle_in_range(param)) {
 		user_config.reset(param);
+
+		if (param_found) {
+			param_mark_changed(param);
+			params_unsaved.set(param, true);
+		}
 	}
 
 	if (autosave) {
@@ -641,6 +789,10 @@ param_reset_all_internal(bool auto_save)
 		param_reset_internal(param, false, false);
 	}
 
+#if defined(CONFIG_PARAM_JOURNAL)
+	param_journal_compact = true;
+#endif
+
 	if (auto_save) {
 		param_autosave();
 	}
@@ -711,7 +863,7 @@ param_reset_specific(const char *resets[], int num_resets)
 int
 param_set_default_file(const char *filename)
 {
-	if ((param_backup_file && strcmp(filename, param_backup_file) == 0)) {
+	if ((filename && param_backup_file && strcmp(filename, param_backup_file) == 0)) {
 		PX4_ERR("default file can't be the same as the backup file %s", filename);
 		return PX4_ERROR;
 	}
@@ -731,6 +883,22 @@ param_set_default_file(const char *filename)
 		param_default_file = strdup(filename);
 	}
 
+#if defined(CONFIG_PARAM_JOURNAL)
+	free(param_journal_file);
+	param_journal_file = nullptr;
+	param_journal_compact = true;
+
+	if (filename) {
+		static constexpr char suffix[] = ".journal";
+		const size_t len = strlen(filename) + sizeof(suffix);
+		param_journal_file = (char *)malloc(len);
+
+		if (param_journal_file) {
+			snprintf(param_journal_file, len, "%s%s", filename, suffix);
+		}
+	}
+
+#endif // CONFIG_PARAM_JOURNAL
 #endif /* FLASH_BASED_PARAMS */
 
 	return 0;
@@ -772,6 +940,209 @@ const char *param_get_backup_file()
 static int param_export_internal(int fd, param_filter_func filter);
 static int param_verify(int fd);
 
+#if defined(CONFIG_PARAM_JOURNAL)
+static uint32_t param_journal_record_crc(const param_journal_record_s &record)
+{
+	return crc32part((const uint8_t *)&record, offsetof(param_journal_record_s, crc), 0);
+}
+
+/**
+ * Size and crc32 of the current default file.
+ */
+static int param_journal_base_crc(uint32_t &size, uint32_t &crc)
+{
+	int fd = ::open(param_get_default_file(), O_RDONLY);
+
+	if (fd < 0) {
+		return PX4_ERROR;
+	}
+
+	uint8_t buffer[64];
+	int bytes_read;
+	size = 0;
+	crc = 0;
+
+	while ((bytes_read = ::read(fd, buffer, sizeof(buffer))) > 0) {
+		crc = crc32part(buffer, bytes_read, crc);
+		size += bytes_read;
+	}
+
+	::close(fd);
+
+	return (bytes_read == 0) ? PX4_OK : PX4_ERROR;
+}
+
+/**
+ * Clear the journal and bind it to the default file, after that file has been written.
+ * Until then, the previous journal doesn't match the new file anymore and is ignored on load.
+ */
+static int param_journal_clear()
+{
+	param_journal_records = 0;
+	param_journal_compact = true;
+
+	uint32_t base_size = 0;
+	uint32_t base_crc = 0;
+
+	if (param_journal_base_crc(base_size, base_crc) != PX4_OK) {
+		return PX4_ERROR;
+	}
+
+	const param_journal_header_s header{PARAM_JOURNAL_MAGIC, PARAM_JOURNAL_VERSION, sizeof(param_journal_record_s),
+					    base_size, base_crc};
+
+	int fd = ::open(param_journal_file, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return PX4_ERROR;
+	}
+
+	const bool success = (::write(fd, &header, sizeof(header)) == sizeof(header)) && (fsync(fd) == 0);
+	::close(fd);
+
+	param_journal_compact = !success;
+	return success ? PX4_OK : PX4_ERROR;
+}
+
+/**
+ * Append all unsaved parameters to the journal.
+ */
+static int param_journal_append()
+{
+	int fd = ::open(param_journal_file, O_WRONLY | O_APPEND, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return PX4_ERROR;
+	}
+
+	int res = PX4_OK;
+
+	for (param_t param = 0; handle_in_range(param) && (res == PX4_OK); param++) {
+		if (!params_unsaved[param]) {
+			continue;
+		}
+
+		// clear before reading the value, so that a concurrent change is saved next time
+		params_unsaved.set(param, false);
+
+		param_journal_record_s record{};
+		strncpy(record.name, param_name(param), sizeof(record.name));
+
+		if (user_config.contains(param)) {
+			record.type = param_type(param);
+			record.value = user_config.get(param).i;
+
+		} else {
+			record.type = PARAM_JOURNAL_RESET;
+		}
+
+		record.crc = param_journal_record_crc(record);
+
+		if (::write(fd, &record, sizeof(record)) == sizeof(record)) {
+			param_journal_records++;
+
+		} else {
+			params_unsaved.set(param, true);
+			res = PX4_ERROR;
+		}
+	}
+
+	if (fsync(fd) != 0) {
+		res = PX4_ERROR;
+	}
+
+	::close(fd);
+
+	if (res != PX4_OK) {
+		// the journal might now end with a partial record
+		param_journal_compact = true;
+	}
+
+	return res;
+}
+
+/**
+ * Apply the journal on top of the loaded default file, if it was started on that file.
+ */
+static void param_journal_replay()
+{
+	int fd = ::open(param_journal_file, O_RDONLY);
+
+	if (fd < 0) {
+		// no journal yet
+		param_journal_compact = true;
+		return;
+	}
+
+	param_journal_header_s header{};
+
+	if ((::read(fd, &header, sizeof(header)) != sizeof(header))
+	    || (header.magic != PARAM_JOURNAL_MAGIC)
+	    || (header.version != PARAM_JOURNAL_VERSION)
+	    || (header.record_size != sizeof(param_journal_record_s))) {
+
+		PX4_WARN("ignoring invalid parameter journal %s", param_journal_file);
+		param_journal_compact = true;
+		::close(fd);
+		return;
+	}
+
+	uint32_t base_size = 0;
+	uint32_t base_crc = 0;
+
+	if ((param_journal_base_crc(base_size, base_crc) != PX4_OK)
+	    || (header.base_size != base_size) || (header.base_crc != base_crc)) {
+
+		// e.g. power loss after rewriting the default file, but before clearing the journal
+		PX4_WARN("ignoring parameter journal %s of a previous parameter file", param_journal_file);
+		param_journal_compact = true;
+		::close(fd);
+		return;
+	}
+
+	param_journal_record_s record;
+	int bytes_read;
+
+	while ((bytes_read = ::read(fd, &record, sizeof(record))) == sizeof(record)) {
+		if (record.crc != param_journal_record_crc(record)) {
+			bytes_read = -1;
+			break;
+		}
+
+		param_journal_records++;
+
+		char name[sizeof(record.name) + 1] {};
+		memcpy(name, record.name, sizeof(record.name));
+		const param_t param = param_find_no_notification(name);
+
+		if (param == PARAM_INVALID) {
+			// parameter doesn't exist (anymore)
+			continue;
+		}
+
+		if (record.type == PARAM_JOURNAL_RESET) {
+			param_reset_internal(param, false, false);
+			params_unsaved.set(param, false);
+
+		} else if (record.type == param_type(param)) {
+			param_value_u value{};
+			value.i = record.value;
+			param_set_internal(param, &value, true, false);
+		}
+	}
+
+	::close(fd);
+
+	if (bytes_read != 0) {
+		// interrupted write (e.g. power loss), rewrite the default file on the next save
+		PX4_WARN("parameter journal %s truncated after %d records", param_journal_file, param_journal_records);
+		param_journal_compact = true;
+	}
+
+	PX4_INFO("parameter journal: %d records", param_journal_records);
+}
+#endif // CONFIG_PARAM_JOURNAL
+
 int param_save_default(bool blocking)
 {
 	PX4_DEBUG("param_save_default");
@@ -794,9 +1165,25 @@ int param_save_default(bool blocking)
 	}
 
 	int res = PX4_ERROR;
+	bool journaled = false;
 	const char *filename = param_get_default_file();
 
-	if (filename) {
+#if defined(CONFIG_PARAM_JOURNAL)
+
+	if (filename && param_journal_file && !param_journal_compact
+	    && (param_journal_records < CONFIG_PARAM_JOURNAL_MAX_RECORDS)) {
+		perf_begin(param_export_perf);
+		res = param_journal_append();
+		perf_end(param_export_perf);
+		journaled = (res == PX4_OK);
+	}
+
+#endif // CONFIG_PARAM_JOURNAL
+
+	if (journaled) {
+		// only the changes were written
+
+	} else if (filename) {
 		static constexpr int MAX_ATTEMPTS = 3;
 
 		for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
@@ -826,6 +1213,15 @@ int param_save_default(bool blocking)
 			}
 		}
 
+#if defined(CONFIG_PARAM_JOURNAL)
+
+		// the default file contains everything now
+		if ((res == PX4_OK) && param_journal_file && (param_journal_clear() != PX4_OK)) {
+			PX4_ERR("clearing parameter journal %s failed", param_journal_file);
+		}
+
+#endif // CONFIG_PARAM_JOURNAL
+
 	} else {
 		perf_begin(param_export_perf);
 		res = flash_param_save(nullptr);
@@ -835,7 +1231,7 @@ int param_save_default(bool blocking)
 	if (res != PX4_OK) {
 		PX4_ERR("param export failed (%d)", res);
 
-	} else {
+	} else if (!journaled) {
 		params_unsaved.reset();
 
 		// backup file
@@ -901,6 +1297,16 @@ param_load_default()
 		return -2;
 	}
 
+#if defined(CONFIG_PARAM_JOURNAL)
+
+	if (param_journal_file) {
+		param_journal_compact = false;
+		param_journal_records = 0;
+		param_journal_replay();
+	}
+
+#endif // CONFIG_PARAM_JOURNAL
+
 	return res;
 }
 
@@ -1202,6 +1608,11 @@ param_import_callback(bson_decoder_t decoder, bson_node_t node)
 static int
 param_import_internal(int fd)
 {
+#if defined(CONFIG_PARAM_JOURNAL)
+	// imported values are not journaled
+	param_journal_compact = true;
+#endif // CONFIG_PARAM_JOURNAL
+
 	static constexpr int MAX_ATTEMPTS = 3;
 
 	for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
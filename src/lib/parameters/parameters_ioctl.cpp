@@ -190,6 +190,18 @@ int	param_ioctl(unsigned int cmd, unsigned long arg)
 		}
 		break;
 
+	case PARAMIOCGENERATION: {
+			paramiocgeneration_t *data = (paramiocgeneration_t *)arg;
+			data->ret = param_change_generation();
+		}
+		break;
+
+	case PARAMIOCCHANGEDSINCE: {
+			paramiocchangedsince_t *data = (paramiocchangedsince_t *)arg;
+			data->ret = param_changed_since(data->param, data->generation);
+		}
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
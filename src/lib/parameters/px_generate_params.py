@@ -19,6 +19,84 @@ except ImportError as e:
 
 import os
 
+# parameter lookup perfect hash, must match param_name_hash() in parameters.cpp
+HASH_KEYS_PER_BUCKET = 4
+
+def param_name_hash(name, seed):
+    """
+    FNV-1a over the parameter name with the seed mixed into the offset basis,
+    followed by the murmur3 finalizer.
+    """
+    h = (0x811c9dc5 ^ ((seed * 0x9e3779b9) & 0xffffffff)) & 0xffffffff
+    for c in name.encode('ascii'):
+        h ^= c
+        h = (h * 0x01000193) & 0xffffffff
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+def generate_perfect_hash(names):
+    """
+    Build a minimal perfect hash (hash and displace) over the sorted parameter
+    names.
+
+    Every name is first hashed (seed 0) into one of the buckets. For buckets
+    with more than one name a seed is searched so that all of its names land in
+    distinct free slots of the index table (slot = hash(name, seed) % count).
+    Buckets with a single name store the parameter index directly, encoded as
+    -(index + 1), and don't need a second hash at runtime.
+
+    @return (bucket seeds, slot -> parameter index table)
+    """
+    count = len(names)
+    num_buckets = max(1, (count + HASH_KEYS_PER_BUCKET - 1) // HASH_KEYS_PER_BUCKET)
+
+    buckets = [[] for _ in range(num_buckets)]
+    for index, name in enumerate(names):
+        buckets[param_name_hash(name, 0) % num_buckets].append(index)
+
+    seeds = [0] * num_buckets
+    table = [None] * count
+
+    # place the largest buckets first, while the table is still mostly empty
+    order = sorted(range(num_buckets), key=lambda b: len(buckets[b]), reverse=True)
+    singles = []
+
+    for b in order:
+        if len(buckets[b]) <= 1:
+            if buckets[b]:
+                singles.append(b)
+            continue
+
+        seed = 1
+        while True:
+            slots = [param_name_hash(names[i], seed) % count for i in buckets[b]]
+            if len(set(slots)) == len(slots) and all(table[s] is None for s in slots):
+                break
+            seed += 1
+            if seed > 0x7fff:
+                raise Exception('failed to find perfect hash seed for bucket {}'.format(b))
+
+        for i, s in zip(buckets[b], slots):
+            table[s] = i
+        seeds[b] = seed
+
+    # singletons are stored directly in the seed array, fill the remaining table
+    # slots so that the table stays a valid (unused) index
+    free_slots = [s for s in range(count) if table[s] is None]
+    for b in singles:
+        index = buckets[b][0]
+        seeds[b] = -(index + 1)
+        table[free_slots.pop()] = index
+
+    if count > 0x7fff:
+        raise Exception('too many parameters for 16 bit perfect hash')
+
+    return seeds, table
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -39,6 +117,9 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    param_hash_seeds, param_hash_index = generate_perfect_hash(
+        [param.attrib["name"] for param in params])
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -55,7 +136,9 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params,
+                                      param_hash_seeds=param_hash_seeds,
+                                      param_hash_index=param_hash_index))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
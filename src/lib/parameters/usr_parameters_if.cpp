@@ -219,3 +219,17 @@ uint32_t param_hash_check()
 	boardctl(PARAMIOCHASH, reinterpret_cast<unsigned long>(&data));
 	return data.ret;
 }
+
+uint32_t param_change_generation()
+{
+	paramiocgeneration_t data = {0};
+	boardctl(PARAMIOCGENERATION, reinterpret_cast<unsigned long>(&data));
+	return data.ret;
+}
+
+bool param_changed_since(param_t param, uint32_t generation)
+{
+	paramiocchangedsince_t data = {param, generation, true};
+	boardctl(PARAMIOCCHANGEDSINCE, reinterpret_cast<unsigned long>(&data));
+	return data.ret;
+}
@@ -160,9 +160,10 @@ void Ekf::fuseDrag(const dragSample &drag_sample)
 		    && (test_ratio < 1.f)
 		   ) {
 
-			VectorState K = P * H / innovation_variance(axis_index);
+			const SparseHDrag H_sparse(H);
+			VectorState K = P * H_sparse / innovation_variance(axis_index);
 
-			if (measurementUpdate(K, H, R_ACC, innovation(axis_index))) {
+			if (measurementUpdate(K, H_sparse, R_ACC, innovation(axis_index))) {
 				fused[axis_index] = true;
 			}
 		}
@@ -277,7 +277,8 @@ bool Ekf::fuseEvVelocity(estimator_aid_source3d_s &aid_src, const extVisionSampl
 				sym::ComputeEvBodyVelHz(state_vector, &H);
 			}
 
-			const float innov_var = (H.T() * P * H)(0, 0) + aid_src.observation_variance[index];
+			const SparseHBodyVel H_sparse(H);
+			const float innov_var = matrix::quadraticForm(P, H_sparse) + aid_src.observation_variance[index];
 			const float innov = (_R_to_earth.transpose() * _state.vel - Vector3f(aid_src.observation))(index, 0);
 
 			updateAidSourceStatus(current_aid_src,
@@ -289,7 +290,7 @@ bool Ekf::fuseEvVelocity(estimator_aid_source3d_s &aid_src, const extVisionSampl
 					      math::max(_params.ev_vel_innov_gate, 1.f));	// innovation gate
 
 			if (!current_aid_src.innovation_rejected) {
-				fuseBodyVelocity(current_aid_src, current_aid_src.innovation_variance, H);
+				fuseBodyVelocity(current_aid_src, current_aid_src.innovation_variance, H_sparse);
 
 			}
 
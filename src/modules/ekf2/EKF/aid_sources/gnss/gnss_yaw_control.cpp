@@ -203,9 +203,10 @@ void Ekf::fuseGnssYaw(float antenna_yaw_offset)
 
 	// calculate the Kalman gains
 	// only calculate gains for states we are using
-	VectorState Kfusion = P * H / aid_src.innovation_variance;
+	const SparseHAttitude H_sparse(H);
+	VectorState Kfusion = P * H_sparse / aid_src.innovation_variance;
 
-	const bool is_fused = measurementUpdate(Kfusion, H, aid_src.observation_variance, aid_src.innovation);
+	const bool is_fused = measurementUpdate(Kfusion, H_sparse, aid_src.observation_variance, aid_src.innovation);
 	_fault_status.flags.bad_hdg = !is_fused;
 	aid_src.fused = is_fused;
 
@@ -104,7 +104,8 @@ bool Ekf::fuseMag(const Vector3f &mag, const float R_MAG, VectorState &H, estima
 			return false;
 		}
 
-		VectorState Kfusion = P * H / aid_src.innovation_variance[index];
+		const SparseHMag H_sparse(H);
+		VectorState Kfusion = P * H_sparse / aid_src.innovation_variance[index];
 
 		if (update_all_states) {
 			if (!update_tilt) {
@@ -125,7 +126,8 @@ bool Ekf::fuseMag(const Vector3f &mag, const float R_MAG, VectorState &H, estima
 			Kfusion.slice<State::mag_B.dof, 1>(State::mag_B.idx, 0) = K_mag_B;
 		}
 
-		if (measurementUpdate(Kfusion, H, aid_src.observation_variance[index], aid_src.innovation[index])) {
+		if (measurementUpdate(Kfusion, H_sparse, aid_src.observation_variance[index],
+				      aid_src.innovation[index])) {
 			fused[index] = true;
 		}
 	}
@@ -185,9 +187,10 @@ bool Ekf::fuseDeclination(float decl_sigma)
 		}
 
 		// Calculate the Kalman gains
-		VectorState Kfusion = P * H / innovation_variance;
+		const SparseHMagDeclination H_sparse(H);
+		VectorState Kfusion = P * H_sparse / innovation_variance;
 
-		const bool is_fused = measurementUpdate(Kfusion, H, R_DECL, innovation);
+		const bool is_fused = measurementUpdate(Kfusion, H_sparse, R_DECL, innovation);
 
 		_fault_status.flags.bad_mag_decl = !is_fused;
 
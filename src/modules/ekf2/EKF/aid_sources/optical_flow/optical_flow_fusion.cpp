@@ -80,13 +80,14 @@ bool Ekf::fuseOptFlow(VectorState &H, const bool update_terrain)
 			_aid_src_optical_flow.innovation[1] = predictFlow(flow_gyro_corrected)(1) - _aid_src_optical_flow.observation[1];
 		}
 
-		VectorState Kfusion = P * H / _aid_src_optical_flow.innovation_variance[index];
+		const SparseHFlow H_sparse(H);
+		VectorState Kfusion = P * H_sparse / _aid_src_optical_flow.innovation_variance[index];
 
 		if (!update_terrain) {
 			Kfusion(State::terrain.idx) = 0.f;
 		}
 
-		if (measurementUpdate(Kfusion, H, _aid_src_optical_flow.observation_variance[index],
+		if (measurementUpdate(Kfusion, H_sparse, _aid_src_optical_flow.observation_variance[index],
 				      _aid_src_optical_flow.innovation[index])) {
 			fused[index] = true;
 		}
@@ -45,8 +45,10 @@ bool Ekf::fuseHaglRng(estimator_aid_source1d_s &aid_src, bool update_height, boo
 
 	sym::ComputeHaglH(&H);
 
+	const SparseHHagl H_sparse(H);
+
 	// calculate the Kalman gain
-	VectorState K = P * H / aid_src.innovation_variance;
+	VectorState K = P * H_sparse / aid_src.innovation_variance;
 
 	if (!update_terrain) {
 		K(State::terrain.idx) = 0.f;
@@ -58,7 +60,7 @@ bool Ekf::fuseHaglRng(estimator_aid_source1d_s &aid_src, bool update_height, boo
 		K(State::terrain.idx) = k_terrain;
 	}
 
-	measurementUpdate(K, H, aid_src.observation_variance, aid_src.innovation);
+	measurementUpdate(K, H_sparse, aid_src.observation_variance, aid_src.innovation);
 
 	// record last successful fusion event
 	_innov_check_fail_status.flags.reject_hagl = false;
@@ -229,6 +229,8 @@ void Ekf::predictCovariance(const imuSample &imu_delayed)
 
 #endif // CONFIG_EKF2_TERRAIN
 
+#if !defined(CONFIG_EKF2_PACKED_COVARIANCE)
+
 	// covariance matrix is symmetrical, so copy upper half to lower half
 	for (unsigned row = 0; row < State::size; row++) {
 		for (unsigned column = 0; column < row; column++) {
@@ -236,9 +238,42 @@ void Ekf::predictCovariance(const imuSample &imu_delayed)
 		}
 	}
 
+#endif // !CONFIG_EKF2_PACKED_COVARIANCE
+
 	constrainStateVariances();
 }
 
+void Ekf::josephCovarianceUpdate(const VectorState &K, const VectorState &PH, const float innovation_variance)
+{
+	// Efficient implementation of the Joseph stabilized covariance update
+	// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
+	// P = (I - K * H) * P * (I - K * H).T + K * R * K.T
+	//   = P - K * H * P - P * H.T * K.T + K * (H * P * H.T + R) * K.T
+	//   = P - K * PH.T - PH * K.T + K * innovation_variance * K.T
+	// The result is symmetric even if K is not optimal (e.g.: some gains have been zeroed),
+	// so only the upper triangle is computed. With the packed storage that is all there is,
+	// otherwise it is then copied to the lower half
+	for (unsigned row = 0; row < State::size; row++) {
+		const float K_row = K(row);
+		const float PH_row = PH(row);
+		const float KS_row = K_row * innovation_variance;
+
+		for (unsigned column = row; column < State::size; column++) {
+			P(row, column) += KS_row * K(column) - K_row * PH(column) - PH_row * K(column);
+		}
+	}
+
+#if !defined(CONFIG_EKF2_PACKED_COVARIANCE)
+
+	for (unsigned row = 0; row < State::size; row++) {
+		for (unsigned column = 0; column < row; column++) {
+			P(row, column) = P(column, row);
+		}
+	}
+
+#endif // !CONFIG_EKF2_PACKED_COVARIANCE
+}
+
 void Ekf::constrainStateVariances()
 {
 	// NOTE: This limiting is a last resort and should not be relied on
@@ -74,6 +74,33 @@ public:
 	typedef matrix::Vector<float, State::size> VectorState;
 	typedef matrix::SquareMatrix<float, State::size> SquareMatrixState;
 
+	template<size_t ...Idxs>
+	using SparseVectorState = matrix::SparseVector<float, State::size, Idxs...>;
+
+	// Non-zero entries of the observation Jacobians (see python/ekf_derivation/derivation.py)
+	using SparseHAttitude = SparseVectorState<State::quat_nominal.idx + 0, State::quat_nominal.idx + 1,
+	      State::quat_nominal.idx + 2>;
+	using SparseHMag = SparseVectorState<State::quat_nominal.idx + 0, State::quat_nominal.idx + 1,
+	      State::quat_nominal.idx + 2,
+	      State::mag_I.idx + 0, State::mag_I.idx + 1, State::mag_I.idx + 2,
+	      State::mag_B.idx + 0, State::mag_B.idx + 1, State::mag_B.idx + 2>;
+	using SparseHMagDeclination = SparseVectorState<State::mag_I.idx + 0, State::mag_I.idx + 1>;
+	using SparseHAirspeed = SparseVectorState<State::vel.idx + 0, State::vel.idx + 1, State::vel.idx + 2,
+	      State::wind_vel.idx + 0, State::wind_vel.idx + 1>;
+	using SparseHSideslip = SparseVectorState<State::quat_nominal.idx + 0, State::quat_nominal.idx + 1,
+	      State::quat_nominal.idx + 2,
+	      State::vel.idx + 0, State::vel.idx + 1, State::vel.idx + 2,
+	      State::wind_vel.idx + 0, State::wind_vel.idx + 1>;
+	using SparseHDrag = SparseHSideslip;
+	using SparseHFlow = SparseVectorState<State::quat_nominal.idx + 0, State::quat_nominal.idx + 1,
+	      State::quat_nominal.idx + 2,
+	      State::vel.idx + 0, State::vel.idx + 1, State::vel.idx + 2,
+	      State::pos.idx + 2, State::terrain.idx>;
+	using SparseHBodyVel = SparseVectorState<State::quat_nominal.idx + 0, State::quat_nominal.idx + 1,
+	      State::quat_nominal.idx + 2,
+	      State::vel.idx + 0, State::vel.idx + 1, State::vel.idx + 2>;
+	using SparseHHagl = SparseVectorState<State::pos.idx + 2, State::terrain.idx>;
+
 	Ekf()
 	{
 		reset();
@@ -240,7 +267,11 @@ public:
 	matrix::SquareMatrix<float, S.dof>getStateCovariance() const { return P.slice<S.dof, S.dof>(S.idx, S.idx); }
 
 	// get the full covariance matrix
+#if defined(CONFIG_EKF2_PACKED_COVARIANCE)
+	matrix::SquareMatrix<float, State::size> covariances() const { return P.dense(); }
+#else
 	const matrix::SquareMatrix<float, State::size> &covariances() const { return P; }
+#endif // CONFIG_EKF2_PACKED_COVARIANCE
 	float stateCovariance(unsigned r, unsigned c) const { return P(r, c); }
 
 	// get the diagonal elements of the covariance matrix
@@ -323,6 +354,11 @@ public:
 	// fuse single direct state measurement (eg NED velocity, NED position, mag earth field, etc)
 	bool fuseDirectStateMeasurement(const float innov, const float innov_var, const float R, const int state_index);
 
+	// fuse direct measurements of num_states consecutive states (eg NED velocity) sequentially, the variances
+	// being constrained and the accumulated state correction applied once after the last axis
+	bool fuseDirectStateMeasurements(const float innov[], const float innov_var[], const float R[],
+					 const int first_state_index, const unsigned num_states);
+
 	// gyro bias
 	const Vector3f &getGyroBias() const { return _state.gyro_bias; } // get the gyroscope bias in rad/s
 	Vector3f getGyroBiasVariance() const { return getStateVariance<State::gyro_bias>(); } // get the gyroscope bias variance in rad/s
@@ -471,7 +507,10 @@ public:
 	const auto &aid_src_aux_vel() const { return _aid_src_aux_vel; }
 #endif // CONFIG_EKF2_AUXVEL
 
-	bool measurementUpdate(VectorState &K, const VectorState &H, const float R, const float innovation)
+	// H can either be a dense VectorState or a SparseVectorState holding only the non-zero entries of the
+	// observation Jacobian, in which case the P * H products only touch the corresponding columns of P
+	template<typename VectorH>
+	bool measurementUpdate(VectorState &K, const VectorH &H, const float R, const float innovation)
 	{
 		clearInhibitedStateKalmanGains(K);
 
@@ -486,33 +525,9 @@ public:
 		const VectorState KR = K * R;
 		P += KR.multiplyByTranspose(K);
 #else
-		// Efficient implementation of the Joseph stabilized covariance update
-		// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
-		// P = (I - K * H) * P * (I - K * H).T   + K * R * K.T
-		//   =      P_temp     * (I - H.T * K.T) + K * R * K.T
-		//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
-
-		// Step 1: conventional update
-		// Compute P_temp and store it in P to avoid allocating more memory
-		// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-		VectorState PH = P * H; // H is stored as a column vector. H is in fact H.T
-
-		for (unsigned i = 0; i < State::size; i++) {
-			for (unsigned j = 0; j < State::size; j++) {
-				P(i, j) -= K(i) * PH(j); // P is now not symmetrical if K is not optimal (e.g.: some gains have been zeroed)
-			}
-		}
-
-		// Step 2: stabilized update
-		PH = P * H; // H is stored as a column vector. H is in fact H.T
-
-		for (unsigned i = 0; i < State::size; i++) {
-			for (unsigned j = 0; j <= i; j++) {
-				P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
-				P(j, i) = P(i, j);
-			}
-		}
-
+		// P is symmetric, so PH == H.T * P.T == H.T * P. H is stored as a column vector. H is in fact H.T
+		const VectorState PH = P * H;
+		josephCovarianceUpdate(K, PH, H.dot(PH) + R);
 #endif
 
 		constrainStateVariances();
@@ -597,7 +612,11 @@ private:
 	Vector2f _accel_lpf_NE{};			///< Low pass filtered horizontal earth frame acceleration (m/sec**2)
 	float _height_rate_lpf{0.0f};
 
+#if defined(CONFIG_EKF2_PACKED_COVARIANCE)
+	matrix::PackedSymmetricMatrix<float, State::size> P{};	///< state covariance matrix, upper triangle only
+#else
 	SquareMatrixState P{};	///< state covariance matrix
+#endif // CONFIG_EKF2_PACKED_COVARIANCE
 
 #if defined(CONFIG_EKF2_DRAG_FUSION)
 	estimator_aid_source2d_s _aid_src_drag {};
@@ -920,6 +939,10 @@ private:
 #endif // CONFIG_EKF2_WIND
 	}
 
+	// Joseph stabilized covariance update for a scalar observation given the Kalman gain K, PH = P * H
+	// and the innovation variance H.T * P * H + R. Only the upper triangle of P is computed
+	void josephCovarianceUpdate(const VectorState &K, const VectorState &PH, float innovation_variance);
+
 	// limit the diagonal of the covariance matrix
 	void constrainStateVariances();
 
@@ -963,7 +986,7 @@ private:
 	void stopEvVelFusion();
 	void stopEvYawFusion();
 	bool fuseEvVelocity(estimator_aid_source3d_s &aid_src, const extVisionSample &ev_sample);
-	void fuseBodyVelocity(estimator_aid_source1d_s &aid_src, float &innov_var, VectorState &H)
+	void fuseBodyVelocity(estimator_aid_source1d_s &aid_src, float &innov_var, const SparseHBodyVel &H)
 	{
 		VectorState Kfusion = P * H / innov_var;
 		aid_src.fused = measurementUpdate(Kfusion, H, aid_src.observation_variance, aid_src.innovation);
@@ -923,39 +923,43 @@ bool Ekf::fuseDirectStateMeasurement(const float innov, const float innov_var, c
 	const VectorState KR = K * R;
 	P += KR.multiplyByTranspose(K);
 #else
-	// Efficient implementation of the Joseph stabilized covariance update
-	// Based on "G. J. Bierman. Factorization Methods for Discrete Sequential Estimation. Academic Press, Dover Publications, New York, 1977, 2006"
-	// P = (I - K * H) * P * (I - K * H).T   + K * R * K.T
-	//   =      P_temp     * (I - H.T * K.T) + K * R * K.T
-	//   =      P_temp - P_temp * H.T * K.T  + K * R * K.T
-
-	// Step 1: conventional update
-	// Compute P_temp and store it in P to avoid allocating more memory
-	// P is symmetric, so PH == H.T * P.T == H.T * P. Taking the row is faster as matrices are row-major
-	VectorState PH = P.row(state_index);
-
-	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j < State::size; j++) {
-			P(i, j) -= K(i) * PH(j); // P is now not symmetric if K is not optimal (e.g.: some gains have been zeroed)
-		}
-	}
+	// H selects a single state, so PH = P * H is a column of P and H.T * P * H a diagonal element
+	josephCovarianceUpdate(K, P.col(state_index), P(state_index, state_index) + R);
+#endif
+
+	constrainStateVariances();
 
-	// Step 2: stabilized update
-	// P (or "P_temp") is not symmetric so we must take the column
-	PH = P.col(state_index);
+	// apply the state corrections
+	fuse(K, innov);
+	return true;
+}
 
-	for (unsigned i = 0; i < State::size; i++) {
-		for (unsigned j = 0; j <= i; j++) {
-			P(i, j) = P(i, j) - PH(i) * K(j) + K(i) * R * K(j);
-			P(j, i) = P(i, j);
+bool Ekf::fuseDirectStateMeasurements(const float innov[], const float innov_var[], const float R[],
+				      const int first_state_index, const unsigned num_states)
+{
+	// Sequential fusion: each axis is processed with the covariance updated by the previous ones.
+	// The state corrections don't depend on each other and are summed up to be applied at once.
+	VectorState correction;
+
+	for (unsigned i = 0; i < num_states; i++) {
+		const int state_index = first_state_index + i;
+
+		VectorState K;  // Kalman gain vector for this observation
+
+		for (int row = 0; row < State::size; row++) {
+			K(row) = P(row, state_index) / innov_var[i];
 		}
-	}
 
-#endif
+		clearInhibitedStateKalmanGains(K);
+
+		josephCovarianceUpdate(K, P.col(state_index), P(state_index, state_index) + R[i]);
+
+		correction += K * innov[i];
+	}
 
 	constrainStateVariances();
 
 	// apply the state corrections
-	fuse(K, innov);
+	fuse(correction, 1.f);
 	return true;
 }
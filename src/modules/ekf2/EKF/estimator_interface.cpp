@@ -77,6 +77,18 @@ EstimatorInterface::~EstimatorInterface()
 
 // Accumulate imu data and store to buffer at desired rate
 void EstimatorInterface::setIMUData(const imuSample &imu_sample)
+{
+	// accumulate and down-sample imu data and push to the buffer when new downsampled data becomes available
+	if (_imu_down_sampler.update(imu_sample)) {
+		const imuSample imu_downsampled = _imu_down_sampler.getDownSampledImuAndTriggerReset();
+		setIMUData(imu_sample, &imu_downsampled);
+
+	} else {
+		setIMUData(imu_sample, nullptr);
+	}
+}
+
+void EstimatorInterface::setIMUData(const imuSample &imu_sample, const imuSample *imu_downsampled)
 {
 	// TODO: resolve misplaced responsibility
 	if (!_initialised) {
@@ -89,22 +101,22 @@ void EstimatorInterface::setIMUData(const imuSample &imu_sample)
 	_output_predictor.calculateOutputStates(imu_sample.time_us, imu_sample.delta_ang, imu_sample.delta_ang_dt,
 						imu_sample.delta_vel, imu_sample.delta_vel_dt);
 
-	// accumulate and down-sample imu data and push to the buffer when new downsampled data becomes available
-	if (_imu_down_sampler.update(imu_sample)) {
+	// push the down-sampled imu data to the buffer
+	if (imu_downsampled) {
 
 		_imu_updated = true;
 
-		imuSample imu_downsampled = _imu_down_sampler.getDownSampledImuAndTriggerReset();
+		imuSample imu_constrained{*imu_downsampled};
 
 		// as a precaution constrain the integration delta time to prevent numerical problems
 		const float filter_update_period_s = _params.filter_update_interval_us * 1e-6f;
 		const float imu_min_dt = 0.5f * filter_update_period_s;
 		const float imu_max_dt = 2.0f * filter_update_period_s;
 
-		imu_downsampled.delta_ang_dt = math::constrain(imu_downsampled.delta_ang_dt, imu_min_dt, imu_max_dt);
-		imu_downsampled.delta_vel_dt = math::constrain(imu_downsampled.delta_vel_dt, imu_min_dt, imu_max_dt);
+		imu_constrained.delta_ang_dt = math::constrain(imu_constrained.delta_ang_dt, imu_min_dt, imu_max_dt);
+		imu_constrained.delta_vel_dt = math::constrain(imu_constrained.delta_vel_dt, imu_min_dt, imu_max_dt);
 
-		_imu_buffer.push(imu_downsampled);
+		_imu_buffer.push(imu_constrained);
 
 		// get the oldest data from the buffer
 		_time_delayed_us = _imu_buffer.get_oldest().time_us;
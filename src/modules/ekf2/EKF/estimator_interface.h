@@ -83,6 +83,10 @@ class EstimatorInterface
 public:
 	void setIMUData(const imuSample &imu_sample);
 
+	// set IMU data that has already been down-sampled to the filter update rate (e.g. once for all the
+	// estimator instances using the same IMU), imu_downsampled is nullptr if no new down-sampled data is available
+	void setIMUData(const imuSample &imu_sample, const imuSample *imu_downsampled);
+
 #if defined(CONFIG_EKF2_GNSS)
 	void setGpsData(const gnssSample &gnss_sample);
 
@@ -26,9 +26,9 @@ namespace sym {
  *     innov: Scalar
  *     innov_var: Scalar
  */
-template <typename Scalar>
+template <typename Scalar, typename MatrixP>
 void ComputeAirspeedInnovAndInnovVar(const matrix::Matrix<Scalar, 25, 1>& state,
-                                     const matrix::Matrix<Scalar, 24, 24>& P, const Scalar airspeed,
+                                     const MatrixP& P, const Scalar airspeed,
                                      const Scalar R, const Scalar epsilon,
                                      Scalar* const innov = nullptr,
                                      Scalar* const innov_var = nullptr) {
@@ -24,9 +24,9 @@ namespace sym {
  *     innov_var: Scalar
  *     Hy: Matrix24_1
  */
-template <typename Scalar>
+template <typename Scalar, typename MatrixP>
 void ComputeGravityYInnovVarAndH(const matrix::Matrix<Scalar, 25, 1>& state,
-                                 const matrix::Matrix<Scalar, 24, 24>& P, const Scalar R,
+                                 const MatrixP& P, const Scalar R,
                                  Scalar* const innov_var = nullptr,
                                  matrix::Matrix<Scalar, 24, 1>* const Hy = nullptr) {
   // Total ops: 22
@@ -22,8 +22,8 @@ namespace sym {
  * Outputs:
  *     innov_var: Scalar
  */
-template <typename Scalar>
-void ComputeHaglInnovVar(const matrix::Matrix<Scalar, 24, 24>& P, const Scalar R,
+template <typename Scalar, typename MatrixP>
+void ComputeHaglInnovVar(const MatrixP& P, const Scalar R,
                          Scalar* const innov_var = nullptr) {
   // Total ops: 4
 
@@ -25,9 +25,9 @@ namespace sym {
  *     innov: Scalar
  *     innov_var: Scalar
  */
-template <typename Scalar>
+template <typename Scalar, typename MatrixP>
 void ComputeSideslipInnovAndInnovVar(const matrix::Matrix<Scalar, 25, 1>& state,
-                                     const matrix::Matrix<Scalar, 24, 24>& P, const Scalar R,
+                                     const MatrixP& P, const Scalar R,
                                      const Scalar epsilon, Scalar* const innov = nullptr,
                                      Scalar* const innov_var = nullptr) {
   // Total ops: 265
@@ -77,6 +77,19 @@ def generate_px4_function(function_name, output_names):
 
             print(line, end='')
 
+    # Accept any state covariance type providing a symmetric operator()(row, col),
+    # e.g. matrix::PackedSymmetricMatrix used with CONFIG_EKF2_PACKED_COVARIANCE
+    with open(os.path.abspath(metadata.generated_files[0]), 'r+') as file:
+        code = file.read()
+        covariance_arg = re.compile(r'const matrix::Matrix<Scalar, (\d+), \1>& P\b')
+
+        if covariance_arg.search(code):
+            code = code.replace("template <typename Scalar>\n", "template <typename Scalar, typename MatrixP>\n")
+            code = covariance_arg.sub("const MatrixP& P", code)
+            file.seek(0)
+            file.write(code)
+            file.truncate()
+
 def generate_python_function(function_name, output_names):
     from symforce.codegen import Codegen, PythonConfig
     codegen = Codegen.function(
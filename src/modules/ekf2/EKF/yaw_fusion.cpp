@@ -57,16 +57,8 @@ bool Ekf::fuseYaw(estimator_aid_source1d_s &aid_src_status, const VectorState &H
 
 	// calculate the Kalman gains
 	// only calculate gains for states we are using
-	VectorState Kfusion;
-	const float heading_innov_var_inv = 1.f / aid_src_status.innovation_variance;
-
-	for (uint8_t row = 0; row < State::size; row++) {
-		for (uint8_t col = 0; col <= 3; col++) {
-			Kfusion(row) += P(row, col) * H_YAW(col);
-		}
-
-		Kfusion(row) *= heading_innov_var_inv;
-	}
+	const SparseHAttitude H_sparse(H_YAW);
+	VectorState Kfusion = P * H_sparse / aid_src_status.innovation_variance;
 
 	// set the heading unhealthy if the test fails
 	if (aid_src_status.innovation_rejected) {
@@ -98,7 +90,7 @@ bool Ekf::fuseYaw(estimator_aid_source1d_s &aid_src_status, const VectorState &H
 		_innov_check_fail_status.flags.reject_yaw = false;
 	}
 
-	if (measurementUpdate(Kfusion, H_YAW, aid_src_status.observation_variance, aid_src_status.innovation)) {
+	if (measurementUpdate(Kfusion, H_sparse, aid_src_status.observation_variance, aid_src_status.innovation)) {
 
 		_time_last_heading_fuse = _time_delayed_us;
 
@@ -220,6 +220,10 @@ EKF2::~EKF2()
 {
 	perf_free(_ekf_update_perf);
 	perf_free(_msg_missed_imu_perf);
+
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	EKF2ImuDownSampler::release(_imu_down_sampler);
+#endif // CONFIG_EKF2_MULTI_INSTANCE
 }
 
 void EKF2::AdvertiseTopics()
@@ -378,10 +382,14 @@ void EKF2::AdvertiseTopics()
 }
 
 #if defined(CONFIG_EKF2_MULTI_INSTANCE)
-bool EKF2::multi_init(int imu, int mag)
+bool EKF2::multi_init(int imu, int mag, bool share_imu_down_sampling)
 {
 	bool changed_instance = _vehicle_imu_sub.ChangeInstance(imu);
 
+	if (share_imu_down_sampling && (_imu_down_sampler == nullptr)) {
+		_imu_down_sampler = EKF2ImuDownSampler::acquire(imu);
+	}
+
 #if defined(CONFIG_EKF2_MAGNETOMETER)
 
 	if (!_magnetometer_sub.ChangeInstance(mag)) {
@@ -710,7 +718,34 @@ void EKF2::Run()
 		const hrt_abstime now = imu_sample_new.time_us;
 
 		// push imu data into estimator
-		_ekf.setIMUData(imu_sample_new);
+		bool imu_pushed = false;
+
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+
+		if (_imu_down_sampler) {
+			imuSample imu_downsampled{};
+			const EKF2ImuDownSampler::Result result = _imu_down_sampler->update(imu_sample_new,
+					_param_ekf2_predict_us.get(), _time_last_imu_downsampled_us, imu_downsampled);
+
+			if (result == EKF2ImuDownSampler::Result::LAGGING) {
+				// this instance fell too far behind the others, down-sample on its own from now on
+				PX4_WARN("%d - shared IMU down-sampling lagging, using own", _instance);
+				EKF2ImuDownSampler::release(_imu_down_sampler);
+				_imu_down_sampler = nullptr;
+
+			} else {
+				const bool downsampled = (result == EKF2ImuDownSampler::Result::SAMPLE);
+				_ekf.setIMUData(imu_sample_new, downsampled ? &imu_downsampled : nullptr);
+				imu_pushed = true;
+			}
+		}
+
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
+		if (!imu_pushed) {
+			_ekf.setIMUData(imu_sample_new);
+		}
+
 		PublishAttitude(now); // publish attitude immediately (uses quaternion from output predictor)
 
 		// integrate time to monitor time slippage
@@ -2800,6 +2835,11 @@ int EKF2::task_spawn(int argc, char *argv[])
 		const int multi_instances = math::min(imu_instances * mag_instances, static_cast<int32_t>(EKF2_MAX_INSTANCES));
 		int multi_instances_allocated = 0;
 
+		// instances either share the work queue of their IMU (and its down-sampling) or each get their own
+		int32_t multi_wq_mode = 0;
+		param_get(param_find("EKF2_MULTI_WQ"), &multi_wq_mode);
+		const bool wq_per_instance = (multi_wq_mode == 1);
+
 		// allocate EKF2 instances until all found or arming
 		uORB::SubscriptionData<vehicle_status_s> vehicle_status_sub{ORB_ID(vehicle_status)};
 
@@ -2824,9 +2864,13 @@ int EKF2::task_spawn(int argc, char *argv[])
 					if ((vehicle_mag_sub.advertised() || mag == 0) && (vehicle_imu_sub.advertised())) {
 
 						if (!ekf2_instance_created[imu][mag]) {
-							EKF2 *ekf2_inst = new EKF2(true, px4::ins_instance_to_wq(imu), false);
+							const px4::wq_config_t &wq_config = wq_per_instance
+											    ? px4::estimator_instance_to_wq(multi_instances_allocated)
+											    : px4::ins_instance_to_wq(imu);
+
+							EKF2 *ekf2_inst = new EKF2(true, wq_config, false);
 
-							if (ekf2_inst && ekf2_inst->multi_init(imu, mag)) {
+							if (ekf2_inst && ekf2_inst->multi_init(imu, mag, !wq_per_instance)) {
 								int actual_instance = ekf2_inst->instance(); // match uORB instance numbering
 
 								if ((actual_instance >= 0) && (_objects[actual_instance].load() == nullptr)) {
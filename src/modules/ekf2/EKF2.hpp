@@ -46,6 +46,10 @@
 
 #include "EKF2Selector.hpp"
 
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+# include "EKF2ImuDownSampler.hpp"
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
 #include <float.h>
 
 #include <containers/LockGuard.hpp>
@@ -151,7 +155,7 @@ public:
 	static void unlock_module() { pthread_mutex_unlock(&ekf2_module_mutex); }
 
 #if defined(CONFIG_EKF2_MULTI_INSTANCE)
-	bool multi_init(int imu, int mag);
+	bool multi_init(int imu, int mag, bool share_imu_down_sampling);
 #endif // CONFIG_EKF2_MULTI_INSTANCE
 
 	int instance() const { return _instance; }
@@ -396,6 +400,12 @@ private:
 	uORB::SubscriptionCallbackWorkItem _sensor_combined_sub{this, ORB_ID(sensor_combined)};
 	uORB::SubscriptionCallbackWorkItem _vehicle_imu_sub{this, ORB_ID(vehicle_imu)};
 
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	// IMU down-sampling shared with the other instances using the same vehicle_imu
+	EKF2ImuDownSampler *_imu_down_sampler{nullptr};
+	uint64_t _time_last_imu_downsampled_us{0};
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
 #if defined(CONFIG_EKF2_RANGE_FINDER)
 	hrt_abstime _status_rng_hgt_pub_last {0};
 
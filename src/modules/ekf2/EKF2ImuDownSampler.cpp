@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "EKF2ImuDownSampler.hpp"
+
+pthread_mutex_t EKF2ImuDownSampler::_mutex = PTHREAD_MUTEX_INITIALIZER;
+EKF2ImuDownSampler *EKF2ImuDownSampler::_instances[MAX_NUM_IMUS] {};
+
+EKF2ImuDownSampler *EKF2ImuDownSampler::acquire(uint8_t imu_instance)
+{
+	if (imu_instance >= MAX_NUM_IMUS) {
+		return nullptr;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	if (_instances[imu_instance] == nullptr) {
+		_instances[imu_instance] = new EKF2ImuDownSampler();
+	}
+
+	EKF2ImuDownSampler *down_sampler = _instances[imu_instance];
+
+	if (down_sampler) {
+		down_sampler->_users++;
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	return down_sampler;
+}
+
+void EKF2ImuDownSampler::release(EKF2ImuDownSampler *down_sampler)
+{
+	if (down_sampler == nullptr) {
+		return;
+	}
+
+	pthread_mutex_lock(&_mutex);
+
+	if (--down_sampler->_users <= 0) {
+		for (auto &instance : _instances) {
+			if (instance == down_sampler) {
+				instance = nullptr;
+			}
+		}
+
+		delete down_sampler;
+	}
+
+	pthread_mutex_unlock(&_mutex);
+}
+
+EKF2ImuDownSampler::Result EKF2ImuDownSampler::update(const imuSample &imu_sample, int32_t target_dt_us,
+		uint64_t &time_last_downsampled_us, imuSample &imu_downsampled)
+{
+	// time going backwards by more than any instance can lag behind (e.g. replay restart), start over
+	if (imu_sample.time_us + (uint64_t)1e6 < _time_last_imu_us) {
+		_time_last_imu_us = 0;
+		_time_overwritten_us = 0;
+		_imu_downsampled.reset();
+		_down_sampler.getDownSampledImuAndTriggerReset();
+	}
+
+	if (time_last_downsampled_us > imu_sample.time_us) {
+		time_last_downsampled_us = 0;
+	}
+
+	// the first instance to see a new sample runs the down-sampler
+	if (imu_sample.time_us > _time_last_imu_us) {
+		_time_last_imu_us = imu_sample.time_us;
+		_target_dt_us = target_dt_us;
+
+		if (_down_sampler.update(imu_sample)) {
+			if (_imu_downsampled.entries() == _imu_downsampled.get_length()) {
+				_time_overwritten_us = _imu_downsampled.get_oldest().time_us;
+			}
+
+			_imu_downsampled.push(_down_sampler.getDownSampledImuAndTriggerReset());
+		}
+	}
+
+	// a sample this instance never received is gone
+	if ((time_last_downsampled_us != 0) && (_time_overwritten_us > time_last_downsampled_us)) {
+		return Result::LAGGING;
+	}
+
+	// hand out every down-sampled sample once to each instance, oldest first, but not before the instance reached it
+	const uint8_t oldest_index = _imu_downsampled.get_oldest_index();
+	int next_index = -1;
+
+	for (uint8_t i = 0; i < _imu_downsampled.get_length(); i++) {
+		const uint8_t index = (oldest_index + i) % _imu_downsampled.get_length();
+		const uint64_t time_us = _imu_downsampled[index].time_us;
+
+		if ((time_us > time_last_downsampled_us) && (time_us <= imu_sample.time_us)) {
+			next_index = index;
+
+			// a new instance only starts from the latest sample
+			if (time_last_downsampled_us != 0) {
+				break;
+			}
+		}
+	}
+
+	if (next_index >= 0) {
+		imu_downsampled = _imu_downsampled[next_index];
+		time_last_downsampled_us = imu_downsampled.time_us;
+		return Result::SAMPLE;
+	}
+
+	return Result::NONE;
+}
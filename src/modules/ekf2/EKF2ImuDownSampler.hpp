@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file EKF2ImuDownSampler.hpp
+ *
+ * IMU down-sampling shared by all the EKF2 instances consuming the same vehicle_imu instance.
+ * In multi-instance mode every IMU can feed up to one instance per magnetometer, and instead of
+ * each of them accumulating the same samples, the first instance seeing a new sample runs the
+ * down-sampler and the others reuse its output.
+ *
+ * All the instances using the same IMU run on the same work queue (see px4::ins_instance_to_wq),
+ * so update() is never called concurrently for a given IMU. They can however be a few samples apart,
+ * so the latest down-sampled samples are kept until every instance had the chance to consume them.
+ */
+
+#pragma once
+
+#include <pthread.h>
+
+#include "EKF/RingBuffer.h"
+#include "EKF/imu_down_sampler/imu_down_sampler.hpp"
+
+class EKF2ImuDownSampler
+{
+public:
+	static constexpr uint8_t MAX_NUM_IMUS = 4;
+
+	// number of down-sampled samples kept for instances lagging behind the first one
+	static constexpr uint8_t DOWNSAMPLED_QUEUE_LEN = 8;
+
+	enum class Result : uint8_t {
+		NONE,    // no down-sampled sample for the caller yet
+		SAMPLE,  // next down-sampled sample returned
+		LAGGING, // the caller fell behind by more than DOWNSAMPLED_QUEUE_LEN samples, at least one was lost
+	};
+
+	/**
+	 * Get the down-sampler of an IMU, allocated on first use.
+	 * Every successful acquire() must be matched by a release().
+	 */
+	static EKF2ImuDownSampler *acquire(uint8_t imu_instance);
+	static void release(EKF2ImuDownSampler *down_sampler);
+
+	/**
+	 * Process a new sample of this IMU.
+	 *
+	 * @param imu_sample latest IMU sample
+	 * @param target_dt_us target down-sampled integration period (EKF2_PREDICT_US)
+	 * @param time_last_downsampled_us time of the last down-sampled sample returned to the caller, updated
+	 * @param imu_downsampled oldest down-sampled sample not consumed by the caller yet, Result::SAMPLE only
+	 */
+	Result update(const imuSample &imu_sample, int32_t target_dt_us, uint64_t &time_last_downsampled_us,
+		      imuSample &imu_downsampled);
+
+private:
+	EKF2ImuDownSampler() = default;
+	~EKF2ImuDownSampler() = default;
+
+	static pthread_mutex_t _mutex;
+	static EKF2ImuDownSampler *_instances[MAX_NUM_IMUS];
+
+	int _users{0};
+
+	int32_t _target_dt_us{10000};
+	ImuDownSampler _down_sampler{_target_dt_us};
+
+	uint64_t _time_last_imu_us{0};
+
+	RingBuffer<imuSample> _imu_downsampled{DOWNSAMPLED_QUEUE_LEN};
+	uint64_t _time_overwritten_us{0}; // newest down-sampled sample dropped from the queue
+};
@@ -709,6 +709,14 @@ void EKF2Selector::Run()
 		updateParams();
 	}
 
+	const uint8_t selected_instance_start = _selected_instance;
+
+	// republish the selected estimator data for the system before evaluating all the instances,
+	// so the latency of the handoff doesn't depend on the number of instances
+	if (_selected_instance != INVALID_INSTANCE) {
+		PublishSelectedEstimatorData();
+	}
+
 	// update combined test ratio for all estimators
 	const bool updated = UpdateErrorScores();
 
@@ -821,15 +829,22 @@ void EKF2Selector::Run()
 		}
 	}
 
-	// republish selected estimator data for system
+	// the first selection or an instance change happened during this run
+	if (_selected_instance != selected_instance_start) {
+		PublishSelectedEstimatorData();
+	}
+
+	// re-schedule as backup timeout
+	ScheduleDelayed(FILTER_UPDATE_PERIOD);
+}
+
+void EKF2Selector::PublishSelectedEstimatorData()
+{
 	PublishVehicleAttitude();
 	PublishVehicleLocalPosition();
 	PublishVehicleGlobalPosition();
 	PublishVehicleOdometry();
 	PublishWindEstimate();
-
-	// re-schedule as backup timeout
-	ScheduleDelayed(FILTER_UPDATE_PERIOD);
 }
 
 void EKF2Selector::PublishEstimatorSelectorStatus()
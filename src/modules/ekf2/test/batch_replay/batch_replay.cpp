@@ -0,0 +1,248 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Replay the estimator inputs of many ULog files in parallel, each with its own Ekf instance,
+ * and print a CSV summary of the innovations and test ratios of each log.
+ *
+ * Usage: ekf2_batch_replay [-j <threads>] [-o <summary.csv>] [-p <EKF2_PARAM>=<value>]... <file.ulg>...
+ *
+ * The logs must be recorded with the estimator replay logging profile (SDLOG_PROFILE), other logs are
+ * reported as failed and left out of the summary.
+ * The EKF2_* parameters are taken from the log, -p overrides them for all logs.
+ * The filter prints its status messages to stdout, use -o to keep them out of the summary.
+ */
+
+#include <atomic>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+#include "ekf_log_replay.h"
+
+namespace
+{
+
+struct Result {
+	bool success{false};
+	std::string error;
+	EkfLogReplay::Summary summary{};
+};
+
+void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-j <threads>] [-o <summary.csv>] [-p <EKF2_PARAM>=<value>]... <file.ulg>...\n",
+		name);
+	fprintf(stderr, "  -j <threads>       number of logs replayed in parallel (default: number of CPUs)\n");
+	fprintf(stderr, "  -o <summary.csv>   write the summary to a file instead of stdout\n");
+	fprintf(stderr, "  -p <name>=<value>  override a parameter of the logs\n");
+}
+
+bool parseParameter(const char *arg, std::map<std::string, double> &params)
+{
+	const char *separator = strchr(arg, '=');
+
+	if (!separator || (separator == arg)) {
+		return false;
+	}
+
+	const std::string name(arg, separator - arg);
+	char *end = nullptr;
+	const double value = strtod(separator + 1, &end);
+
+	if (end == separator + 1 || *end != '\0') {
+		return false;
+	}
+
+	for (const std::string &known : EkfLogReplay::parameterNames()) {
+		if (known == name) {
+			params[name] = value;
+			return true;
+		}
+	}
+
+	fprintf(stderr, "unsupported parameter %s\n", name.c_str());
+	return false;
+}
+
+void printHeader(FILE *out)
+{
+	fprintf(out, "log,duration_s,imu_samples,filter_updates,tilt_align_s");
+
+	for (const char *name : {"vel", "hpos", "vpos", "heading", "airspeed"}) {
+		fprintf(out, ",%s_test_ratio_mean,%s_test_ratio_max", name, name);
+	}
+
+	for (const char *name : {"gnss_vel", "gnss_pos", "gnss_hgt", "baro_hgt", "mag", "airspeed"}) {
+		fprintf(out, ",%s_samples,%s_innov_rms,%s_rejected", name, name, name);
+	}
+
+	fprintf(out, ",quat_resets,vel_resets,pos_resets\n");
+}
+
+void printResult(FILE *out, const char *file_name, const EkfLogReplay::Summary &summary)
+{
+	fprintf(out, "%s,%.1f,%" PRIu32 ",%" PRIu32 ",%.2f", file_name, (double)summary.duration_s, summary.imu_samples,
+		summary.filter_updates, (double)summary.tilt_align_time_s);
+
+	for (const EkfLogReplay::TestRatioStatistics *test_ratio : {
+		     &summary.vel_test_ratio, &summary.hpos_test_ratio, &summary.vpos_test_ratio,
+		     &summary.heading_test_ratio, &summary.airspeed_test_ratio
+	     }) {
+		fprintf(out, ",%.3f,%.3f", (double)test_ratio->mean(), (double)test_ratio->max);
+	}
+
+	for (const EkfLogReplay::AidSourceStatistics *aid_src : {
+		     &summary.gnss_vel, &summary.gnss_pos, &summary.gnss_hgt,
+		     &summary.baro_hgt, &summary.mag, &summary.airspeed
+	     }) {
+		fprintf(out, ",%" PRIu32 ",%.4f,%.3f", aid_src->samples, (double)aid_src->innovationRms(),
+			(double)aid_src->rejectedRatio());
+	}
+
+	fprintf(out, ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n", summary.quat_resets, summary.vel_resets,
+		summary.pos_resets);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	unsigned num_threads = std::thread::hardware_concurrency();
+	const char *output_file = nullptr;
+	std::map<std::string, double> param_overrides;
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "j:o:p:h")) != -1) {
+		switch (ch) {
+		case 'j':
+			num_threads = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'o':
+			output_file = optarg;
+			break;
+
+		case 'p':
+			if (!parseParameter(optarg, param_overrides)) {
+				usage(argv[0]);
+				return 1;
+			}
+
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	FILE *out = stdout;
+
+	if (output_file) {
+		out = fopen(output_file, "w");
+
+		if (!out) {
+			fprintf(stderr, "failed to open %s\n", output_file);
+			return 1;
+		}
+	}
+
+	const std::vector<std::string> files(argv + optind, argv + argc);
+	std::vector<Result> results(files.size());
+
+	// every worker takes the next log until all are done, the logs are independent
+	std::atomic<size_t> next_file{0};
+
+	auto worker = [&]() {
+		size_t index;
+
+		while ((index = next_file.fetch_add(1)) < files.size()) {
+			EkfLogReplay replay(files[index], param_overrides);
+			Result &result = results[index];
+
+			result.success = replay.run();
+			result.error = replay.error();
+			result.summary = replay.summary();
+		}
+	};
+
+	if (num_threads == 0) {
+		num_threads = 1;
+	}
+
+	if (num_threads > files.size()) {
+		num_threads = files.size();
+	}
+
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < num_threads; i++) {
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	printHeader(out);
+
+	int failed = 0;
+
+	for (size_t i = 0; i < files.size(); i++) {
+		if (results[i].success) {
+			printResult(out, files[i].c_str(), results[i].summary);
+
+		} else {
+			fprintf(stderr, "%s: %s\n", files[i].c_str(), results[i].error.c_str());
+			failed++;
+		}
+	}
+
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,916 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ekf_log_replay.h"
+
+#include <string.h>
+
+#include <uORB/topics/sensor_combined.h>
+#include <uORB/topics/sensor_gps.h>
+#include <uORB/topics/vehicle_status.h>
+
+namespace
+{
+
+float squaredNorm(float innovation)
+{
+	return innovation * innovation;
+}
+
+template<size_t N>
+float squaredNorm(const float (&innovation)[N])
+{
+	float sum = 0.f;
+
+	for (float value : innovation) {
+		sum += value * value;
+	}
+
+	return sum;
+}
+
+} // namespace
+
+void EkfLogReplay::TestRatioStatistics::update(float test_ratio)
+{
+	if (!PX4_ISFINITE(test_ratio)) {
+		return;
+	}
+
+	count++;
+	sum += test_ratio;
+
+	if (!(max >= test_ratio)) {
+		max = test_ratio;
+	}
+}
+
+template<typename T>
+void EkfLogReplay::AidSourceStatistics::update(const T &aid_src)
+{
+	// the aid source status persists between measurements, count each one once
+	if ((aid_src.timestamp_sample == 0) || (aid_src.timestamp_sample == last_timestamp_sample)
+	    || !(aid_src.fused || aid_src.innovation_rejected)) {
+		return;
+	}
+
+	last_timestamp_sample = aid_src.timestamp_sample;
+
+	const float innovation_sq = squaredNorm(aid_src.innovation);
+
+	if (!PX4_ISFINITE(innovation_sq)) {
+		return;
+	}
+
+	samples++;
+	innovation_sum_sq += innovation_sq;
+
+	if (aid_src.innovation_rejected) {
+		rejected++;
+	}
+}
+
+EkfLogReplay::EkfLogReplay(const std::string &file_name, const std::map<std::string, double> &param_overrides) :
+	_file_name(file_name),
+	_param_overrides(param_overrides),
+	_ekf(new Ekf())
+{
+}
+
+std::vector<EkfLogReplay::ParameterBinding>
+EkfLogReplay::bindParameters(parameters &params, float &gps_health_time_s)
+{
+	std::vector<ParameterBinding> bindings;
+
+	auto bind = [&bindings](const char *name, float & value) { bindings.push_back({name, &value, nullptr}); };
+	auto bind_int = [&bindings](const char *name, int32_t &value) { bindings.push_back({name, nullptr, &value}); };
+
+	// same mapping as the EKF2 module
+	bind_int("EKF2_PREDICT_US", params.filter_update_interval_us);
+	bind("EKF2_DELAY_MAX", params.delay_max_ms);
+	bind_int("EKF2_IMU_CTRL", params.imu_ctrl);
+	bind("EKF2_GYR_NOISE", params.gyro_noise);
+	bind("EKF2_ACC_NOISE", params.accel_noise);
+	bind("EKF2_GYR_B_NOISE", params.gyro_bias_p_noise);
+	bind("EKF2_ACC_B_NOISE", params.accel_bias_p_noise);
+#if defined(CONFIG_EKF2_WIND)
+	bind("EKF2_WIND_NSD", params.wind_vel_nsd);
+#endif // CONFIG_EKF2_WIND
+	bind("EKF2_NOAID_NOISE", params.pos_noaid_noise);
+#if defined(CONFIG_EKF2_GNSS)
+	bind_int("EKF2_GPS_CTRL", params.gnss_ctrl);
+	bind("EKF2_GPS_DELAY", params.gps_delay_ms);
+	bind("EKF2_GPS_POS_X", params.gps_pos_body(0));
+	bind("EKF2_GPS_POS_Y", params.gps_pos_body(1));
+	bind("EKF2_GPS_POS_Z", params.gps_pos_body(2));
+	bind("EKF2_GPS_V_NOISE", params.gps_vel_noise);
+	bind("EKF2_GPS_P_NOISE", params.gps_pos_noise);
+	bind("EKF2_GPS_P_GATE", params.gps_pos_innov_gate);
+	bind("EKF2_GPS_V_GATE", params.gps_vel_innov_gate);
+	bind_int("EKF2_GPS_CHECK", params.gps_check_mask);
+	bind("EKF2_REQ_EPH", params.req_hacc);
+	bind("EKF2_REQ_EPV", params.req_vacc);
+	bind("EKF2_REQ_SACC", params.req_sacc);
+	bind_int("EKF2_REQ_NSATS", params.req_nsats);
+	bind("EKF2_REQ_PDOP", params.req_pdop);
+	bind("EKF2_REQ_HDRIFT", params.req_hdrift);
+	bind("EKF2_REQ_VDRIFT", params.req_vdrift);
+	bind("EKF2_REQ_GPS_H", gps_health_time_s);
+	bind("EKF2_GSF_TAS", params.EKFGSF_tas_default);
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_BAROMETER)
+	bind_int("EKF2_BARO_CTRL", params.baro_ctrl);
+	bind("EKF2_BARO_DELAY", params.baro_delay_ms);
+	bind("EKF2_BARO_NOISE", params.baro_noise);
+	bind("EKF2_BARO_GATE", params.baro_innov_gate);
+	bind("EKF2_GND_EFF_DZ", params.gnd_effect_deadzone);
+	bind("EKF2_GND_MAX_HGT", params.gnd_effect_max_hgt);
+# if defined(CONFIG_EKF2_BARO_COMPENSATION)
+	bind("EKF2_ASPD_MAX", params.max_correction_airspeed);
+	bind("EKF2_PCOEF_XP", params.static_pressure_coef_xp);
+	bind("EKF2_PCOEF_XN", params.static_pressure_coef_xn);
+	bind("EKF2_PCOEF_YP", params.static_pressure_coef_yp);
+	bind("EKF2_PCOEF_YN", params.static_pressure_coef_yn);
+	bind("EKF2_PCOEF_Z", params.static_pressure_coef_z);
+# endif // CONFIG_EKF2_BARO_COMPENSATION
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+	bind("EKF2_ASP_DELAY", params.airspeed_delay_ms);
+	bind("EKF2_TAS_GATE", params.tas_innov_gate);
+	bind("EKF2_EAS_NOISE", params.eas_noise);
+	bind("EKF2_ARSP_THR", params.arsp_thr);
+#endif // CONFIG_EKF2_AIRSPEED
+#if defined(CONFIG_EKF2_SIDESLIP)
+	bind("EKF2_BETA_GATE", params.beta_innov_gate);
+	bind("EKF2_BETA_NOISE", params.beta_noise);
+	bind_int("EKF2_FUSE_BETA", params.beta_fusion_enabled);
+#endif // CONFIG_EKF2_SIDESLIP
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	bind("EKF2_MAG_DELAY", params.mag_delay_ms);
+	bind("EKF2_MAG_E_NOISE", params.mage_p_noise);
+	bind("EKF2_MAG_B_NOISE", params.magb_p_noise);
+	bind("EKF2_HEAD_NOISE", params.mag_heading_noise);
+	bind("EKF2_MAG_NOISE", params.mag_noise);
+	bind("EKF2_MAG_DECL", params.mag_declination_deg);
+	bind("EKF2_HDG_GATE", params.heading_innov_gate);
+	bind("EKF2_MAG_GATE", params.mag_innov_gate);
+	bind_int("EKF2_DECL_TYPE", params.mag_declination_source);
+	bind_int("EKF2_MAG_TYPE", params.mag_fusion_type);
+	bind("EKF2_MAG_ACCLIM", params.mag_acc_gate);
+	bind_int("EKF2_MAG_CHECK", params.mag_check);
+	bind("EKF2_MAG_CHK_STR", params.mag_check_strength_tolerance_gs);
+	bind("EKF2_MAG_CHK_INC", params.mag_check_inclination_tolerance_deg);
+	bind_int("EKF2_SYNT_MAG_Z", params.synthesize_mag_z);
+#endif // CONFIG_EKF2_MAGNETOMETER
+	bind_int("EKF2_HGT_REF", params.height_sensor_ref);
+	bind_int("EKF2_NOAID_TOUT", params.valid_timeout_max);
+#if defined(CONFIG_EKF2_TERRAIN) || defined(CONFIG_EKF2_OPTICAL_FLOW) || defined(CONFIG_EKF2_RANGE_FINDER)
+	bind("EKF2_MIN_RNG", params.rng_gnd_clearance);
+#endif // CONFIG_EKF2_TERRAIN || CONFIG_EKF2_OPTICAL_FLOW || CONFIG_EKF2_RANGE_FINDER
+#if defined(CONFIG_EKF2_TERRAIN)
+	bind("EKF2_TERR_NOISE", params.terrain_p_noise);
+	bind("EKF2_TERR_GRAD", params.terrain_gradient);
+#endif // CONFIG_EKF2_TERRAIN
+#if defined(CONFIG_EKF2_DRAG_FUSION)
+	bind_int("EKF2_DRAG_CTRL", params.drag_ctrl);
+	bind("EKF2_DRAG_NOISE", params.drag_noise);
+	bind("EKF2_BCOEF_X", params.bcoef_x);
+	bind("EKF2_BCOEF_Y", params.bcoef_y);
+	bind("EKF2_MCOEF", params.mcoef);
+#endif // CONFIG_EKF2_DRAG_FUSION
+#if defined(CONFIG_EKF2_GRAVITY_FUSION)
+	bind("EKF2_GRAV_NOISE", params.gravity_noise);
+#endif // CONFIG_EKF2_GRAVITY_FUSION
+	bind("EKF2_IMU_POS_X", params.imu_pos_body(0));
+	bind("EKF2_IMU_POS_Y", params.imu_pos_body(1));
+	bind("EKF2_IMU_POS_Z", params.imu_pos_body(2));
+	bind("EKF2_GBIAS_INIT", params.switch_on_gyro_bias);
+	bind("EKF2_ABIAS_INIT", params.switch_on_accel_bias);
+	bind("EKF2_ANGERR_INIT", params.initial_tilt_err);
+	bind("EKF2_ABL_LIM", params.acc_bias_lim);
+	bind("EKF2_ABL_ACCLIM", params.acc_bias_learn_acc_lim);
+	bind("EKF2_ABL_GYRLIM", params.acc_bias_learn_gyr_lim);
+	bind("EKF2_ABL_TAU", params.acc_bias_learn_tc);
+	bind("EKF2_GYR_B_LIM", params.gyro_bias_lim);
+
+	return bindings;
+}
+
+std::vector<std::string> EkfLogReplay::parameterNames()
+{
+	parameters params{};
+	float gps_health_time_s = 0.f;
+	std::vector<std::string> names;
+
+	for (const ParameterBinding &binding : bindParameters(params, gps_health_time_s)) {
+		names.push_back(binding.name);
+	}
+
+	return names;
+}
+
+bool EkfLogReplay::run()
+{
+	// log reader assumes little endian, like replay
+	int num = 1;
+
+	if (*(char *)&num != 1) {
+		_error = "only little endian is supported";
+		return false;
+	}
+
+	if (!_file.open(_file_name.c_str())) {
+		_error = "failed to open file";
+		return false;
+	}
+
+	if (!readDefinitions()) {
+		return false;
+	}
+
+	_file.buildIndex(_data_section_start, _read_until_file_position);
+	readSubscriptions();
+
+	// other logging profiles record the estimator inputs at reduced rates, which would not give representative
+	// results (replay requires ekf2_timestamps for the same reason)
+	if (!_ekf2_timestamps.valid()) {
+		_error = "not logged with the estimator replay profile (no ekf2_timestamps)";
+		return false;
+	}
+
+	if (!_sensor_combined.valid() || (_sensor_combined.size == 0)) {
+		_error = "no sensor_combined data";
+		return false;
+	}
+
+	applyParameters();
+
+	Topic *inputs[] {
+		&_vehicle_status,
+		&_vehicle_land_detected,
+		&_vehicle_air_data,
+		&_vehicle_magnetometer,
+		&_vehicle_gps_position,
+		&_airspeed_validated,
+	};
+
+	const size_t imu_messages = _file.dataMessages(_sensor_combined.msg_id).size();
+
+	for (size_t i = 0; i < imu_messages; i++) {
+		const uint8_t *data = topicData(_sensor_combined, i);
+
+		if (!data) {
+			continue;
+		}
+
+		imuSample imu_sample{};
+		imu_sample.time_us = _sensor_combined.timestamp.get<uint64_t>(data);
+
+		if (imu_sample.time_us == 0) {
+			continue;
+		}
+
+		const auto &fields = _sensor_combined_fields;
+		imu_sample.delta_ang_dt = fields.gyro_integral_dt.get<uint32_t>(data) * 1.e-6f;
+		imu_sample.delta_ang = fields.gyro_rad.getVector3f(data) * imu_sample.delta_ang_dt;
+		imu_sample.delta_vel_dt = fields.accelerometer_integral_dt.get<uint32_t>(data) * 1.e-6f;
+		imu_sample.delta_vel = fields.accelerometer_m_s2.getVector3f(data) * imu_sample.delta_vel_dt;
+
+		const uint8_t clipping = fields.accelerometer_clipping.get<uint8_t>(data);
+		imu_sample.delta_vel_clipping[0] = clipping & sensor_combined_s::CLIPPING_X;
+		imu_sample.delta_vel_clipping[1] = clipping & sensor_combined_s::CLIPPING_Y;
+		imu_sample.delta_vel_clipping[2] = clipping & sensor_combined_s::CLIPPING_Z;
+
+		_ekf->setIMUData(imu_sample);
+
+		// the other inputs as ekf2 sees them when it runs on this IMU sample
+		for (Topic *topic : inputs) {
+			if (!topic->valid() || (topic->size == 0)) {
+				continue;
+			}
+
+			const size_t count = _file.dataMessages(topic->msg_id).size();
+
+			while ((topic->next_index < count)
+			       && (topicTimestamp(*topic, topic->next_index) <= imu_sample.time_us)) {
+
+				const uint8_t *topic_data = topicData(*topic, topic->next_index);
+
+				if (topic_data) {
+					handleTopic(*topic, topic_data);
+				}
+
+				topic->next_index++;
+			}
+		}
+
+		updateSystemFlags(imu_sample.time_us);
+
+		if (_start_time == 0) {
+			_start_time = imu_sample.time_us;
+		}
+
+		_summary.imu_samples++;
+		_summary.duration_s = (imu_sample.time_us - _start_time) * 1.e-6f;
+
+		if (_ekf->update()) {
+			_summary.filter_updates++;
+			updateSummary(imu_sample.time_us);
+		}
+	}
+
+	return true;
+}
+
+bool EkfLogReplay::readDefinitions()
+{
+	ulog_file_header_s file_header;
+
+	if (_file.size() < sizeof(file_header)) {
+		_error = "not a ULog file";
+		return false;
+	}
+
+	memcpy(&file_header, _file.data(), sizeof(file_header));
+
+	const char magic[] = {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35};
+
+	if (memcmp(magic, file_header.magic, sizeof(magic)) != 0) {
+		_error = "not a ULog file";
+		return false;
+	}
+
+	ulog_message_header_s message_header;
+	uint64_t offset = sizeof(ulog_file_header_s);
+
+	while (true) {
+		const uint8_t *message = _file.message(offset, message_header);
+
+		if (!message) {
+			_error = "truncated definitions section";
+			return false;
+		}
+
+		switch (message_header.msg_type) {
+		case (int)ULogMessageType::FLAG_BITS:
+			if (!readFlagBits(message, message_header.msg_size)) {
+				return false;
+			}
+
+			break;
+
+		case (int)ULogMessageType::FORMAT:
+			readFormat(message, message_header.msg_size);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+			readParameter(message, message_header.msg_size);
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			_data_section_start = offset;
+			return true;
+
+		default:
+			break;
+		}
+
+		offset += ULOG_MSG_HEADER_LEN + message_header.msg_size;
+	}
+}
+
+bool EkfLogReplay::readFlagBits(const uint8_t *message, uint16_t msg_size)
+{
+	if (msg_size != 40) {
+		_error = "unsupported FLAG_BITS message length";
+		return false;
+	}
+
+	const uint8_t *incompat_flags = message + 8;
+
+	for (int i = 0; i < 8; ++i) {
+		const uint8_t known = (i == 0) ? ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK : 0;
+
+		if (incompat_flags[i] & ~known) {
+			_error = "unknown incompat flag bits";
+			return false;
+		}
+	}
+
+	if (incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK) {
+		uint64_t appended_offsets[3];
+		memcpy(appended_offsets, message + 16, sizeof(appended_offsets));
+
+		if (appended_offsets[0] > 0) {
+			_read_until_file_position = appended_offsets[0];
+		}
+	}
+
+	return true;
+}
+
+void EkfLogReplay::readFormat(const uint8_t *message, uint16_t msg_size)
+{
+	const std::string format((const char *)message, msg_size);
+	const size_t pos = format.find(':');
+
+	if (pos != std::string::npos) {
+		_formats[format.substr(0, pos)] = format.substr(pos + 1);
+	}
+}
+
+void EkfLogReplay::readParameter(const uint8_t *message, uint16_t msg_size)
+{
+	if (msg_size < 1) {
+		return;
+	}
+
+	const uint8_t key_len = message[0];
+
+	if (msg_size < 1 + key_len + 4) {
+		return;
+	}
+
+	const std::string key((const char *)message + 1, key_len);
+	const size_t pos = key.find(' ');
+
+	if (pos == std::string::npos) {
+		return;
+	}
+
+	const std::string type = key.substr(0, pos);
+	const std::string name = key.substr(pos + 1);
+
+	if (type == "int32_t") {
+		int32_t value;
+		memcpy(&value, message + 1 + key_len, sizeof(value));
+		_log_params[name] = value;
+
+	} else if (type == "float") {
+		float value;
+		memcpy(&value, message + 1 + key_len, sizeof(value));
+		_log_params[name] = value;
+	}
+}
+
+void EkfLogReplay::readSubscriptions()
+{
+	Topic *topics[] {
+		&_ekf2_timestamps,
+		&_sensor_combined,
+		&_vehicle_air_data,
+		&_vehicle_magnetometer,
+		&_vehicle_gps_position,
+		&_airspeed_validated,
+		&_vehicle_status,
+		&_vehicle_land_detected,
+	};
+
+	ulog_message_header_s header;
+
+	for (uint64_t offset : _file.subscriptionMessages()) {
+		const uint8_t *message = _file.message(offset, header);
+
+		if (!message || (header.msg_size <= 3)) {
+			continue;
+		}
+
+		const uint8_t multi_id = message[0];
+		uint16_t msg_id;
+		memcpy(&msg_id, message + 1, sizeof(msg_id));
+		const std::string topic_name((const char *)message + 3, header.msg_size - 3);
+
+		for (Topic *topic : topics) {
+			if ((multi_id == 0) && !topic->valid() && (topic_name == topic->name)) {
+				topic->msg_id = msg_id;
+				topic->size = sizeOfFormat(topic_name);
+				topic->timestamp = findField(*topic, "timestamp");
+
+				if (topic->timestamp.size != sizeof(uint64_t)) {
+					topic->size = 0;
+				}
+			}
+		}
+	}
+
+	_sensor_combined_fields.gyro_rad = findField(_sensor_combined, "gyro_rad");
+	_sensor_combined_fields.gyro_integral_dt = findField(_sensor_combined, "gyro_integral_dt");
+	_sensor_combined_fields.accelerometer_m_s2 = findField(_sensor_combined, "accelerometer_m_s2");
+	_sensor_combined_fields.accelerometer_integral_dt = findField(_sensor_combined, "accelerometer_integral_dt");
+	_sensor_combined_fields.accelerometer_clipping = findField(_sensor_combined, "accelerometer_clipping");
+
+	_vehicle_air_data_fields.timestamp_sample = findField(_vehicle_air_data, "timestamp_sample");
+	_vehicle_air_data_fields.baro_device_id = findField(_vehicle_air_data, "baro_device_id");
+	_vehicle_air_data_fields.baro_alt_meter = findField(_vehicle_air_data, "baro_alt_meter");
+	_vehicle_air_data_fields.rho = findField(_vehicle_air_data, "rho");
+
+	_vehicle_magnetometer_fields.timestamp_sample = findField(_vehicle_magnetometer, "timestamp_sample");
+	_vehicle_magnetometer_fields.device_id = findField(_vehicle_magnetometer, "device_id");
+	_vehicle_magnetometer_fields.magnetometer_ga = findField(_vehicle_magnetometer, "magnetometer_ga");
+
+	auto &gps = _vehicle_gps_position_fields;
+	gps.latitude_deg = findField(_vehicle_gps_position, "latitude_deg");
+	gps.longitude_deg = findField(_vehicle_gps_position, "longitude_deg");
+	gps.altitude_msl_m = findField(_vehicle_gps_position, "altitude_msl_m");
+	gps.vel_n_m_s = findField(_vehicle_gps_position, "vel_n_m_s");
+	gps.vel_e_m_s = findField(_vehicle_gps_position, "vel_e_m_s");
+	gps.vel_d_m_s = findField(_vehicle_gps_position, "vel_d_m_s");
+	gps.vel_ned_valid = findField(_vehicle_gps_position, "vel_ned_valid");
+	gps.eph = findField(_vehicle_gps_position, "eph");
+	gps.epv = findField(_vehicle_gps_position, "epv");
+	gps.s_variance_m_s = findField(_vehicle_gps_position, "s_variance_m_s");
+	gps.fix_type = findField(_vehicle_gps_position, "fix_type");
+	gps.satellites_used = findField(_vehicle_gps_position, "satellites_used");
+	gps.hdop = findField(_vehicle_gps_position, "hdop");
+	gps.vdop = findField(_vehicle_gps_position, "vdop");
+	gps.heading = findField(_vehicle_gps_position, "heading");
+	gps.heading_accuracy = findField(_vehicle_gps_position, "heading_accuracy");
+	gps.heading_offset = findField(_vehicle_gps_position, "heading_offset");
+	gps.spoofing_state = findField(_vehicle_gps_position, "spoofing_state");
+
+	_airspeed_validated_fields.true_airspeed_m_s = findField(_airspeed_validated, "true_airspeed_m_s");
+	_airspeed_validated_fields.calibrated_airspeed_m_s = findField(_airspeed_validated, "calibrated_airspeed_m_s");
+	_airspeed_validated_fields.selected_airspeed_index = findField(_airspeed_validated, "selected_airspeed_index");
+
+	_vehicle_status_fields.arming_state = findField(_vehicle_status, "arming_state");
+	_vehicle_status_fields.vehicle_type = findField(_vehicle_status, "vehicle_type");
+
+	_vehicle_land_detected_fields.landed = findField(_vehicle_land_detected, "landed");
+	_vehicle_land_detected_fields.at_rest = findField(_vehicle_land_detected, "at_rest");
+	_vehicle_land_detected_fields.in_ground_effect = findField(_vehicle_land_detected, "in_ground_effect");
+}
+
+void EkfLogReplay::applyParameters()
+{
+	float gps_health_time_s = 10.f;
+
+	for (const ParameterBinding &binding : bindParameters(*_ekf->getParamHandle(), gps_health_time_s)) {
+		auto value = _param_overrides.find(binding.name);
+
+		if (value == _param_overrides.end()) {
+			value = _log_params.find(binding.name);
+
+			if (value == _log_params.end()) {
+				continue;
+			}
+		}
+
+		if (binding.float_value) {
+			*binding.float_value = (float)value->second;
+
+		} else {
+			*binding.int_value = (int32_t)value->second;
+		}
+	}
+
+#if defined(CONFIG_EKF2_GNSS)
+	_ekf->set_min_required_gps_health_time(gps_health_time_s * 1e6f);
+#endif // CONFIG_EKF2_GNSS
+}
+
+EkfLogReplay::Field EkfLogReplay::findField(const Topic &topic, const char *field_name) const
+{
+	Field field{};
+
+	if (!topic.valid()) {
+		return field;
+	}
+
+	const auto format = _formats.find(topic.name);
+
+	if (format == _formats.end()) {
+		return field;
+	}
+
+	const std::string &fields = format->second;
+	size_t prev_field_end = 0;
+	size_t field_end = fields.find(';');
+	int offset = 0;
+
+	while (field_end != std::string::npos) {
+		const size_t space_pos = fields.find(' ', prev_field_end);
+
+		if (space_pos != std::string::npos && space_pos < field_end) {
+			const std::string type_name_full = fields.substr(prev_field_end, space_pos - prev_field_end);
+			const int size = sizeOfFullType(type_name_full);
+
+			if (fields.compare(space_pos + 1, field_end - space_pos - 1, field_name) == 0) {
+				field.offset = offset;
+				field.size = size;
+				return field;
+			}
+
+			offset += size;
+		}
+
+		prev_field_end = field_end + 1;
+		field_end = fields.find(';', prev_field_end);
+	}
+
+	return field;
+}
+
+int EkfLogReplay::sizeOfFormat(const std::string &format_name) const
+{
+	const auto format = _formats.find(format_name);
+
+	if (format == _formats.end()) {
+		return 0;
+	}
+
+	const std::string &fields = format->second;
+	size_t prev_field_end = 0;
+	size_t field_end = fields.find(';');
+	int size = 0;
+
+	while (field_end != std::string::npos) {
+		const size_t space_pos = fields.find(' ', prev_field_end);
+
+		if (space_pos != std::string::npos && space_pos < field_end) {
+			size += sizeOfFullType(fields.substr(prev_field_end, space_pos - prev_field_end));
+		}
+
+		prev_field_end = field_end + 1;
+		field_end = fields.find(';', prev_field_end);
+	}
+
+	return size;
+}
+
+int EkfLogReplay::sizeOfFullType(const std::string &type_name_full) const
+{
+	std::string type_name = type_name_full;
+	int array_size = 1;
+
+	const size_t start_pos = type_name_full.find('[');
+	const size_t end_pos = type_name_full.find(']');
+
+	if (start_pos != std::string::npos && end_pos != std::string::npos) {
+		array_size = atoi(type_name_full.substr(start_pos + 1, end_pos - start_pos - 1).c_str());
+		type_name = type_name_full.substr(0, start_pos);
+	}
+
+	int size = 0;
+
+	if (type_name == "int8_t" || type_name == "uint8_t" || type_name == "char" || type_name == "bool") {
+		size = 1;
+
+	} else if (type_name == "int16_t" || type_name == "uint16_t") {
+		size = 2;
+
+	} else if (type_name == "int32_t" || type_name == "uint32_t" || type_name == "float") {
+		size = 4;
+
+	} else if (type_name == "int64_t" || type_name == "uint64_t" || type_name == "double") {
+		size = 8;
+
+	} else {
+		// nested topic type
+		size = sizeOfFormat(type_name);
+	}
+
+	return size * array_size;
+}
+
+const uint8_t *EkfLogReplay::topicData(const Topic &topic, size_t index) const
+{
+	ulog_message_header_s header;
+	const uint8_t *message = _file.message(_file.dataMessages(topic.msg_id)[index], header);
+
+	if (!message || (header.msg_size < sizeof(uint16_t) + topic.size)) {
+		return nullptr;
+	}
+
+	return message + sizeof(uint16_t);
+}
+
+uint64_t EkfLogReplay::topicTimestamp(const Topic &topic, size_t index) const
+{
+	const uint8_t *data = topicData(topic, index);
+
+	// skip incomplete messages right away
+	return data ? topic.timestamp.get<uint64_t>(data) : 0;
+}
+
+void EkfLogReplay::handleTopic(Topic &topic, const uint8_t *data)
+{
+	if (&topic == &_vehicle_air_data) {
+		handleBaro(data);
+
+	} else if (&topic == &_vehicle_magnetometer) {
+		handleMag(data);
+
+	} else if (&topic == &_vehicle_gps_position) {
+		handleGps(data);
+
+	} else if (&topic == &_airspeed_validated) {
+		handleAirspeed(data);
+
+	} else if (&topic == &_vehicle_status) {
+		handleVehicleStatus(data);
+
+	} else if (&topic == &_vehicle_land_detected) {
+		handleLandDetected(data);
+	}
+}
+
+void EkfLogReplay::handleBaro(const uint8_t *data)
+{
+#if defined(CONFIG_EKF2_BAROMETER)
+	const auto &fields = _vehicle_air_data_fields;
+	const uint32_t device_id = fields.baro_device_id.get<uint32_t>(data);
+	const bool reset = (device_id != _baro_device_id);
+	_baro_device_id = device_id;
+
+	_ekf->set_air_density(fields.rho.get<float>(data, 0, atmosphere::kAirDensitySeaLevelStandardAtmos));
+	const uint64_t time_us = fields.timestamp_sample.get<uint64_t>(data);
+	_ekf->setBaroData(baroSample{time_us, fields.baro_alt_meter.get<float>(data), reset});
+#endif // CONFIG_EKF2_BAROMETER
+}
+
+void EkfLogReplay::handleMag(const uint8_t *data)
+{
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	const auto &fields = _vehicle_magnetometer_fields;
+	const uint32_t device_id = fields.device_id.get<uint32_t>(data);
+	const bool reset = (device_id != _mag_device_id);
+	_mag_device_id = device_id;
+
+	const uint64_t time_us = fields.timestamp_sample.get<uint64_t>(data);
+	_ekf->setMagData(magSample{time_us, fields.magnetometer_ga.getVector3f(data), reset});
+#endif // CONFIG_EKF2_MAGNETOMETER
+}
+
+void EkfLogReplay::handleGps(const uint8_t *data)
+{
+#if defined(CONFIG_EKF2_GNSS)
+	const auto &fields = _vehicle_gps_position_fields;
+
+	if (!fields.vel_ned_valid.get<bool>(data)) {
+		return;
+	}
+
+	const float hdop = fields.hdop.get<float>(data);
+	const float vdop = fields.vdop.get<float>(data);
+
+	gnssSample gnss_sample{
+		.time_us = _vehicle_gps_position.timestamp.get<uint64_t>(data),
+		.lat = fields.latitude_deg.get<double>(data),
+		.lon = fields.longitude_deg.get<double>(data),
+		.alt = static_cast<float>(fields.altitude_msl_m.get<double>(data)),
+		.vel = Vector3f{fields.vel_n_m_s.get<float>(data), fields.vel_e_m_s.get<float>(data),
+				fields.vel_d_m_s.get<float>(data)},
+		.hacc = fields.eph.get<float>(data),
+		.vacc = fields.epv.get<float>(data),
+		.sacc = fields.s_variance_m_s.get<float>(data),
+		.fix_type = fields.fix_type.get<uint8_t>(data),
+		.nsats = fields.satellites_used.get<uint8_t>(data),
+		.pdop = sqrtf(hdop * hdop + vdop * vdop),
+		.yaw = fields.heading.get<float>(data, 0, NAN),
+		.yaw_acc = fields.heading_accuracy.get<float>(data, 0, NAN),
+		.yaw_offset = fields.heading_offset.get<float>(data, 0, NAN),
+		.spoofed = fields.spoofing_state.get<uint8_t>(data) == sensor_gps_s::SPOOFING_STATE_MULTIPLE,
+	};
+
+	_ekf->setGpsData(gnss_sample);
+#endif // CONFIG_EKF2_GNSS
+}
+
+void EkfLogReplay::handleAirspeed(const uint8_t *data)
+{
+#if defined(CONFIG_EKF2_AIRSPEED)
+	const auto &fields = _airspeed_validated_fields;
+	const float true_airspeed = fields.true_airspeed_m_s.get<float>(data, 0, NAN);
+	const float calibrated_airspeed = fields.calibrated_airspeed_m_s.get<float>(data, 0, NAN);
+
+	if (PX4_ISFINITE(true_airspeed) && PX4_ISFINITE(calibrated_airspeed) && (calibrated_airspeed > 0.f)
+	    && (fields.selected_airspeed_index.get<int8_t>(data) > 0)) {
+
+		airspeedSample airspeed_sample{
+			.time_us = _airspeed_validated.timestamp.get<uint64_t>(data),
+			.true_airspeed = true_airspeed,
+			.eas2tas = true_airspeed / calibrated_airspeed,
+		};
+		_ekf->setAirspeedData(airspeed_sample);
+	}
+#endif // CONFIG_EKF2_AIRSPEED
+}
+
+void EkfLogReplay::handleVehicleStatus(const uint8_t *data)
+{
+	_status_timestamp = _vehicle_status.timestamp.get<uint64_t>(data);
+	_arming_state = _vehicle_status_fields.arming_state.get<uint8_t>(data);
+	_vehicle_type = _vehicle_status_fields.vehicle_type.get<uint8_t>(data);
+	_system_flags_updated = true;
+}
+
+void EkfLogReplay::handleLandDetected(const uint8_t *data)
+{
+	_land_detected_timestamp = _vehicle_land_detected.timestamp.get<uint64_t>(data);
+	_landed = _vehicle_land_detected_fields.landed.get<bool>(data);
+	_at_rest = _vehicle_land_detected_fields.at_rest.get<bool>(data);
+	_in_ground_effect = _vehicle_land_detected_fields.in_ground_effect.get<bool>(data);
+	_system_flags_updated = true;
+}
+
+void EkfLogReplay::updateSystemFlags(uint64_t time_us)
+{
+	if (!_system_flags_updated) {
+		return;
+	}
+
+	_system_flags_updated = false;
+
+	systemFlagUpdate flags{};
+	flags.time_us = time_us;
+
+	if ((_status_timestamp > 0) && (time_us < _status_timestamp + 3000000)) {
+		flags.in_air = (_arming_state == vehicle_status_s::ARMING_STATE_ARMED);
+		flags.is_fixed_wing = (_vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING);
+	}
+
+	if ((_land_detected_timestamp > 0) && (time_us < _land_detected_timestamp + 3000000)) {
+		flags.at_rest = _at_rest;
+		flags.in_air = !_landed;
+		flags.gnd_effect = _in_ground_effect;
+	}
+
+	_ekf->setSystemFlagData(flags);
+}
+
+void EkfLogReplay::updateSummary(uint64_t time_us)
+{
+	if (!PX4_ISFINITE(_summary.tilt_align_time_s) && _ekf->attitude_valid()) {
+		_summary.tilt_align_time_s = (time_us - _start_time) * 1.e-6f;
+	}
+
+	_summary.vel_test_ratio.update(_ekf->getVelocityInnovationTestRatio());
+	_summary.hpos_test_ratio.update(_ekf->getHorizontalPositionInnovationTestRatio());
+	_summary.vpos_test_ratio.update(_ekf->getVerticalPositionInnovationTestRatio());
+	_summary.heading_test_ratio.update(_ekf->getHeadingInnovationTestRatio());
+	_summary.airspeed_test_ratio.update(_ekf->getAirspeedInnovationTestRatio());
+
+#if defined(CONFIG_EKF2_GNSS)
+	_summary.gnss_vel.update(_ekf->aid_src_gnss_vel());
+	_summary.gnss_pos.update(_ekf->aid_src_gnss_pos());
+	_summary.gnss_hgt.update(_ekf->aid_src_gnss_hgt());
+#endif // CONFIG_EKF2_GNSS
+#if defined(CONFIG_EKF2_BAROMETER)
+	_summary.baro_hgt.update(_ekf->aid_src_baro_hgt());
+#endif // CONFIG_EKF2_BAROMETER
+#if defined(CONFIG_EKF2_MAGNETOMETER)
+	_summary.mag.update(_ekf->aid_src_mag());
+#endif // CONFIG_EKF2_MAGNETOMETER
+#if defined(CONFIG_EKF2_AIRSPEED)
+	_summary.airspeed.update(_ekf->aid_src_airspeed());
+#endif // CONFIG_EKF2_AIRSPEED
+
+	// reset counters wrap at 255, count the changes
+	const uint8_t quat_reset_count = _ekf->get_quat_reset_count();
+	const uint8_t vel_ne_reset_count = _ekf->get_velNE_reset_count();
+	const uint8_t vel_d_reset_count = _ekf->get_velD_reset_count();
+	const uint8_t pos_ne_reset_count = _ekf->get_posNE_reset_count();
+	const uint8_t pos_d_reset_count = _ekf->get_posD_reset_count();
+
+	_summary.quat_resets += (uint8_t)(quat_reset_count - _quat_reset_count);
+	_summary.vel_resets += (uint8_t)(vel_ne_reset_count - _vel_ne_reset_count)
+			       + (uint8_t)(vel_d_reset_count - _vel_d_reset_count);
+	_summary.pos_resets += (uint8_t)(pos_ne_reset_count - _pos_ne_reset_count)
+			       + (uint8_t)(pos_d_reset_count - _pos_d_reset_count);
+
+	_quat_reset_count = quat_reset_count;
+	_vel_ne_reset_count = vel_ne_reset_count;
+	_vel_d_reset_count = vel_d_reset_count;
+	_pos_ne_reset_count = pos_ne_reset_count;
+	_pos_d_reset_count = pos_d_reset_count;
+}
@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Replay the estimator inputs of a ULog file directly into an Ekf instance,
+ * without uORB or work queues, and summarize the innovations and test ratios.
+ */
+#ifndef EKF_EKF_LOG_REPLAY_H
+#define EKF_EKF_LOG_REPLAY_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ULogFile.hpp>
+
+#include "EKF/ekf.h"
+
+class EkfLogReplay
+{
+public:
+	/** running statistics of a test ratio, ignoring samples where the ratio is not available */
+	struct TestRatioStatistics {
+		void update(float test_ratio);
+		float mean() const { return (count > 0) ? (float)(sum / count) : NAN; }
+
+		uint32_t count{0};
+		double sum{0.};
+		float max{NAN};
+	};
+
+	/** statistics of an aid source, counting each measurement once */
+	struct AidSourceStatistics {
+		template<typename T>
+		void update(const T &aid_src);
+
+		float innovationRms() const { return (samples > 0) ? (float)sqrt(innovation_sum_sq / samples) : NAN; }
+		float rejectedRatio() const { return (samples > 0) ? (float)rejected / samples : NAN; }
+
+		uint64_t last_timestamp_sample{0};
+		uint32_t samples{0};
+		uint32_t rejected{0};
+		double innovation_sum_sq{0.};
+	};
+
+	struct Summary {
+		float duration_s{0.f};
+		uint32_t imu_samples{0};
+		uint32_t filter_updates{0};
+		float tilt_align_time_s{NAN};
+
+		TestRatioStatistics vel_test_ratio;
+		TestRatioStatistics hpos_test_ratio;
+		TestRatioStatistics vpos_test_ratio;
+		TestRatioStatistics heading_test_ratio;
+		TestRatioStatistics airspeed_test_ratio;
+
+		AidSourceStatistics gnss_vel;
+		AidSourceStatistics gnss_pos;
+		AidSourceStatistics gnss_hgt;
+		AidSourceStatistics baro_hgt;
+		AidSourceStatistics mag;
+		AidSourceStatistics airspeed;
+
+		uint32_t quat_resets{0};
+		uint32_t vel_resets{0};
+		uint32_t pos_resets{0};
+	};
+
+	/**
+	 * @param file_name ULog file
+	 * @param param_overrides EKF2_* parameter values to use instead of the values stored in the log
+	 */
+	EkfLogReplay(const std::string &file_name, const std::map<std::string, double> &param_overrides);
+	~EkfLogReplay() = default;
+
+	/**
+	 * Run the whole log through the filter. The log must be recorded with the estimator replay
+	 * logging profile (SDLOG_PROFILE), like for replay.
+	 * @return false if the log cannot be replayed, error() contains the reason
+	 */
+	bool run();
+
+	const Summary &summary() const { return _summary; }
+	const std::string &error() const { return _error; }
+
+	/** names of the EKF2_* parameters applied from the log */
+	static std::vector<std::string> parameterNames();
+
+private:
+	/** location of a field within the logged topic data */
+	struct Field {
+		template<typename T>
+		T get(const uint8_t *data, int index = 0, T fallback = T{}) const
+		{
+			if ((offset < 0) || ((int)sizeof(T) * (index + 1) > size)) {
+				return fallback;
+			}
+
+			T value;
+			memcpy(&value, data + offset + sizeof(T) * index, sizeof(T));
+			return value;
+		}
+
+		Vector3f getVector3f(const uint8_t *data) const
+		{
+			return Vector3f{get<float>(data, 0), get<float>(data, 1), get<float>(data, 2)};
+		}
+
+		int offset{-1};
+		int size{0};
+	};
+
+	/** logged topic (instance 0) and the cursor into its data messages */
+	struct Topic {
+		explicit Topic(const char *topic_name) : name(topic_name) {}
+
+		bool valid() const { return msg_id >= 0; }
+
+		const char *name;
+		int msg_id{-1};
+		int size{0};
+		Field timestamp{};
+		size_t next_index{0};
+	};
+
+	struct ParameterBinding {
+		const char *name;
+		float *float_value;
+		int32_t *int_value;
+	};
+
+	bool readDefinitions();
+	bool readFlagBits(const uint8_t *message, uint16_t msg_size);
+	void readFormat(const uint8_t *message, uint16_t msg_size);
+	void readParameter(const uint8_t *message, uint16_t msg_size);
+	void readSubscriptions();
+
+	void applyParameters();
+	static std::vector<ParameterBinding> bindParameters(parameters &params, float &gps_health_time_s);
+
+	Field findField(const Topic &topic, const char *field_name) const;
+	int sizeOfFormat(const std::string &format_name) const;
+	int sizeOfFullType(const std::string &type_name_full) const;
+
+	/** topic data (after the msg_id) of the data message at index, or nullptr */
+	const uint8_t *topicData(const Topic &topic, size_t index) const;
+	uint64_t topicTimestamp(const Topic &topic, size_t index) const;
+
+	void handleTopic(Topic &topic, const uint8_t *data);
+	void handleBaro(const uint8_t *data);
+	void handleMag(const uint8_t *data);
+	void handleGps(const uint8_t *data);
+	void handleAirspeed(const uint8_t *data);
+	void handleVehicleStatus(const uint8_t *data);
+	void handleLandDetected(const uint8_t *data);
+	void updateSystemFlags(uint64_t time_us);
+
+	void updateSummary(uint64_t time_us);
+
+	const std::string _file_name;
+	const std::map<std::string, double> _param_overrides;
+
+	px4::ULogFile _file;
+	uint64_t _data_section_start{0};
+	uint64_t _read_until_file_position{UINT64_MAX};
+
+	std::map<std::string, std::string> _formats; ///< fields of each format, by format name
+	std::map<std::string, double> _log_params;
+
+	Topic _ekf2_timestamps{"ekf2_timestamps"}; ///< only logged by the estimator replay profile
+
+	Topic _sensor_combined{"sensor_combined"};
+	struct {
+		Field gyro_rad, gyro_integral_dt, accelerometer_m_s2, accelerometer_integral_dt, accelerometer_clipping;
+	} _sensor_combined_fields;
+
+	Topic _vehicle_air_data{"vehicle_air_data"};
+	struct {
+		Field timestamp_sample, baro_device_id, baro_alt_meter, rho;
+	} _vehicle_air_data_fields;
+
+	Topic _vehicle_magnetometer{"vehicle_magnetometer"};
+	struct {
+		Field timestamp_sample, device_id, magnetometer_ga;
+	} _vehicle_magnetometer_fields;
+
+	Topic _vehicle_gps_position{"vehicle_gps_position"};
+	struct {
+		Field latitude_deg, longitude_deg, altitude_msl_m, vel_n_m_s, vel_e_m_s, vel_d_m_s, vel_ned_valid;
+		Field eph, epv, s_variance_m_s, fix_type, satellites_used, hdop, vdop;
+		Field heading, heading_accuracy, heading_offset, spoofing_state;
+	} _vehicle_gps_position_fields;
+
+	Topic _airspeed_validated{"airspeed_validated"};
+	struct {
+		Field true_airspeed_m_s, calibrated_airspeed_m_s, selected_airspeed_index;
+	} _airspeed_validated_fields;
+
+	Topic _vehicle_status{"vehicle_status"};
+	struct {
+		Field arming_state, vehicle_type;
+	} _vehicle_status_fields;
+
+	Topic _vehicle_land_detected{"vehicle_land_detected"};
+	struct {
+		Field landed, at_rest, in_ground_effect;
+	} _vehicle_land_detected_fields;
+
+	std::unique_ptr<Ekf> _ekf;
+
+	uint32_t _baro_device_id{0};
+	uint32_t _mag_device_id{0};
+
+	uint64_t _status_timestamp{0};
+	uint8_t _arming_state{0};
+	uint8_t _vehicle_type{0};
+
+	uint64_t _land_detected_timestamp{0};
+	bool _landed{true};
+	bool _at_rest{false};
+	bool _in_ground_effect{false};
+
+	bool _system_flags_updated{false};
+
+	uint64_t _start_time{0};
+	uint8_t _quat_reset_count{0};
+	uint8_t _vel_ne_reset_count{0};
+	uint8_t _vel_d_reset_count{0};
+	uint8_t _pos_ne_reset_count{0};
+	uint8_t _pos_d_reset_count{0};
+
+	Summary _summary{};
+	std::string _error;
+};
+
+#endif // !EKF_EKF_LOG_REPLAY_H
@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "EKF2ImuDownSampler.hpp"
+
+class EKF2ImuDownSamplerTest : public ::testing::Test
+{
+public:
+	static constexpr int32_t TARGET_DT_US = 10000;
+	static constexpr uint32_t IMU_DT_US = 4000;
+
+	void SetUp() override
+	{
+		int32_t target_dt_us = TARGET_DT_US;
+		ImuDownSampler reference{target_dt_us};
+
+		for (int i = 1; i <= 300; i++) {
+			imuSample imu_sample{};
+			imu_sample.time_us = i * IMU_DT_US;
+			imu_sample.delta_ang_dt = IMU_DT_US * 1e-6f;
+			imu_sample.delta_vel_dt = IMU_DT_US * 1e-6f;
+			imu_sample.delta_ang = Vector3f(0.1f, -0.2f, 0.05f * (i % 7)) * imu_sample.delta_ang_dt;
+			imu_sample.delta_vel = Vector3f(0.3f, 0.1f * (i % 5), -9.8f) * imu_sample.delta_vel_dt;
+			_imu_samples.push_back(imu_sample);
+
+			if (reference.update(imu_sample)) {
+				_expected.push_back(reference.getDownSampledImuAndTriggerReset());
+			}
+		}
+	}
+
+	struct Consumer {
+		uint64_t time_last_downsampled_us{0};
+		std::vector<imuSample> received{};
+		bool lagging{false};
+	};
+
+	void update(EKF2ImuDownSampler *down_sampler, Consumer &consumer, const imuSample &imu_sample)
+	{
+		imuSample imu_downsampled{};
+
+		switch (down_sampler->update(imu_sample, TARGET_DT_US, consumer.time_last_downsampled_us, imu_downsampled)) {
+		case EKF2ImuDownSampler::Result::SAMPLE:
+			consumer.received.push_back(imu_downsampled);
+			break;
+
+		case EKF2ImuDownSampler::Result::LAGGING:
+			consumer.lagging = true;
+			break;
+
+		case EKF2ImuDownSampler::Result::NONE:
+			break;
+		}
+	}
+
+	// first consumer processes every sample as it arrives, the second one keeps up for a while and
+	// then stalls for lag_samples before catching up
+	void run(int lag_samples, Consumer &leading, Consumer &lagging)
+	{
+		EKF2ImuDownSampler *down_sampler = EKF2ImuDownSampler::acquire(0);
+		ASSERT_NE(down_sampler, nullptr);
+		ASSERT_EQ(EKF2ImuDownSampler::acquire(0), down_sampler);
+
+		const int num_samples = _imu_samples.size();
+		const int stall_start = 50;
+
+		for (int i = 0; i < num_samples + lag_samples; i++) {
+			if (i < num_samples) {
+				update(down_sampler, leading, _imu_samples[i]);
+			}
+
+			if (i < stall_start) {
+				update(down_sampler, lagging, _imu_samples[i]);
+
+			} else if (i >= stall_start + lag_samples) {
+				update(down_sampler, lagging, _imu_samples[i - lag_samples]);
+			}
+		}
+
+		EKF2ImuDownSampler::release(down_sampler);
+		EKF2ImuDownSampler::release(down_sampler);
+	}
+
+	void expectSameAsReference(const Consumer &consumer)
+	{
+		ASSERT_EQ(consumer.received.size(), _expected.size());
+
+		for (size_t i = 0; i < _expected.size(); i++) {
+			EXPECT_EQ(consumer.received[i].time_us, _expected[i].time_us);
+			EXPECT_FLOAT_EQ(consumer.received[i].delta_ang_dt, _expected[i].delta_ang_dt);
+			EXPECT_FLOAT_EQ(consumer.received[i].delta_vel_dt, _expected[i].delta_vel_dt);
+			EXPECT_TRUE(consumer.received[i].delta_ang == _expected[i].delta_ang);
+			EXPECT_TRUE(consumer.received[i].delta_vel == _expected[i].delta_vel);
+		}
+	}
+
+	std::vector<imuSample> _imu_samples{};
+	std::vector<imuSample> _expected{};
+};
+
+TEST_F(EKF2ImuDownSamplerTest, instancesInStep)
+{
+	Consumer first;
+	Consumer second;
+	run(0, first, second);
+
+	EXPECT_FALSE(first.lagging);
+	EXPECT_FALSE(second.lagging);
+	expectSameAsReference(first);
+	expectSameAsReference(second);
+}
+
+TEST_F(EKF2ImuDownSamplerTest, laggingInstanceGetsEverySample)
+{
+	// GIVEN: an instance falling several down-sampled periods behind the one running the down-sampler
+	Consumer leading;
+	Consumer lagging;
+	run(10, leading, lagging);
+
+	// THEN: both see every down-sampled sample exactly once and in order
+	EXPECT_FALSE(leading.lagging);
+	EXPECT_FALSE(lagging.lagging);
+	expectSameAsReference(leading);
+	expectSameAsReference(lagging);
+}
+
+TEST_F(EKF2ImuDownSamplerTest, laggingInstanceBeyondQueueIsReported)
+{
+	// GIVEN: an instance falling behind by more samples than the queue can hold
+	Consumer leading;
+	Consumer lagging;
+	run(3 * EKF2ImuDownSampler::DOWNSAMPLED_QUEUE_LEN * TARGET_DT_US / IMU_DT_US, leading, lagging);
+
+	// THEN: the lost samples are reported instead of silently skipped
+	EXPECT_FALSE(leading.lagging);
+	expectSameAsReference(leading);
+	EXPECT_TRUE(lagging.lagging);
+}
@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "ekf_log_replay.h"
+
+// Writes a small ULog file with stationary estimator inputs, like the estimator replay logging profile
+class UlogTestWriter
+{
+public:
+	explicit UlogTestWriter(bool replay_profile)
+	{
+		const uint8_t header[16] {'U', 'L', 'o', 'g', 0x01, 0x12, 0x35, 0x01};
+		_buffer.insert(_buffer.end(), header, header + sizeof(header));
+
+		const uint8_t flag_bits[40] {};
+		message('B', flag_bits, sizeof(flag_bits));
+
+		format("sensor_combined:uint64_t timestamp;float[3] gyro_rad;uint32_t gyro_integral_dt;"
+		       "int32_t accelerometer_timestamp_relative;float[3] accelerometer_m_s2;"
+		       "uint32_t accelerometer_integral_dt;uint8_t accelerometer_clipping;");
+		format("vehicle_air_data:uint64_t timestamp;uint64_t timestamp_sample;uint32_t baro_device_id;"
+		       "float baro_alt_meter;float rho;");
+		format("ekf2_timestamps:uint64_t timestamp;");
+
+		addSubscription(SENSOR_COMBINED, "sensor_combined");
+		addSubscription(VEHICLE_AIR_DATA, "vehicle_air_data");
+
+		if (replay_profile) {
+			addSubscription(EKF2_TIMESTAMPS, "ekf2_timestamps");
+		}
+
+		for (int i = 0; i < IMU_SAMPLES; i++) {
+			const uint64_t time_us = 1000000 + i * IMU_INTERVAL_US;
+
+			if (i % 10 == 0) {
+				start(VEHICLE_AIR_DATA);
+				add(time_us);
+				add(time_us);
+				add(uint32_t{1});
+				add(400.f);
+				add(1.2f);
+				end();
+			}
+
+			if (replay_profile) {
+				start(EKF2_TIMESTAMPS);
+				add(time_us);
+				end();
+			}
+
+			start(SENSOR_COMBINED);
+			add(time_us);
+			add(Vector3f{0.f, 0.f, 0.f});
+			add(IMU_INTERVAL_US);
+			add(int32_t{0});
+			add(Vector3f{0.f, 0.f, -CONSTANTS_ONE_G});
+			add(IMU_INTERVAL_US);
+			add(uint8_t{0});
+			end();
+		}
+	}
+
+	bool write(const char *file_name) const
+	{
+		FILE *file = fopen(file_name, "wb");
+
+		if (!file) {
+			return false;
+		}
+
+		const bool ret = fwrite(_buffer.data(), 1, _buffer.size(), file) == _buffer.size();
+		fclose(file);
+		return ret;
+	}
+
+	static constexpr int IMU_SAMPLES = 2500;
+	static constexpr uint32_t IMU_INTERVAL_US = 4000;
+
+private:
+	enum MsgId : uint16_t {
+		SENSOR_COMBINED,
+		VEHICLE_AIR_DATA,
+		EKF2_TIMESTAMPS,
+	};
+
+	void message(char type, const uint8_t *data, size_t size)
+	{
+		const uint8_t header[3] {(uint8_t)(size & 0xff), (uint8_t)(size >> 8), (uint8_t)type};
+		_buffer.insert(_buffer.end(), header, header + sizeof(header));
+		_buffer.insert(_buffer.end(), data, data + size);
+	}
+
+	void format(const char *format) { message('F', (const uint8_t *)format, strlen(format)); }
+
+	void addSubscription(MsgId msg_id, const char *topic_name)
+	{
+		std::vector<uint8_t> data{0, (uint8_t)msg_id, 0};
+		data.insert(data.end(), topic_name, topic_name + strlen(topic_name));
+		message('A', data.data(), data.size());
+	}
+
+	void start(MsgId msg_id) { _data = {(uint8_t)msg_id, 0}; }
+
+	template<typename T>
+	void add(T value)
+	{
+		const uint8_t *bytes = (const uint8_t *)&value;
+		_data.insert(_data.end(), bytes, bytes + sizeof(T));
+	}
+
+	void add(const Vector3f &value)
+	{
+		add(value(0));
+		add(value(1));
+		add(value(2));
+	}
+
+	void end() { message('D', _data.data(), _data.size()); }
+
+	std::vector<uint8_t> _buffer;
+	std::vector<uint8_t> _data;
+};
+
+class EkfBatchReplayTest : public ::testing::Test
+{
+public:
+	void TearDown() override
+	{
+		remove(FILE_NAME);
+	}
+
+	static constexpr const char *FILE_NAME = "ekf2_batch_replay_test.ulg";
+};
+
+TEST_F(EkfBatchReplayTest, replayProfileLog)
+{
+	// GIVEN: a log recorded with the estimator replay profile
+	ASSERT_TRUE(UlogTestWriter(true).write(FILE_NAME));
+
+	// WHEN: replaying it
+	EkfLogReplay replay(FILE_NAME, {});
+	ASSERT_TRUE(replay.run()) << replay.error();
+
+	// THEN: every IMU sample reached the filter, which aligned its tilt and fused the baro
+	const EkfLogReplay::Summary &summary = replay.summary();
+	EXPECT_EQ(summary.imu_samples, (uint32_t)UlogTestWriter::IMU_SAMPLES);
+	EXPECT_GT(summary.filter_updates, 0u);
+	EXPECT_TRUE(PX4_ISFINITE(summary.tilt_align_time_s));
+	EXPECT_GT(summary.baro_hgt.samples, 0u);
+	EXPECT_LT(summary.baro_hgt.innovationRms(), 0.1f);
+}
+
+TEST_F(EkfBatchReplayTest, rejectOtherLoggingProfile)
+{
+	// GIVEN: a log without ekf2_timestamps (not the estimator replay profile)
+	ASSERT_TRUE(UlogTestWriter(false).write(FILE_NAME));
+
+	// WHEN: replaying it
+	EkfLogReplay replay(FILE_NAME, {});
+
+	// THEN: it is rejected
+	EXPECT_FALSE(replay.run());
+	EXPECT_NE(replay.error().find("ekf2_timestamps"), std::string::npos);
+}
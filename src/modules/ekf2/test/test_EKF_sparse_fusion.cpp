@@ -0,0 +1,376 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Sparse observation Jacobian fusion
+ *
+ * Checks that the sparsity patterns declared in Ekf cover all the non-zero
+ * entries of the generated observation Jacobians, that fusing a sparse H gives
+ * the same result as fusing the dense one and reports the cost of a single
+ * scalar fusion (innovation variance, Kalman gain and covariance update) for both.
+ * Also checks that fusing direct state measurements of several axes in one batch
+ * matches fusing them one after the other.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+#include "EKF/ekf.h"
+#include "sensor_simulator/sensor_simulator.h"
+#include "sensor_simulator/ekf_wrapper.h"
+#include "test_helper/comparison_helper.h"
+
+#include "../EKF/python/ekf_derivation/generated/compute_airspeed_h_and_k.h"
+#include "../EKF/python/ekf_derivation/generated/compute_drag_x_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_drag_y_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_ev_body_vel_hx.h"
+#include "../EKF/python/ekf_derivation/generated/compute_ev_body_vel_hy.h"
+#include "../EKF/python/ekf_derivation/generated/compute_ev_body_vel_hz.h"
+#include "../EKF/python/ekf_derivation/generated/compute_flow_xy_innov_var_and_hx.h"
+#include "../EKF/python/ekf_derivation/generated/compute_flow_y_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_gnss_yaw_pred_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_gravity_xyz_innov_var_and_hx.h"
+#include "../EKF/python/ekf_derivation/generated/compute_gravity_y_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_gravity_z_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_hagl_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_mag_declination_pred_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_mag_innov_innov_var_and_hx.h"
+#include "../EKF/python/ekf_derivation/generated/compute_mag_y_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_mag_z_innov_var_and_h.h"
+#include "../EKF/python/ekf_derivation/generated/compute_sideslip_h_and_k.h"
+#include "../EKF/python/ekf_derivation/generated/compute_yaw_innov_var_and_h.h"
+
+using namespace matrix;
+
+// returns true if all the non-zero entries of H are part of the sparsity pattern
+template<typename SparseH>
+static bool isCoveredBy(const VectorState &H)
+{
+	const VectorState H_restored = SparseH(H) + VectorState();
+	return (H - H_restored).abs().max() <= 0.f;
+}
+
+static StateSample createRandomState()
+{
+	StateSample state{};
+	state.quat_nominal = Quatf(randf() - 0.5f, randf() - 0.5f, randf() - 0.5f, randf() - 0.5f).normalized();
+	state.vel = Vector3f(randf(), randf(), randf()) * 10.f;
+	state.pos = Vector3f(randf(), randf(), randf()) * 100.f;
+	state.mag_I = Vector3f(randf(), randf(), randf());
+	state.mag_B = Vector3f(randf(), randf(), randf()) * 0.1f;
+	state.wind_vel = Vector2f(randf(), randf()) * 5.f;
+	state.terrain = randf() * 10.f;
+	return state;
+}
+
+TEST(EkfSparseObservationJacobian, generatedJacobiansAreCovered)
+{
+	for (int i = 0; i < 100; i++) {
+		const StateSample state = createRandomState();
+		const auto state_vector = state.vector();
+		const SquareMatrixState P = createRandomCovarianceMatrix();
+		const float R = sq(0.1f);
+		const Vector3f mag(0.2f, 0.f, 0.4f);
+		float innov_var;
+		Vector3f innov_var3;
+		Vector2f innov_var2;
+		float pred;
+		Vector3f innov;
+		VectorState H;
+		VectorState K;
+
+		sym::ComputeMagInnovInnovVarAndHx(state_vector, P, mag, R, FLT_EPSILON, &innov, &innov_var3, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHMag>(H));
+		sym::ComputeMagYInnovVarAndH(state_vector, P, R, FLT_EPSILON, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHMag>(H));
+		sym::ComputeMagZInnovVarAndH(state_vector, P, R, FLT_EPSILON, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHMag>(H));
+		sym::ComputeMagDeclinationPredInnovVarAndH(state_vector, P, R, FLT_EPSILON, &pred, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHMagDeclination>(H));
+
+		sym::ComputeAirspeedHAndK(state_vector, P, 1.f, FLT_EPSILON, &H, &K);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAirspeed>(H));
+		sym::ComputeSideslipHAndK(state_vector, P, 1.f, FLT_EPSILON, &H, &K);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHSideslip>(H));
+		sym::ComputeDragXInnovVarAndH(state_vector, P, 1.2f, 0.05f, 0.1f, R, FLT_EPSILON, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHDrag>(H));
+		sym::ComputeDragYInnovVarAndH(state_vector, P, 1.2f, 0.05f, 0.1f, R, FLT_EPSILON, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHDrag>(H));
+
+		sym::ComputeFlowXyInnovVarAndHx(state_vector, P, R, FLT_EPSILON, &innov_var2, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHFlow>(H));
+		sym::ComputeFlowYInnovVarAndH(state_vector, P, R, FLT_EPSILON, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHFlow>(H));
+		sym::ComputeHaglH(&H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHHagl>(H));
+
+		sym::ComputeEvBodyVelHx(state_vector, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHBodyVel>(H));
+		sym::ComputeEvBodyVelHy(state_vector, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHBodyVel>(H));
+		sym::ComputeEvBodyVelHz(state_vector, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHBodyVel>(H));
+
+		sym::ComputeGnssYawPredInnovVarAndH(state_vector, P, 0.f, R, FLT_EPSILON, &pred, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAttitude>(H));
+		sym::ComputeYawInnovVarAndH(state_vector, P, R, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAttitude>(H));
+		sym::ComputeGravityXyzInnovVarAndHx(state_vector, P, R, &innov_var3, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAttitude>(H));
+		sym::ComputeGravityYInnovVarAndH(state_vector, P, R, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAttitude>(H));
+		sym::ComputeGravityZInnovVarAndH(state_vector, P, R, &innov_var, &H);
+		EXPECT_TRUE(isCoveredBy<Ekf::SparseHAttitude>(H));
+	}
+}
+
+class EkfSparseFusionTest : public ::testing::Test
+{
+public:
+
+	EkfSparseFusionTest(): ::testing::Test(),
+		_ekf_dense{std::make_shared<Ekf>()},
+		_ekf_sparse{std::make_shared<Ekf>()},
+		_sensor_simulator_dense(_ekf_dense),
+		_sensor_simulator_sparse(_ekf_sparse) {};
+
+	// both filters run the same deterministic scenario and end up in the same state
+	std::shared_ptr<Ekf> _ekf_dense;
+	std::shared_ptr<Ekf> _ekf_sparse;
+	SensorSimulator _sensor_simulator_dense;
+	SensorSimulator _sensor_simulator_sparse;
+
+	static constexpr int kIterations = 1000;
+
+	void SetUp() override
+	{
+		runScenario(_ekf_dense, _sensor_simulator_dense);
+		runScenario(_ekf_sparse, _sensor_simulator_sparse);
+	}
+
+	// fixed-wing flight with GNSS, magnetometer and airspeed so that all the states are observed
+	static void runScenario(std::shared_ptr<Ekf> ekf, SensorSimulator &sensor_simulator)
+	{
+		EkfWrapper ekf_wrapper(ekf);
+
+		ekf->init(0);
+		sensor_simulator.runSeconds(0.1);
+		ekf->set_in_air_status(false);
+		ekf->set_vehicle_at_rest(true);
+		sensor_simulator.runSeconds(2);
+
+		ekf_wrapper.enableGpsFusion();
+		sensor_simulator.startGps();
+		sensor_simulator.runSeconds(11);
+
+		ekf->set_in_air_status(true);
+		ekf->set_vehicle_at_rest(false);
+		ekf->set_is_fixed_wing(true);
+		sensor_simulator.startAirspeedSensor();
+		sensor_simulator._airspeed.setData(2.4f, 2.4f);
+		sensor_simulator.runSeconds(10);
+	}
+
+	static uint64_t cycles()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	// Fuse the same scalar observation kIterations times in both filters, using the dense Jacobian in
+	// one and its sparse counterpart in the other, then compare the resulting covariances and states
+	template<typename SparseH>
+	void compareFusion(const char *name, const VectorState &H, float R)
+	{
+		const SparseH H_sparse(H);
+
+		const auto dense_start = std::chrono::steady_clock::now();
+		const uint64_t dense_cycles_start = cycles();
+
+		for (int i = 0; i < kIterations; i++) {
+			const SquareMatrixState &P = _ekf_dense->covariances();
+			const float innov_var = (H.T() * P * H)(0, 0) + R;
+			VectorState K = P * H / innov_var;
+			_ekf_dense->measurementUpdate(K, H, R, 0.01f);
+		}
+
+		const uint64_t dense_cycles = cycles() - dense_cycles_start;
+		const auto dense_end = std::chrono::steady_clock::now();
+
+		const auto sparse_start = std::chrono::steady_clock::now();
+		const uint64_t sparse_cycles_start = cycles();
+
+		for (int i = 0; i < kIterations; i++) {
+			const SquareMatrixState &P = _ekf_sparse->covariances();
+			const float innov_var = matrix::quadraticForm(P, H_sparse) + R;
+			VectorState K = P * H_sparse / innov_var;
+			_ekf_sparse->measurementUpdate(K, H_sparse, R, 0.01f);
+		}
+
+		const uint64_t sparse_cycles = cycles() - sparse_cycles_start;
+		const auto sparse_end = std::chrono::steady_clock::now();
+
+		const SquareMatrixState &P_dense = _ekf_dense->covariances();
+		const SquareMatrixState &P_sparse = _ekf_sparse->covariances();
+
+		for (unsigned i = 0; i < State::size; i++) {
+			for (unsigned j = 0; j < State::size; j++) {
+				EXPECT_NEAR(P_dense(i, j), P_sparse(i, j), 1e-5f * fabsf(P_dense(i, j)) + 1e-9f)
+						<< name << " P(" << i << ", " << j << ")";
+			}
+		}
+
+		const auto state_dense = _ekf_dense->state().vector();
+		const auto state_sparse = _ekf_sparse->state().vector();
+
+		for (unsigned i = 0; i < state_dense.size(); i++) {
+			EXPECT_NEAR(state_dense(i), state_sparse(i), 1e-5f * fabsf(state_dense(i)) + 1e-6f)
+					<< name << " state(" << i << ")";
+		}
+
+		const double dense_ns = std::chrono::duration<double, std::nano>(dense_end - dense_start).count();
+		const double sparse_ns = std::chrono::duration<double, std::nano>(sparse_end - sparse_start).count();
+
+		printf("%-16s %2zu/%d non-zeros  dense %7.0f ns %8.0f cycles  sparse %7.0f ns %8.0f cycles\n",
+		       name, H_sparse.non_zeros(), State::size,
+		       dense_ns / kIterations, (double)dense_cycles / kIterations,
+		       sparse_ns / kIterations, (double)sparse_cycles / kIterations);
+	}
+};
+
+TEST_F(EkfSparseFusionTest, sparseMatchesDense)
+{
+	// both filters must start from the exact same point
+	ASSERT_TRUE(matrix::isEqual(_ekf_dense->covariances(), _ekf_sparse->covariances(), 0.f));
+
+	const auto state_vector = _ekf_dense->state().vector();
+	const SquareMatrixState P = _ekf_dense->covariances();
+	const float R = sq(0.5f);
+	const Vector3f mag(0.2f, 0.f, 0.4f);
+	float innov_var;
+	Vector3f innov_var3;
+	Vector2f innov_var2;
+	float pred;
+	Vector3f innov;
+	VectorState H;
+	VectorState K;
+
+	sym::ComputeMagInnovInnovVarAndHx(state_vector, P, mag, R, FLT_EPSILON, &innov, &innov_var3, &H);
+	compareFusion<Ekf::SparseHMag>("mag", H, R);
+
+	sym::ComputeMagDeclinationPredInnovVarAndH(state_vector, P, R, FLT_EPSILON, &pred, &innov_var, &H);
+	compareFusion<Ekf::SparseHMagDeclination>("mag declination", H, R);
+
+	sym::ComputeAirspeedHAndK(state_vector, P, 1.f, FLT_EPSILON, &H, &K);
+	compareFusion<Ekf::SparseHAirspeed>("airspeed", H, R);
+
+	sym::ComputeSideslipHAndK(state_vector, P, 1.f, FLT_EPSILON, &H, &K);
+	compareFusion<Ekf::SparseHSideslip>("sideslip", H, R);
+
+	sym::ComputeDragXInnovVarAndH(state_vector, P, 1.2f, 0.05f, 0.1f, R, FLT_EPSILON, &innov_var, &H);
+	compareFusion<Ekf::SparseHDrag>("drag", H, R);
+
+	sym::ComputeFlowXyInnovVarAndHx(state_vector, P, R, FLT_EPSILON, &innov_var2, &H);
+	compareFusion<Ekf::SparseHFlow>("optical flow", H, R);
+
+	sym::ComputeHaglH(&H);
+	compareFusion<Ekf::SparseHHagl>("range finder", H, R);
+
+	sym::ComputeEvBodyVelHx(state_vector, &H);
+	compareFusion<Ekf::SparseHBodyVel>("ev body vel", H, R);
+
+	sym::ComputeGnssYawPredInnovVarAndH(state_vector, P, 0.f, R, FLT_EPSILON, &pred, &innov_var, &H);
+	compareFusion<Ekf::SparseHAttitude>("gnss yaw", H, R);
+
+	sym::ComputeGravityXyzInnovVarAndHx(state_vector, P, R, &innov_var3, &H);
+	compareFusion<Ekf::SparseHAttitude>("gravity", H, R);
+}
+
+TEST_F(EkfSparseFusionTest, josephUpdateMatchesReference)
+{
+	const auto state_vector = _ekf_dense->state().vector();
+	const SquareMatrixState P = _ekf_dense->covariances();
+	const float R = sq(0.5f);
+	float pred;
+	float innov_var;
+	VectorState H;
+
+	sym::ComputeGnssYawPredInnovVarAndH(state_vector, P, 0.f, R, FLT_EPSILON, &pred, &innov_var, &H);
+
+	// use a sub-optimal gain, the update must still keep the covariance symmetric
+	VectorState K = 0.5f * P * H / innov_var;
+	_ekf_dense->measurementUpdate(K, Ekf::SparseHAttitude(H), R, 0.f);
+
+	// dense form of the Joseph stabilized covariance update using the gains actually applied by the filter
+	SquareMatrixState A = matrix::eye<float, State::size>();
+	A -= K.multiplyByTranspose(H);
+	const VectorState KR = K * R;
+	const SquareMatrixState P_expected = A * P * A.transpose() + KR.multiplyByTranspose(K);
+	const SquareMatrixState &P_updated = _ekf_dense->covariances();
+
+	for (unsigned i = 0; i < State::size; i++) {
+		for (unsigned j = 0; j < State::size; j++) {
+			EXPECT_NEAR(P_updated(i, j), P_expected(i, j), 1e-4f * fabsf(P_expected(i, j)) + 1e-9f)
+					<< "P(" << i << ", " << j << ")";
+			EXPECT_EQ(P_updated(i, j), P_updated(j, i));
+		}
+	}
+}
+
+TEST_F(EkfSparseFusionTest, batchedDirectStateFusionMatchesSequential)
+{
+	const float innov[3] = {0.3f, -0.2f, 0.1f};
+	const float R[3] = {sq(0.5f), sq(0.5f), sq(0.8f)};
+	float innov_var[3];
+
+	for (unsigned i = 0; i < 3; i++) {
+		innov_var[i] = _ekf_dense->stateCovariance(State::vel.idx + i, State::vel.idx + i) + R[i];
+	}
+
+	for (unsigned i = 0; i < 3; i++) {
+		_ekf_dense->fuseDirectStateMeasurement(innov[i], innov_var[i], R[i], State::vel.idx + i);
+	}
+
+	_ekf_sparse->fuseDirectStateMeasurements(innov, innov_var, R, State::vel.idx, 3);
+
+	// same sequence of covariance updates, only the state correction is applied at once
+	EXPECT_TRUE(matrix::isEqual(_ekf_dense->covariances(), _ekf_sparse->covariances(), 1e-9f));
+	EXPECT_TRUE(matrix::isEqual(_ekf_dense->state().vector(), _ekf_sparse->state().vector(), 1e-6f));
+}
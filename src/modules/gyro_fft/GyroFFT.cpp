@@ -73,6 +73,40 @@ bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
+	if (_param_imu_gyro_fft_mod.get() == static_cast<int32_t>(Mode::SlidingDFT)) {
+		switch (_param_imu_gyro_fft_len.get()) {
+		case 256:
+		case 512:
+		case 1024:
+			break;
+
+		default:
+			// otherwise default to 256
+			PX4_ERR("Invalid IMU_GYRO_FFT_LEN=%" PRId32 ", resetting", _param_imu_gyro_fft_len.get());
+			_param_imu_gyro_fft_len.set(256);
+			_param_imu_gyro_fft_len.commit();
+			break;
+		}
+
+		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
+
+		// sliding DFT buffers are allocated once the gyro sample rate is known
+		_peak_magnitudes_all = new float[_imu_gyro_fft_len];
+
+		if (_peak_magnitudes_all) {
+			_sliding_dft_enabled = true;
+
+			if (!SensorSelectionUpdate(true)) {
+				ScheduleDelayed(500_ms);
+			}
+
+			return true;
+		}
+
+		PX4_ERR("failed to allocate buffers");
+		return false;
+	}
+
 	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
 	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
 	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
@@ -266,34 +300,39 @@ static inline float tau(float x)
 	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
 }
 
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+// peak offset from the center bin (in bins) using Quinn's Second Estimator on the bins [k - 1, k, k + 1]
+static inline float quinn_estimator(const float real[3], const float imag[3])
 {
-	if (peak_index >= 2) {
-		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
-		float real[3] { (float)fft[peak_index - 2], (float)fft[peak_index], (float)fft[peak_index + 2]     };
-		float imag[3] { (float)fft[peak_index - 2 + 1], (float)fft[peak_index + 1], (float)fft[peak_index + 2 + 1] };
+	// (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
+	static constexpr int k = 1;
 
-		static constexpr int k = 1;
+	const float divider = (real[k] * real[k] + imag[k] * imag[k]);
 
-		const float divider = (real[k] * real[k] + imag[k] * imag[k]);
+	// ap = (X[k + 1].r * X[k].r + X[k+1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
+	float ap = (real[k + 1] * real[k] + imag[k + 1] * imag[k]) / divider;
 
-		// ap = (X[k + 1].r * X[k].r + X[k+1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
-		float ap = (real[k + 1] * real[k] + imag[k + 1] * imag[k]) / divider;
+	// dp = -ap / (1 – ap)
+	float dp = -ap  / (1.f - ap);
 
-		// dp = -ap / (1 – ap)
-		float dp = -ap  / (1.f - ap);
+	// am = (X[k - 1].r * X[k].r + X[k – 1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
+	float am = (real[k - 1] * real[k] + imag[k - 1] * imag[k]) / divider;
 
-		// am = (X[k - 1].r * X[k].r + X[k – 1].i * X[k].i) / (X[k].r * X[k].r + X[k].i * X[k].i)
-		float am = (real[k - 1] * real[k] + imag[k - 1] * imag[k]) / divider;
+	// dm = am / (1 – am)
+	float dm = am / (1.f - am);
 
-		// dm = am / (1 – am)
-		float dm = am / (1.f - am);
+	// d = (dp + dm) / 2 + tau(dp * dp) – tau(dm * dm)
+	return (dp + dm) / 2.f + tau(dp * dp) - tau(dm * dm);
+}
 
-		// d = (dp + dm) / 2 + tau(dp * dp) – tau(dm * dm)
-		float d = (dp + dm) / 2.f + tau(dp * dp) - tau(dm * dm);
+float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+{
+	if (peak_index >= 2) {
+		// find peak location using Quinn's Second Estimator
+		float real[3] { (float)fft[peak_index - 2], (float)fft[peak_index], (float)fft[peak_index + 2]     };
+		float imag[3] { (float)fft[peak_index - 2 + 1], (float)fft[peak_index + 1], (float)fft[peak_index + 2 + 1] };
 
 		// k’ = k + d
-		return peak_index + 2.f * d;
+		return peak_index + 2.f * quinn_estimator(real, imag);
 	}
 
 	return NAN;
@@ -326,6 +365,11 @@ void GyroFFT::Run()
 	const bool selection_updated = SensorSelectionUpdate();
 	VehicleIMUStatusUpdate(selection_updated);
 
+	if (_sliding_dft_enabled) {
+		// tracked bins depend on the gyro sample rate
+		SlidingDFTUpdateConfiguration();
+	}
+
 	// reset
 	_fft_updated = false;
 
@@ -336,9 +380,7 @@ void GyroFFT::Run()
 		while (_sensor_gyro_fifo_sub.update(&sensor_gyro_fifo)) {
 			if (_sensor_gyro_fifo_sub.get_last_generation() != _gyro_last_generation + 1) {
 				// force reset if we've missed a sample
-				_fft_buffer_index[0] = 0;
-				_fft_buffer_index[1] = 0;
-				_fft_buffer_index[2] = 0;
+				ResetBuffers();
 
 				perf_count(_gyro_fifo_generation_gap_perf);
 			}
@@ -347,9 +389,7 @@ void GyroFFT::Run()
 
 			if (fabsf(sensor_gyro_fifo.scale - _fifo_last_scale) > FLT_EPSILON) {
 				// force reset if scale has changed
-				_fft_buffer_index[0] = 0;
-				_fft_buffer_index[1] = 0;
-				_fft_buffer_index[2] = 0;
+				ResetBuffers();
 
 				_fifo_last_scale = sensor_gyro_fifo.scale;
 			}
@@ -365,9 +405,7 @@ void GyroFFT::Run()
 		while (_sensor_gyro_sub.update(&sensor_gyro)) {
 			if (_sensor_gyro_sub.get_last_generation() != _gyro_last_generation + 1) {
 				// force reset if we've missed a sample
-				_fft_buffer_index[0] = 0;
-				_fft_buffer_index[1] = 0;
-				_fft_buffer_index[2] = 0;
+				ResetBuffers();
 
 				perf_count(_gyro_generation_gap_perf);
 			}
@@ -392,8 +430,77 @@ void GyroFFT::Run()
 	perf_end(_cycle_perf);
 }
 
+void GyroFFT::ResetBuffers()
+{
+	for (int axis = 0; axis < 3; axis++) {
+		_fft_buffer_index[axis] = 0;
+		_sliding_dft[axis].reset();
+	}
+}
+
+void GyroFFT::SlidingDFTUpdateConfiguration()
+{
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	// Hann windowed bins covering IMU_GYRO_FFT_MIN - IMU_GYRO_FFT_MAX,
+	//  plus a neighbour on each side for the peak estimate
+	const int bin_min = math::max((int)floorf(_param_imu_gyro_fft_min.get() / resolution_hz) - 1, 1);
+	const int bin_max = math::min((int)ceilf(_param_imu_gyro_fft_max.get() / resolution_hz) + 1,
+				      _imu_gyro_fft_len / 2 - 1);
+
+	if ((bin_min != _sliding_dft_bin_min) || (bin_max != _sliding_dft_bin_max)) {
+		_sliding_dft_bin_min = bin_min;
+		_sliding_dft_bin_max = bin_max;
+
+		for (auto &sliding_dft : _sliding_dft) {
+			if (!sliding_dft.configure(_imu_gyro_fft_len, bin_min, bin_max)) {
+				PX4_ERR("sliding DFT configuration failed (bins %d - %d)", bin_min, bin_max);
+
+				// all axes or none, UpdateSlidingDFT() only checks the first one
+				for (auto &sliding_dft_axis : _sliding_dft) {
+					sliding_dft_axis.deconfigure();
+				}
+
+				return;
+			}
+		}
+
+		PX4_DEBUG("sliding DFT bins %d - %d (%.1f - %.1f Hz)", bin_min, bin_max,
+			  (double)(bin_min * resolution_hz), (double)(bin_max * resolution_hz));
+	}
+}
+
+void GyroFFT::UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
+{
+	if (!_sliding_dft[0].configured()) {
+		return;
+	}
+
+	perf_begin(_fft_perf);
+
+	for (int axis = 0; axis < 3; axis++) {
+		SlidingDFT &sliding_dft = _sliding_dft[axis];
+
+		for (int n = 0; n < N; n++) {
+			sliding_dft.update(input[axis][n]);
+		}
+
+		// update peak estimates with every sample batch once the window is full
+		if (sliding_dft.full()) {
+			FindPeaksSlidingDFT(timestamp_sample, axis);
+		}
+	}
+
+	perf_end(_fft_perf);
+}
+
 void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
 {
+	if (_sliding_dft_enabled) {
+		UpdateSlidingDFT(timestamp_sample, input, N);
+		return;
+	}
+
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
 	for (int axis = 0; axis < 3; axis++) {
@@ -484,6 +591,104 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 		}
 	}
 
+	float peak_frequencies_new[MAX_NUM_PEAKS];
+	float peak_snr_new[MAX_NUM_PEAKS];
+
+	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
+		peak_frequencies_new[peak_new] = NAN;
+		peak_snr_new[peak_new] = NAN;
+
+		if (raw_peak_index[peak_new] > 0) {
+
+			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
+
+			if (PX4_ISFINITE(adjusted_bin)) {
+				peak_frequencies_new[peak_new] = resolution_hz * adjusted_bin;
+
+				peak_snr_new[peak_new] = 10.f * log10f((_imu_gyro_fft_len - 1) * peak_magnitude[peak_new] /
+							       (bin_mag_sum - peak_magnitude[peak_new]));
+			}
+		}
+	}
+
+	SelectPeaks(timestamp_sample, axis, peak_frequencies_new, peak_snr_new);
+}
+
+void GyroFFT::FindPeaksSlidingDFT(const hrt_abstime &timestamp_sample, int axis)
+{
+	const SlidingDFT &sliding_dft = _sliding_dft[axis];
+
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	// Hann windowed magnitudes of the tracked bins, summed for SNR
+	float bin_mag_sum = 0;
+	int num_bins = 0;
+
+	for (int bin_index = sliding_dft.binMin(); bin_index <= sliding_dft.binMax(); bin_index++) {
+		float real;
+		float imag;
+		sliding_dft.windowed(bin_index, real, imag);
+
+		const float magnitude = sqrtf(real * real + imag * imag);
+
+		_peak_magnitudes_all[bin_index] = magnitude;
+		bin_mag_sum += magnitude;
+		num_bins++;
+	}
+
+	float peak_frequencies_new[MAX_NUM_PEAKS];
+	float peak_snr_new[MAX_NUM_PEAKS];
+
+	for (int i = 0; i < MAX_NUM_PEAKS; i++) {
+		peak_frequencies_new[i] = NAN;
+		peak_snr_new[i] = NAN;
+
+		float largest_peak = 0;
+		int largest_peak_index = 0;
+
+		// both neighbours are needed for the frequency estimate
+		for (int bin_index = sliding_dft.binMin() + 1; bin_index < sliding_dft.binMax(); bin_index++) {
+
+			const float freq_hz = bin_index * resolution_hz;
+
+			if ((_peak_magnitudes_all[bin_index] > largest_peak)
+			    && (freq_hz >= _param_imu_gyro_fft_min.get())
+			    && (freq_hz <= _param_imu_gyro_fft_max.get())) {
+
+				largest_peak = _peak_magnitudes_all[bin_index];
+				largest_peak_index = bin_index;
+			}
+		}
+
+		if (largest_peak_index > 1) {
+			float real[3];
+			float imag[3];
+
+			for (int k = 0; k < 3; k++) {
+				sliding_dft.windowed(largest_peak_index - 1 + k, real[k], imag[k]);
+			}
+
+			peak_frequencies_new[i] = resolution_hz * (largest_peak_index + quinn_estimator(real, imag));
+
+			// same scaling as the full FFT (total bins * peak / remaining energy), but only over the tracked band
+			peak_snr_new[i] = 10.f * log10f((2 * num_bins - 1) * largest_peak
+							/ (bin_mag_sum - largest_peak));
+
+			// remove peak + sides (included in frequency estimate)
+			_peak_magnitudes_all[largest_peak_index - 1] = 0;
+			_peak_magnitudes_all[largest_peak_index]     = 0;
+			_peak_magnitudes_all[largest_peak_index + 1] = 0;
+		}
+	}
+
+	SelectPeaks(timestamp_sample, axis, peak_frequencies_new, peak_snr_new);
+}
+
+void GyroFFT::SelectPeaks(const hrt_abstime &timestamp_sample, int axis,
+			  const float peak_frequencies_new[MAX_NUM_PEAKS], const float peak_snr_new[MAX_NUM_PEAKS])
+{
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
 	// keep if peak has been previously seen and SNR > MIN_SNR
 	//   or
 	// peak has SNR > MIN_SNR_INITIAL
@@ -502,40 +707,31 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	}
 
 	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
-		if (raw_peak_index[peak_new] > 0) {
-
-			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
-
-			if (PX4_ISFINITE(adjusted_bin)) {
-				const float freq_adjusted = resolution_hz * adjusted_bin;
-
-				const float snr = 10.f * log10f((_imu_gyro_fft_len - 1) * peak_magnitude[peak_new] /
-								(bin_mag_sum - peak_magnitude[peak_new]));
+		const float freq_adjusted = peak_frequencies_new[peak_new];
+		const float snr = peak_snr_new[peak_new];
 
-				if (PX4_ISFINITE(freq_adjusted)
-				    && (snr > MIN_SNR)
-				    && (freq_adjusted >= _param_imu_gyro_fft_min.get())
-				    && (freq_adjusted <= _param_imu_gyro_fft_max.get())) {
+		if (PX4_ISFINITE(freq_adjusted)
+		    && (snr > MIN_SNR)
+		    && (freq_adjusted >= _param_imu_gyro_fft_min.get())
+		    && (freq_adjusted <= _param_imu_gyro_fft_max.get())) {
 
-					// only keep if we're already tracking this frequency or if the SNR is significant
-					for (int peak_prev = 0; peak_prev < MAX_NUM_PEAKS; peak_prev++) {
-						bool snr_acceptable = (snr > _param_imu_gyro_fft_snr.get());
-						bool peak_close = (fabsf(freq_adjusted - peak_frequencies_prev[peak_prev]) < (resolution_hz * 0.25f));
-
-						if (snr_acceptable || peak_close) {
-							// keep
-							peak_frequencies[num_peaks_found] = freq_adjusted;
-							peak_snr[num_peaks_found] = snr;
+			// only keep if we're already tracking this frequency or if the SNR is significant
+			for (int peak_prev = 0; peak_prev < MAX_NUM_PEAKS; peak_prev++) {
+				bool snr_acceptable = (snr > _param_imu_gyro_fft_snr.get());
+				bool peak_close = (fabsf(freq_adjusted - peak_frequencies_prev[peak_prev]) < (resolution_hz * 0.25f));
 
-							// remove
-							if (peak_close) {
-								peak_frequencies_prev[peak_prev] = NAN;
-							}
+				if (snr_acceptable || peak_close) {
+					// keep
+					peak_frequencies[num_peaks_found] = freq_adjusted;
+					peak_snr[num_peaks_found] = snr;
 
-							num_peaks_found++;
-							break;
-						}
+					// remove
+					if (peak_close) {
+						peak_frequencies_prev[peak_prev] = NAN;
 					}
+
+					num_peaks_found++;
+					break;
 				}
 			}
 		}
@@ -56,6 +56,8 @@
 #include "arm_math.h"
 #include "arm_const_structs.h"
 
+#include "SlidingDFT.hpp"
+
 using namespace time_literals;
 
 class GyroFFT : public ModuleBase<GyroFFT>, public ModuleParams, public px4::ScheduledWorkItem
@@ -84,12 +86,23 @@ private:
 	static constexpr int MAX_NUM_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x) / sizeof(
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
+	enum class Mode : int32_t {
+		FFT        = 0,
+		SlidingDFT = 1,
+	};
+
 	void Run() override;
 	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
+	inline void FindPeaksSlidingDFT(const hrt_abstime &timestamp_sample, int axis);
 	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
 	inline void Publish();
+	void ResetBuffers();
+	inline void SelectPeaks(const hrt_abstime &timestamp_sample, int axis,
+				const float peak_frequencies_new[MAX_NUM_PEAKS], const float peak_snr_new[MAX_NUM_PEAKS]);
 	bool SensorSelectionUpdate(bool force = false);
+	void SlidingDFTUpdateConfiguration();
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
+	void UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
 	inline void UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float peak_frequencies[MAX_NUM_PEAKS],
 				 float peak_snr[MAX_NUM_PEAKS], int num_peaks_found);
 	void VehicleIMUStatusUpdate(bool force = false);
@@ -149,6 +162,12 @@ private:
 
 	int _fft_buffer_index[3] {};
 
+	// incremental spectrum (IMU_GYRO_FFT_MOD 1)
+	SlidingDFT _sliding_dft[3] {};
+	int _sliding_dft_bin_min{0};
+	int _sliding_dft_bin_max{0};
+	bool _sliding_dft_enabled{false};
+
 	unsigned _gyro_last_generation{0};
 
 	math::MedianFilter<float, 7> _median_filter[3][MAX_NUM_PEAKS] {};
@@ -164,6 +183,7 @@ private:
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
+		(ParamInt<px4::params::IMU_GYRO_FFT_MOD>) _param_imu_gyro_fft_mod,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
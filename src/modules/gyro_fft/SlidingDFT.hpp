@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SlidingDFT.hpp
+ *
+ * Sliding discrete Fourier transform of a single signal over a limited range of
+ * bins. Each new sample updates every tracked bin with one complex rotation, so
+ * the cost per sample is constant and proportional to the number of bins.
+ *
+ *   X_k(n) = e^(j2πk/N) * (r * X_k(n-1) + x(n) - r^N * x(n-N))
+ *
+ * The damping factor r (slightly below 1) keeps the recursion stable in single
+ * precision. The Hann window is applied in the frequency domain from the
+ * neighbouring bins, which is why one additional bin is tracked on each side.
+ */
+
+#pragma once
+
+#include <mathlib/math/Functions.hpp>
+#include <stdint.h>
+#include <string.h>
+
+class SlidingDFT
+{
+public:
+	SlidingDFT() = default;
+	~SlidingDFT() { deallocate(); }
+
+	SlidingDFT(const SlidingDFT &) = delete;
+	SlidingDFT &operator=(const SlidingDFT &) = delete;
+
+	/**
+	 * (Re)configure for a window length and the range of Hann windowed bins that will be read.
+	 *
+	 * @param length window length N
+	 * @param bin_min first windowed bin (>= 1)
+	 * @param bin_max last windowed bin (<= N/2 - 1)
+	 * @return true on success, all state is reset
+	 */
+	bool configure(int length, int bin_min, int bin_max)
+	{
+		if ((length < 4) || (bin_min < 1) || (bin_max > length / 2 - 1) || (bin_min > bin_max)) {
+			deallocate();
+			return false;
+		}
+
+		if ((length != _length) || (bin_max - bin_min + 3 != _bins)) {
+			deallocate();
+
+			_buffer = new int16_t[length];
+			_bins = bin_max - bin_min + 3;
+			_real = new float[_bins];
+			_imag = new float[_bins];
+			_twiddle_cos = new float[_bins];
+			_twiddle_sin = new float[_bins];
+
+			if (!_buffer || !_real || !_imag || !_twiddle_cos || !_twiddle_sin) {
+				deallocate();
+				return false;
+			}
+
+			_length = length;
+		}
+
+		// raw bins [bin_min - 1, bin_max + 1]
+		_bin_first = bin_min - 1;
+
+		for (int i = 0; i < _bins; i++) {
+			const float w = 2.f * M_PI_F * (_bin_first + i) / _length;
+			_twiddle_cos[i] = cosf(w);
+			_twiddle_sin[i] = sinf(w);
+		}
+
+		_damping_pow_length = powf(DAMPING, _length);
+
+		reset();
+		return true;
+	}
+
+	// release the buffers, configured() is false afterwards
+	void deconfigure() { deallocate(); }
+
+	void reset()
+	{
+		if (_buffer) {
+			memset(_buffer, 0, sizeof(_buffer[0]) * _length);
+
+			for (int i = 0; i < _bins; i++) {
+				_real[i] = 0.f;
+				_imag[i] = 0.f;
+			}
+		}
+
+		_buffer_index = 0;
+		_samples = 0;
+	}
+
+	inline void update(int16_t sample)
+	{
+		const float delta = sample - _damping_pow_length * _buffer[_buffer_index];
+
+		_buffer[_buffer_index] = sample;
+		_buffer_index = (_buffer_index + 1 < _length) ? (_buffer_index + 1) : 0;
+
+		if (_samples < _length) {
+			_samples++;
+		}
+
+		for (int i = 0; i < _bins; i++) {
+			const float real = DAMPING * _real[i] + delta;
+			const float imag = DAMPING * _imag[i];
+
+			_real[i] = real * _twiddle_cos[i] - imag * _twiddle_sin[i];
+			_imag[i] = real * _twiddle_sin[i] + imag * _twiddle_cos[i];
+		}
+	}
+
+	bool configured() const { return _buffer != nullptr; }
+
+	// true once a full window of samples has been processed
+	bool full() const { return configured() && (_samples >= _length); }
+
+	int binMin() const { return _bin_first + 1; }
+	int binMax() const { return _bin_first + _bins - 2; }
+
+	// Hann windowed bin, X_k = 0.5 * X_k - 0.25 * (X_k-1 + X_k+1)
+	void windowed(int bin, float &real, float &imag) const
+	{
+		const int i = bin - _bin_first;
+		real = 0.5f * _real[i] - 0.25f * (_real[i - 1] + _real[i + 1]);
+		imag = 0.5f * _imag[i] - 0.25f * (_imag[i - 1] + _imag[i + 1]);
+	}
+
+private:
+	static constexpr float DAMPING = 0.99999f;
+
+	void deallocate()
+	{
+		delete[] _buffer;
+		delete[] _real;
+		delete[] _imag;
+		delete[] _twiddle_cos;
+		delete[] _twiddle_sin;
+
+		_buffer = nullptr;
+		_real = nullptr;
+		_imag = nullptr;
+		_twiddle_cos = nullptr;
+		_twiddle_sin = nullptr;
+
+		_length = 0;
+		_bins = 0;
+	}
+
+	int16_t *_buffer{nullptr};
+
+	float *_real{nullptr};
+	float *_imag{nullptr};
+	float *_twiddle_cos{nullptr};
+	float *_twiddle_sin{nullptr};
+
+	float _damping_pow_length{1.f};
+
+	int _length{0};
+	int _bins{0};
+	int _bin_first{0};
+	int _buffer_index{0};
+	int _samples{0};
+};
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include "SlidingDFT.hpp"
+
+#include <math.h>
+
+static constexpr int LENGTH = 64;
+
+// Hann windowed DFT of the last LENGTH samples, computed directly
+static float directWindowedMagnitude(const int16_t *samples, int bin)
+{
+	double real = 0.0;
+	double imag = 0.0;
+
+	for (int m = 0; m < LENGTH; m++) {
+		const double window = 0.5 - 0.5 * cos(2.0 * M_PI * m / LENGTH);
+		const double w = 2.0 * M_PI * bin * m / LENGTH;
+		real += window * samples[m] * cos(w);
+		imag -= window * samples[m] * sin(w);
+	}
+
+	return (float)sqrt(real * real + imag * imag);
+}
+
+TEST(SlidingDFTTest, ConfigureBounds)
+{
+	SlidingDFT sdft;
+	EXPECT_FALSE(sdft.configured());
+
+	// window too short
+	EXPECT_FALSE(sdft.configure(2, 1, 1));
+	EXPECT_FALSE(sdft.configured());
+
+	// windowed bins need a neighbour on each side within [0, N/2]
+	EXPECT_FALSE(sdft.configure(LENGTH, 0, 10));
+	EXPECT_FALSE(sdft.configure(LENGTH, 1, LENGTH / 2));
+	EXPECT_FALSE(sdft.configured());
+
+	// empty range
+	EXPECT_FALSE(sdft.configure(LENGTH, 10, 9));
+
+	EXPECT_TRUE(sdft.configure(LENGTH, 1, LENGTH / 2 - 1));
+	EXPECT_TRUE(sdft.configured());
+	EXPECT_EQ(sdft.binMin(), 1);
+	EXPECT_EQ(sdft.binMax(), LENGTH / 2 - 1);
+
+	EXPECT_TRUE(sdft.configure(LENGTH, 5, 5));
+	EXPECT_EQ(sdft.binMin(), 5);
+	EXPECT_EQ(sdft.binMax(), 5);
+
+	// a failed configuration releases the previous one
+	EXPECT_FALSE(sdft.configure(LENGTH, 0, 5));
+	EXPECT_FALSE(sdft.configured());
+}
+
+TEST(SlidingDFTTest, WindowedBinMatchesDirectDFT)
+{
+	SlidingDFT sdft;
+	ASSERT_TRUE(sdft.configure(LENGTH, 2, 20));
+
+	// one sinusoid centred on bin 5 and one between bins 12 and 13
+	int16_t samples[3 * LENGTH];
+
+	for (int n = 0; n < 3 * LENGTH; n++) {
+		const float t = (float)n / LENGTH;
+		const float x = 8000.f * sinf(2.f * M_PI_F * 5.f * t) + 2000.f * cosf(2.f * M_PI_F * 12.4f * t);
+		samples[n] = (int16_t)roundf(x);
+		sdft.update(samples[n]);
+	}
+
+	ASSERT_TRUE(sdft.full());
+
+	const int16_t *window = &samples[2 * LENGTH];
+	const float peak = directWindowedMagnitude(window, 5);
+
+	// amplitude * N / 4 for a Hann windowed sinusoid centred on a bin
+	EXPECT_NEAR(peak, 8000.f * LENGTH / 4.f, 0.01f * 8000.f * LENGTH / 4.f);
+
+	for (int bin = sdft.binMin(); bin <= sdft.binMax(); bin++) {
+		float real;
+		float imag;
+		sdft.windowed(bin, real, imag);
+
+		const float magnitude = sqrtf(real * real + imag * imag);
+		EXPECT_NEAR(magnitude, directWindowedMagnitude(window, bin), 1e-3f * peak) << "bin " << bin;
+	}
+}
+
+TEST(SlidingDFTTest, FullAndReset)
+{
+	SlidingDFT sdft;
+	EXPECT_FALSE(sdft.full());
+
+	ASSERT_TRUE(sdft.configure(LENGTH, 4, 8));
+
+	for (int n = 0; n < LENGTH - 1; n++) {
+		sdft.update(1000);
+		EXPECT_FALSE(sdft.full());
+	}
+
+	sdft.update(1000);
+	EXPECT_TRUE(sdft.full());
+
+	sdft.update(1000);
+	EXPECT_TRUE(sdft.full());
+
+	sdft.reset();
+	EXPECT_FALSE(sdft.full());
+	EXPECT_TRUE(sdft.configured());
+
+	for (int bin = sdft.binMin(); bin <= sdft.binMax(); bin++) {
+		float real;
+		float imag;
+		sdft.windowed(bin, real, imag);
+		EXPECT_EQ(real, 0.f);
+		EXPECT_EQ(imag, 0.f);
+	}
+
+	// reconfiguring also starts a new window
+	sdft.update(1000);
+	ASSERT_TRUE(sdft.configure(LENGTH, 4, 8));
+	EXPECT_FALSE(sdft.full());
+
+	sdft.deconfigure();
+	EXPECT_FALSE(sdft.configured());
+	EXPECT_FALSE(sdft.full());
+}
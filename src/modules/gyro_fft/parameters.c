@@ -75,6 +75,21 @@ PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_MAX, 150.f);
 */
 PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 
+/**
+* IMU gyro FFT mode.
+*
+* Full FFT computes the whole spectrum each time the buffer of IMU_GYRO_FFT_LEN
+* samples is filled. Sliding DFT updates only the bins between IMU_GYRO_FFT_MIN
+* and IMU_GYRO_FFT_MAX with every sample and estimates the peaks after each
+* sensor update, giving a constant CPU load and lower peak tracking latency.
+*
+* @value 0 Full FFT
+* @value 1 Sliding DFT
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_MOD, 0);
+
 /**
 * IMU gyro FFT SNR.
 *
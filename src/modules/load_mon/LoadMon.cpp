@@ -101,6 +101,14 @@ void LoadMon::Run()
 
 	cpuload();
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	orb_latency();
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	work_item_stats();
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 #if defined(__PX4_NUTTX)
 
 	if (_param_sys_stck_en.get()) {
@@ -303,6 +311,64 @@ void LoadMon::stack_usage()
 }
 #endif
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+void LoadMon::orb_latency()
+{
+	// stay within the queue length so the logger doesn't miss any
+	for (int i = 0; i < orb_latency_s::ORB_QUEUE_LENGTH / 2; i++) {
+		orb_latency_s orb_latency{};
+
+		if (!uORB::Manager::orb_get_latency_statistics(_orb_latency_index, orb_latency)) {
+			// wrap around, continue with the first topic next cycle
+			_orb_latency_index = 0;
+			break;
+		}
+
+		orb_latency.timestamp = hrt_absolute_time();
+		_orb_latency_pub.publish(orb_latency);
+
+		_orb_latency_index++;
+	}
+}
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+void LoadMon::work_item_stats()
+{
+	// stay within the queue length so the logger doesn't miss any
+	for (int i = 0; i < work_item_stats_s::ORB_QUEUE_LENGTH / 2; i++) {
+		px4::WorkItemRunStatus status;
+
+		if (!px4::WorkQueueManagerRunStatus(_work_item_stats_index, status)) {
+			// wrap around, continue with the first work item next cycle
+			_work_item_stats_index = 0;
+			break;
+		}
+
+		static_assert(sizeof(work_item_stats_s::item_name) == sizeof(status.item_name), "item name size mismatch");
+		static_assert(sizeof(work_item_stats_s::wq_name) == sizeof(status.wq_name), "wq name size mismatch");
+		static_assert(work_item_stats_s::HISTOGRAM_BUCKETS == px4::WorkItemRunStats::HISTOGRAM_BUCKETS,
+			      "histogram size mismatch");
+
+		work_item_stats_s work_item_stats{};
+		memcpy(work_item_stats.item_name, status.item_name, sizeof(work_item_stats.item_name));
+		memcpy(work_item_stats.wq_name, status.wq_name, sizeof(work_item_stats.wq_name));
+		work_item_stats.interval = status.interval;
+		work_item_stats.run_count = status.stats.run_count;
+		memcpy(work_item_stats.execution_time_hist, status.stats.execution_time_hist,
+		       sizeof(work_item_stats.execution_time_hist));
+		memcpy(work_item_stats.latency_hist, status.stats.latency_hist, sizeof(work_item_stats.latency_hist));
+		work_item_stats.execution_time_max = status.stats.execution_time_max;
+		work_item_stats.latency_max = status.stats.latency_max;
+		work_item_stats.deadline_misses = status.stats.deadline_misses;
+		work_item_stats.timestamp = hrt_absolute_time();
+		_work_item_stats_pub.publish(work_item_stats);
+
+		_work_item_stats_index++;
+	}
+}
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 int LoadMon::print_usage(const char *reason)
 {
 	if (reason) {
@@ -48,6 +48,14 @@
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+#include <uORB/topics/orb_latency.h>
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+#include <uORB/topics/work_item_stats.h>
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
 #endif
@@ -92,6 +100,24 @@ private:
 #endif
 	uORB::Publication<cpuload_s> _cpuload_pub {ORB_ID(cpuload)};
 
+#if defined(CONFIG_ORB_LATENCY_STATS)
+	/* Publish the uORB latency statistics of a few topics per cycle */
+	void orb_latency();
+
+	int _orb_latency_index{0};
+
+	uORB::Publication<orb_latency_s> _orb_latency_pub{ORB_ID(orb_latency)};
+#endif // CONFIG_ORB_LATENCY_STATS
+
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	/* Publish the run statistics of a few work items per cycle */
+	void work_item_stats();
+
+	unsigned _work_item_stats_index{0};
+
+	uORB::Publication<work_item_stats_s> _work_item_stats_pub{ORB_ID(work_item_stats)};
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 #if defined(__PX4_LINUX)
 	FILE *_proc_fd = nullptr;
 	/* calculate usage directly from clock ticks on Linux */
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "log_compressor.h"
+
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+constexpr size_t LogCompressor::max_input_size;
+constexpr size_t LogCompressor::max_frame_size;
+
+size_t LogCompressor::compress(const uint8_t *data, size_t size)
+{
+	static_assert(max_input_size <= UINT16_MAX, "frame size does not fit into the frame header");
+
+	ulog_compressed_frame_header_s header;
+	uint8_t *out = &_frame[sizeof(header)];
+
+	// the compressed frame must be smaller than the input, otherwise it is stored
+	const size_t out_capacity = size - 1;
+	size_t in_len = 0;
+	size_t out_len = 0;
+	bool done = false;
+
+	heatshrink_encoder_reset(&_hse);
+
+	while (!done && out_len < out_capacity) {
+		size_t count = 0;
+
+		if (in_len < size) {
+			uint8_t *in = const_cast<uint8_t *>(&data[in_len]); // the encoder does not modify the input
+
+			if (heatshrink_encoder_sink(&_hse, in, size - in_len, &count) < 0) {
+				break;
+			}
+
+			in_len += count;
+		}
+
+		if (in_len == size) {
+			const HSE_finish_res fres = heatshrink_encoder_finish(&_hse);
+
+			if (fres == HSER_FINISH_DONE) {
+				done = true;
+				break;
+
+			} else if (fres != HSER_FINISH_MORE) {
+				break;
+			}
+		}
+
+		if (heatshrink_encoder_poll(&_hse, &out[out_len], out_capacity - out_len, &count) < 0) {
+			break;
+		}
+
+		out_len += count;
+	}
+
+	if (done) {
+		header.compressed_size = out_len;
+
+	} else {
+		memcpy(out, data, size);
+		header.compressed_size = size;
+	}
+
+	header.uncompressed_size = size;
+	memcpy(_frame, &header, sizeof(header));
+
+	return sizeof(header) + header.compressed_size;
+}
+
+}
+}
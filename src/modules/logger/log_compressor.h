@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "messages.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HEATSHRINK_DYNAMIC_ALLOC 0 // same as the heatshrink library build
+#include <lib/heatshrink/heatshrink/heatshrink_encoder.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class LogCompressor
+ * Compresses blocks of log data into independent frames (@see ulog_compressed_frame_header_s)
+ */
+class LogCompressor
+{
+public:
+	static constexpr size_t max_input_size = 4096; ///< maximum number of uncompressed bytes per frame
+	static constexpr size_t max_frame_size = sizeof(ulog_compressed_frame_header_s) + max_input_size;
+
+	/**
+	 * Compress a block of data into a frame. Data that does not compress is stored instead.
+	 * @param data input data
+	 * @param size number of input bytes, 0 < size <= max_input_size
+	 * @return frame size in bytes (including the frame header), @see frame()
+	 */
+	size_t compress(const uint8_t *data, size_t size);
+
+	const uint8_t *frame() const { return _frame; }
+
+private:
+	heatshrink_encoder _hse;
+	uint8_t _frame[max_frame_size];
+};
+
+}
+}
@@ -126,6 +126,31 @@ public:
 		return 0;
 	}
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	size_t get_file_size_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_file_size(type); }
+
+		return 0;
+	}
+
+	void set_compression_file(bool enable)
+	{
+		if (_log_writer_file) { _log_writer_file->set_compression(enable); }
+	}
+
+	/**
+	 * whether messages of the given type currently end up in a compressed file. This is false if the file
+	 * backend is not selected for writing.
+	 */
+	bool is_compressed_file(LogType type) const
+	{
+		if (_log_writer_file_for_write) { return _log_writer_file_for_write->is_compressed(type); }
+
+		return false;
+	}
+#endif
+
 	size_t get_buffer_size_file(LogType type) const
 	{
 		if (_log_writer_file) { return _log_writer_file->get_buffer_size(type); }
@@ -248,7 +248,12 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 
 #endif
 
-	if (_buffers[(int)type].start_log(filename)) {
+	bool compress = false;
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	compress = _compression && type == LogType::Full;
+#endif
+
+	if (_buffers[(int)type].start_log(filename, compress)) {
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
 		notify();
 		return true;
@@ -429,13 +434,13 @@ void LogWriterFile::run()
 
 #endif
 
-					int written = buffer.write_to_file(read_ptr, available, call_fsync);
+					int written = buffer.write_data(read_ptr, available, call_fsync);
 
 					if (written < 0) {
 						// retry once
 						PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
 						px4_usleep(10000); // 10 milliseconds
-						written = buffer.write_to_file(read_ptr, available, call_fsync);
+						written = buffer.write_data(read_ptr, available, call_fsync);
 					}
 
 					/* buffer.mark_read() requires _mtx to be locked */
@@ -604,6 +609,10 @@ LogWriterFile::LogFileBuffer::~LogFileBuffer()
 
 	free(_buffer);
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	delete _compressor;
+#endif
+
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
 }
@@ -649,7 +658,7 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 	}
 }
 
-bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
+bool LogWriterFile::LogFileBuffer::start_log(const char *filename, bool compress)
 {
 	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
 	_had_write_error.store(false);
@@ -670,6 +679,29 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 		}
 	}
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (compress && _compressor == nullptr) {
+		_compressor = new LogCompressor();
+
+		if (_compressor == nullptr) {
+			PX4_ERR("Can't create log compressor");
+			::close(_fd);
+			_fd = -1;
+			return false;
+		}
+	}
+
+	_compress = compress;
+	// the ULog header and the flag bits are stored uncompressed, so that readers can detect the format
+	_raw_remaining = sizeof(ulog_file_header_s) + sizeof(ulog_message_flag_bits_s);
+	_frame_size = 0;
+	_frame_written = 0;
+	_file_size = 0;
+#else
+	(void)compress;
+#endif
+
 	// Clear buffer and counters
 	_head = 0;
 	_count = 0;
@@ -700,9 +732,92 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 	return ret;
 }
 
+ssize_t LogWriterFile::LogFileBuffer::write_data(const void *buffer, size_t size, bool call_fsync)
+{
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (_compress) {
+		return write_compressed(static_cast<const uint8_t *>(buffer), size, call_fsync);
+	}
+
+#endif
+
+	return write_to_file(buffer, size, call_fsync);
+}
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+ssize_t LogWriterFile::LogFileBuffer::write_compressed(const uint8_t *buffer, size_t size, bool call_fsync)
+{
+	size_t consumed = 0;
+
+	if (_raw_remaining > 0) {
+		const ssize_t ret = write_to_file(buffer, math::min(size, _raw_remaining), false);
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		_raw_remaining -= ret;
+		_file_size += ret;
+		consumed += ret;
+	}
+
+	while (_raw_remaining == 0) {
+		// finish an interrupted frame first. The input of a frame counts as consumed once it is compressed.
+		if (!write_pending_frame()) {
+			if (consumed == 0) {
+				return -1;
+			}
+
+			break;
+		}
+
+		if (consumed == size) {
+			break;
+		}
+
+		const size_t chunk = math::min(size - consumed, LogCompressor::max_input_size);
+		_frame_size = _compressor->compress(&buffer[consumed], chunk);
+		_frame_written = 0;
+		consumed += chunk;
+	}
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	return consumed;
+}
+
+bool LogWriterFile::LogFileBuffer::write_pending_frame()
+{
+	while (_frame_written < _frame_size) {
+		const ssize_t ret = write_to_file(&_compressor->frame()[_frame_written], _frame_size - _frame_written,
+						  false);
+
+		if (ret <= 0) {
+			return false;
+		}
+
+		_frame_written += ret;
+		_file_size += ret;
+	}
+
+	return true;
+}
+#endif // CONFIG_LOGGER_COMPRESSION
+
 void LogWriterFile::LogFileBuffer::close_file()
 {
 	if (_fd >= 0) {
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+		if (_compress && !write_pending_frame()) {
+			PX4_WARN("writing last compressed frame failed (%i)", errno);
+		}
+
+#endif
+
 		int res = close(_fd);
 
 		if (res) {
@@ -41,6 +41,10 @@
 #include <perf/perf_counter.h>
 #include <px4_platform_common/crypto.h>
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+#include "log_compressor.h"
+#endif
+
 namespace px4
 {
 namespace logger
@@ -108,6 +112,20 @@ public:
 		return _buffers[(int)type].total_written();
 	}
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	size_t get_file_size(LogType type) const
+	{
+		return _buffers[(int)type].file_size();
+	}
+
+	/**
+	 * Enable compression for the next full log file. This has to be called before start_log().
+	 */
+	void set_compression(bool enable) { _compression = enable; }
+
+	bool is_compressed(LogType type) const { return _buffers[(int)type].is_compressed(); }
+#endif
+
 	size_t get_buffer_size(LogType type) const
 	{
 		return _buffers[(int)type].buffer_size();
@@ -173,7 +191,7 @@ private:
 
 		~LogFileBuffer();
 
-		bool start_log(const char *filename);
+		bool start_log(const char *filename, bool compress);
 
 		void close_file();
 
@@ -192,6 +210,12 @@ private:
 
 		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
 
+		/**
+		 * Write data from the buffer to the file, compressing it if enabled
+		 * @return number of bytes consumed from the buffer, <0 on error
+		 */
+		ssize_t write_data(const void *buffer, size_t size, bool call_fsync);
+
 		inline void fsync() const;
 
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
@@ -199,6 +223,10 @@ private:
 		size_t total_written() const { return _total_written; }
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
+#if defined(CONFIG_LOGGER_COMPRESSION)
+		size_t file_size() const { return _compress ? _file_size : _total_written; }
+		bool is_compressed() const { return _compress; }
+#endif
 
 		bool _should_run = false;
 		px4::atomic_bool _had_write_error{false};
@@ -211,6 +239,22 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+#if defined(CONFIG_LOGGER_COMPRESSION)
+		ssize_t write_compressed(const uint8_t *buffer, size_t size, bool call_fsync);
+
+		/**
+		 * Write the remainder of the current frame, a frame is only complete once all of it is in the file
+		 * @return true if the frame is completely written
+		 */
+		bool write_pending_frame();
+
+		bool _compress = false;
+		LogCompressor *_compressor = nullptr;
+		size_t _raw_remaining = 0; ///< number of bytes at the start of the file that are stored uncompressed
+		size_t _frame_size = 0;
+		size_t _frame_written = 0;
+		size_t _file_size = 0;
+#endif
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
@@ -221,6 +265,9 @@ private:
 	pthread_mutex_t		_mtx;
 	pthread_cond_t		_cv;
 	pthread_t _thread = 0;
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	bool _compression = false;
+#endif
 #if defined(PX4_CRYPTO)
 	bool init_logfile_encryption(const char *filename);
 	PX4Crypto _crypto;
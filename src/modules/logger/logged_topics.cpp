@@ -141,6 +141,11 @@ void LoggedTopics::add_default_topics()
 	add_optional_topic("vtol_vehicle_status", 200);
 	add_topic("wind", 1000);
 
+#if defined(CONFIG_PX4_WQ_RUN_STATS)
+	// only published by load_mon with the work queue run statistics enabled
+	add_topic("work_item_stats");
+#endif // CONFIG_PX4_WQ_RUN_STATS
+
 	// multi topics
 	add_optional_topic_multi("actuator_outputs", 100, 3);
 	add_optional_topic_multi("airspeed_wind", 1000, 4);
@@ -275,6 +280,7 @@ void LoggedTopics::add_debug_topics()
 	add_topic("mag_worker_data");
 	add_topic("sensor_preflight_mag", 500);
 	add_topic("actuator_test", 500);
+	add_topic("orb_latency");
 }
 
 void LoggedTopics::add_estimator_replay_topics()
@@ -297,6 +303,20 @@ void LoggedTopics::add_estimator_replay_topics()
 	add_topic_multi("distance_sensor");
 }
 
+void LoggedTopics::set_delta_encoded_topics()
+{
+	set_delta_encoding("battery_status");
+	set_delta_encoding("estimator_event_flags");
+	set_delta_encoding("estimator_status");
+	set_delta_encoding("estimator_status_flags");
+	set_delta_encoding("failsafe_flags");
+	set_delta_encoding("position_setpoint_triplet");
+	set_delta_encoding("sensors_status_imu");
+	set_delta_encoding("vehicle_control_mode");
+	set_delta_encoding("vehicle_imu_status");
+	set_delta_encoding("vehicle_status");
+}
+
 void LoggedTopics::add_thermal_calibration_topics()
 {
 	add_topic_multi("sensor_accel", 100, 4);
@@ -487,6 +507,17 @@ bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t ins
 	return success;
 }
 
+void LoggedTopics::set_delta_encoding(const char *name, uint16_t keyframe_interval_ms)
+{
+	for (int i = 0; i < _subscriptions.count; ++i) {
+		RequestedSubscription &sub = _subscriptions.sub[i];
+
+		if (strcmp(name, get_orb_meta(sub.id)->o_name) == 0) {
+			sub.keyframe_interval_ms = keyframe_interval_ms;
+		}
+	}
+}
+
 bool LoggedTopics::add_topic_multi(const char *name, uint16_t interval_ms, uint8_t max_num_instances, bool optional)
 {
 	// add all possible instances
@@ -508,6 +539,8 @@ bool LoggedTopics::initialize_logged_topics(SDLogProfileMask profile)
 		initialize_configured_topics(profile);
 	}
 
+	set_delta_encoded_topics();
+
 	return _subscriptions.count > 0;
 }
 
@@ -81,6 +81,7 @@ public:
 
 	struct RequestedSubscription {
 		uint16_t interval_ms;
+		uint16_t keyframe_interval_ms{0}; ///< 0 to log full samples, otherwise delta encode with keyframes
 		uint8_t instance;
 		ORB_ID id{ORB_ID::INVALID};
 	};
@@ -159,11 +160,21 @@ private:
 	 */
 	void add_mission_topic(const char *name, uint16_t interval_ms = 0);
 
+	/**
+	 * Log all added instances of a topic delta encoded against the previous sample (if enabled in the logger).
+	 * This reduces the log size for large topics where most fields rarely change.
+	 * @param name topic name
+	 * @param keyframe_interval_ms maximum interval between full samples, which allow to seek within a log
+	 */
+	void set_delta_encoding(const char *name, uint16_t keyframe_interval_ms = 1000);
+
 	/**
 	 * Add topic subscriptions based on the profile configuration
 	 */
 	void initialize_configured_topics(SDLogProfileMask profile);
 
+	void set_delta_encoded_topics();
+
 	void add_default_topics();
 	void add_estimator_replay_topics();
 	void add_thermal_calibration_topics();
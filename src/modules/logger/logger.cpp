@@ -242,6 +242,16 @@ void Logger::print_statistics(LogType type)
 		PX4_INFO("Wrote %4.2f MiB (avg %5.2f KiB/s)", (double)mebibytes, (double)(kibibytes / seconds));
 	}
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (_writer.is_compressed_file(type) && kibibytes > 0.f) {
+		const float file_kibibytes = _writer.get_file_size_file(type) / 1024.0f;
+		PX4_INFO("Compressed to %4.2f KiB (%.1f %%)", (double)file_kibibytes,
+			 (double)(100.f * file_kibibytes / kibibytes));
+	}
+
+#endif
+
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 stats.write_dropouts, (double)stats.max_dropout_duration, stats.high_water, _writer.get_buffer_size_file(type));
 	stats.high_water = 0;
@@ -416,6 +426,10 @@ Logger::~Logger()
 
 	delete[](_msg_buffer);
 	delete[](_subscriptions);
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	delete[](_delta_msg_buffer);
+	delete[](_delta_samples);
+#endif
 }
 
 void Logger::update_params()
@@ -566,6 +580,44 @@ bool Logger::initialize_topics()
 	}
 
 	_num_subscriptions = logged_topics.subscriptions().count;
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	delete[](_delta_samples);
+	_delta_samples = nullptr;
+
+	if (_param_sdlog_delta.get()) {
+		size_t delta_samples_size = 0;
+
+		for (int i = 0; i < _num_subscriptions; ++i) {
+			if (logged_topics.subscriptions().sub[i].keyframe_interval_ms > 0) {
+				delta_samples_size += _subscriptions[i].get_topic()->o_size_no_padding;
+			}
+		}
+
+		if (delta_samples_size > 0) {
+			_delta_samples = new uint8_t[delta_samples_size];
+
+			if (!_delta_samples) {
+				PX4_ERR("alloc failed, delta encoding disabled");
+				return true;
+			}
+
+			size_t offset = 0;
+
+			for (int i = 0; i < _num_subscriptions; ++i) {
+				const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
+
+				if (sub.keyframe_interval_ms > 0) {
+					_subscriptions[i].last_sample = &_delta_samples[offset];
+					_subscriptions[i].keyframe_interval = sub.keyframe_interval_ms * 1000;
+					offset += _subscriptions[i].get_topic()->o_size_no_padding;
+				}
+			}
+		}
+	}
+
+#endif
+
 	return true;
 }
 
@@ -637,6 +689,18 @@ void Logger::run()
 		}
 	}
 
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (_delta_samples && !_delta_msg_buffer) {
+		_delta_msg_buffer = new uint8_t[_msg_buffer_len];
+
+		if (!_delta_msg_buffer) {
+			PX4_ERR("failed to alloc delta message buffer");
+		}
+	}
+
+#endif
+
 
 	if (!_writer.init()) {
 		PX4_ERR("writer init failed");
@@ -772,10 +836,29 @@ void Logger::run()
 					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
 
 					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+					void *full_log_msg = _msg_buffer;
+					size_t full_log_msg_size = msg_size;
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+					const size_t delta_msg_size = encode_delta_message(sub, msg_size, loop_time);
+
+					if (delta_msg_size > 0) {
+						full_log_msg = _delta_msg_buffer;
+						full_log_msg_size = delta_msg_size;
+					}
+
+#endif
+
+					const bool written = write_message(LogType::Full, full_log_msg, full_log_msg_size);
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+					update_delta_state(sub, msg_size, written, delta_msg_size == 0, loop_time);
+#endif
+
+					if (written) {
 
 #ifdef DBGPRINT
-						total_bytes += msg_size;
+						total_bytes += full_log_msg_size;
 #endif /* DBGPRINT */
 					}
 
@@ -1303,11 +1386,18 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		replay_suffix = "_replayed";
 	}
 
-	const char *crypto_suffix = "";
+	const char *file_suffix = "";
 #if defined(PX4_CRYPTO)
 
 	if (_param_sdlog_crypto_algorithm.get() != 0) {
-		crypto_suffix = "c";
+		file_suffix = "c";
+	}
+
+#endif
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (type == LogType::Full && compression_enabled()) {
+		file_suffix = "z";
 	}
 
 #endif
@@ -1324,7 +1414,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		char log_file_name_time[16] = "";
 		strftime(log_file_name_time, sizeof(log_file_name_time), "%H_%M_%S", &tt);
 		snprintf(log_file_name, sizeof(LogFileName::log_file_name), "%s%s.ulg%s", log_file_name_time, replay_suffix,
-			 crypto_suffix);
+			 file_suffix);
 		snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 		if (notify) {
@@ -1355,7 +1445,7 @@ int Logger::get_log_file_name(LogType type, char *file_name, size_t file_name_si
 		while (file_number <= MAX_NO_LOGFILE) {
 			/* format log file path: e.g. /fs/microsd/log/sess001/log001.ulg */
 			snprintf(log_file_name, sizeof(LogFileName::log_file_name), "log%03" PRIu16 "%s.ulg%s", file_number, replay_suffix,
-				 crypto_suffix);
+				 file_suffix);
 			snprintf(file_name + n, file_name_size - n, "/%s", log_file_name);
 
 			if (!util::file_exist(file_name)) {
@@ -1419,6 +1509,18 @@ void Logger::start_log_file(LogType type)
 		(px4_crypto_algorithm_t)_param_sdlog_crypto_algorithm.get(),
 		_param_sdlog_crypto_key.get(),
 		_param_sdlog_crypto_exchange_key.get());
+#endif
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	_writer.set_compression_file(compression_enabled());
+#endif
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (type == LogType::Full) {
+		// mavlink streaming needs full samples, so only use delta encoding if the file is the only backend
+		_delta_encoding_file = _delta_msg_buffer != nullptr
+				       && !_writer.is_started(LogType::Full, LogWriter::BackendMavlink);
+	}
+
 #endif
 
 	if (_writer.start_log_file(type, file_name)) {
@@ -1863,8 +1965,123 @@ void Logger::write_add_logged_msg(LogType type, LoggerSubscription &subscription
 	_writer.set_need_reliable_transfer(true);
 	write_message(type, &msg, msg_size);
 	_writer.set_need_reliable_transfer(prev_reliable);
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (type == LogType::Full) {
+		// readers start decoding at the first data message after subscribing
+		subscription.keyframe_required = true;
+	}
+
+#endif
+}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+size_t Logger::encode_delta_message(LoggerSubscription &subscription, size_t msg_size, hrt_abstime now)
+{
+	if (!subscription.last_sample || !_delta_encoding_file || subscription.keyframe_required
+	    || now - subscription.last_keyframe >= subscription.keyframe_interval
+	    || _writer.is_started(LogType::Full, LogWriter::BackendMavlink)) {
+		return 0;
+	}
+
+	const size_t header_size = sizeof(ulog_message_data_delta_s);
+	static_assert(sizeof(ulog_message_data_delta_s) == sizeof(ulog_message_data_s), "header size mismatch");
+
+	// only use the delta message if it is smaller than the full one
+	const int encoded_size = encode_delta(_msg_buffer + sizeof(ulog_message_data_s), subscription.last_sample,
+					      msg_size - sizeof(ulog_message_data_s), _delta_msg_buffer + header_size,
+					      msg_size - header_size - 1);
+
+	if (encoded_size < 0) {
+		return 0;
+	}
+
+	const size_t delta_msg_size = header_size + encoded_size;
+	const uint16_t write_msg_size = static_cast<uint16_t>(delta_msg_size - ULOG_MSG_HEADER_LEN);
+	_delta_msg_buffer[0] = (uint8_t)write_msg_size;
+	_delta_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_delta_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+	_delta_msg_buffer[3] = _msg_buffer[3]; // msg_id
+	_delta_msg_buffer[4] = _msg_buffer[4];
+
+	return delta_msg_size;
+}
+
+void Logger::update_delta_state(LoggerSubscription &subscription, size_t msg_size, bool written, bool keyframe,
+				hrt_abstime now)
+{
+	if (!subscription.last_sample) {
+		return;
+	}
+
+	if (written) {
+		memcpy(subscription.last_sample, _msg_buffer + sizeof(ulog_message_data_s),
+		       msg_size - sizeof(ulog_message_data_s));
+
+		if (keyframe) {
+			subscription.keyframe_required = false;
+			subscription.last_keyframe = now;
+		}
+
+	} else {
+		// the reader does not have the previous sample
+		subscription.keyframe_required = true;
+	}
 }
 
+int Logger::encode_delta(const uint8_t *sample, const uint8_t *previous, size_t size, uint8_t *out,
+			 size_t max_size)
+{
+	size_t out_len = 0;
+	size_t i = 0;
+
+	while (i < size) {
+		size_t unchanged = 0;
+
+		while (i < size && unchanged < UINT8_MAX && sample[i] == previous[i]) {
+			++i;
+			++unchanged;
+		}
+
+		if (i == size) {
+			break; // trailing unchanged bytes are implicit
+		}
+
+		// changed bytes, including unchanged gaps shorter than a run header
+		size_t end = i;
+		size_t j = i;
+
+		while (j < size && j - i < UINT8_MAX) {
+			if (sample[j] != previous[j]) {
+				end = ++j;
+
+			} else if (j - end < 2) {
+				++j;
+
+			} else {
+				break;
+			}
+		}
+
+		const size_t changed = end - i;
+
+		if (out_len + 2 + changed > max_size) {
+			return -1;
+		}
+
+		out[out_len++] = unchanged;
+		out[out_len++] = changed;
+
+		for (; i < end; ++i) {
+			out[out_len++] = sample[i] ^ previous[i];
+		}
+	}
+
+	return out_len;
+}
+#endif // CONFIG_LOGGER_DELTA_ENCODING
+
 void Logger::write_info(LogType type, const char *name, const char *value)
 {
 	_writer.lock();
@@ -2034,6 +2251,21 @@ void Logger::write_header(LogType type)
 
 	flag_bits.compat_flags[0] = ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK;
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+
+	if (_writer.is_compressed_file(type)) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK;
+	}
+
+#endif
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (type == LogType::Full && _delta_encoding_file && !_writer.is_started(type, LogWriter::BackendMavlink)) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DELTA_MASK;
+	}
+
+#endif
+
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
@@ -2042,6 +2274,22 @@ void Logger::write_header(LogType type)
 	_writer.unlock();
 }
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+bool Logger::compression_enabled() const
+{
+#if defined(PX4_CRYPTO)
+
+	// encrypted data does not compress
+	if (_param_sdlog_crypto_algorithm.get() != 0) {
+		return false;
+	}
+
+#endif
+
+	return _param_sdlog_compress.get();
+}
+#endif
+
 void Logger::write_version(LogType type)
 {
 	write_info(type, "ver_sw", px4_firmware_version_string());
@@ -79,6 +79,13 @@ struct LoggerSubscription : public uORB::SubscriptionInterval {
 	{}
 
 	uint8_t msg_id{MSG_ID_INVALID};
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	uint8_t *last_sample{nullptr}; ///< last sample written to the full log if delta encoded (owned by Logger)
+	hrt_abstime keyframe_interval{0};
+	hrt_abstime last_keyframe{0};
+	bool keyframe_required{true};
+#endif
 };
 
 class Logger : public ModuleBase<Logger>, public ModuleParams
@@ -198,6 +205,28 @@ private:
 	 */
 	void write_add_logged_msg(LogType type, LoggerSubscription &subscription);
 
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	/**
+	 * Delta encode the data message in _msg_buffer into _delta_msg_buffer, if enabled for the subscription
+	 * and no keyframe is due.
+	 * @return size of the delta message, 0 if the full message has to be written
+	 */
+	size_t encode_delta_message(LoggerSubscription &subscription, size_t msg_size, hrt_abstime now);
+
+	/**
+	 * Update the delta encoding state after writing a data message of the subscription to the full log
+	 */
+	void update_delta_state(LoggerSubscription &subscription, size_t msg_size, bool written, bool keyframe,
+				hrt_abstime now);
+
+	/**
+	 * XOR and run-length encode a sample against the previous one (@see ulog_message_data_delta_s)
+	 * @return encoded size, or -1 if it would exceed max_size
+	 */
+	static int encode_delta(const uint8_t *sample, const uint8_t *previous, size_t size, uint8_t *out,
+				size_t max_size);
+#endif
+
 	/**
 	 * Create logging directory
 	 * @param type
@@ -236,6 +265,13 @@ private:
 	 */
 	void write_header(LogType type);
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	/**
+	 * @return true if the full log is written compressed (@see SDLOG_COMPRESS)
+	 */
+	bool compression_enabled() const;
+#endif
+
 	void write_formats(LogType type);
 
 	/**
@@ -340,6 +376,11 @@ private:
 
 	uint8_t						*_msg_buffer{nullptr};
 	int						_msg_buffer_len{0};
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	uint8_t						*_delta_msg_buffer{nullptr};
+	uint8_t						*_delta_samples{nullptr}; ///< last samples of all delta encoded subscriptions
+	bool						_delta_encoding_file{false}; ///< delta encoding is enabled for the current file
+#endif
 
 	LogFileName					_file_name[(int)LogType::Count];
 
@@ -402,6 +443,12 @@ private:
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
 		(ParamInt<px4::params::SDLOG_EXCH_KEY>) _param_sdlog_crypto_exchange_key
+#endif
+#if defined(CONFIG_LOGGER_COMPRESSION)
+		, (ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress
+#endif
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+		, (ParamBool<px4::params::SDLOG_DELTA>) _param_sdlog_delta
 #endif
 	)
 };
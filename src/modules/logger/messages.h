@@ -49,6 +49,7 @@ enum class ULogMessageType : uint8_t {
 	LOGGING = 'L',
 	LOGGING_TAGGED = 'C',
 	FLAG_BITS = 'B',
+	DATA_DELTA = 'X',
 };
 
 
@@ -179,6 +180,19 @@ struct ulog_message_data_s {
 	uint16_t msg_id;
 };
 
+/**
+ * @brief Delta encoded Data Message (only with ULOG_INCOMPAT_FLAG0_DELTA_MASK)
+ * Contains the same data as a ulog_message_data_s, encoded against the previous data message with the same msg_id.
+ * The msg_id part is followed by runs of: uint8_t number of unchanged bytes, uint8_t number of changed bytes n,
+ * then n bytes XOR'ed with the previous message. Bytes after the last run are unchanged.
+ */
+struct ulog_message_data_delta_s {
+	uint16_t msg_size; ///< size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+
+	uint16_t msg_id;
+};
+
 /**
  * @brief Information Message
  *
@@ -282,6 +296,8 @@ struct ulog_message_parameter_default_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK (1<<1) ///< data after the flag bits is stored in compressed frames
+#define ULOG_INCOMPAT_FLAG0_DELTA_MASK (1<<2) ///< the log contains delta encoded data messages
 
 #define ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK (1<<0)
 
@@ -294,4 +310,15 @@ struct ulog_message_flag_bits_s {
 	uint64_t appended_offsets[3]; ///< file offset(s) for appended data if ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK is set
 };
 
+/**
+ * If ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK is set, everything following the flag bits message (up to
+ * appended_offsets[0] if data was appended) is a sequence of frames, each consisting of this header followed by
+ * compressed_size bytes. Every frame is compressed independently with heatshrink (window size 8, lookahead 4).
+ * Frames that do not compress are stored as-is, which is indicated by compressed_size == uncompressed_size.
+ */
+struct ulog_compressed_frame_header_s {
+	uint16_t compressed_size; ///< number of bytes following the frame header
+	uint16_t uncompressed_size;
+};
+
 #pragma pack(pop)
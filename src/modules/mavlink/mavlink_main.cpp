@@ -740,6 +740,16 @@ void Mavlink::send_start(int length)
 	pthread_mutex_lock(&_send_mutex);
 	_last_write_try_time = hrt_absolute_time();
 
+#if defined(MAVLINK_UDP)
+
+	// make room for the message in the transmit batch
+	if (_tx_batch && ((_tx_batch->count >= TxBatch::MAX_MESSAGES)
+			  || (_tx_batch->fill + (unsigned)length > sizeof(_tx_batch->buf)))) {
+		send_tx_batch_locked();
+	}
+
+#endif // MAVLINK_UDP
+
 	// check if there is space in the buffer
 	if (length > (int)get_free_tx_buf()) {
 		// not enough space in buffer to send
@@ -762,6 +772,20 @@ void Mavlink::send_finish()
 		return;
 	}
 
+#if defined(MAVLINK_UDP)
+
+	if (_tx_batch) {
+		// the message is already in the batch buffer (see send_bytes()), it's sent with send_tx_batch()
+		_tx_batch->len[_tx_batch->count++] = _buf_fill;
+		_tx_batch->fill += _buf_fill;
+		_buf_fill = 0;
+
+		pthread_mutex_unlock(&_send_mutex);
+		return;
+	}
+
+#endif // MAVLINK_UDP
+
 	int ret = -1;
 
 	// send message to UART
@@ -825,6 +849,24 @@ void Mavlink::send_finish()
 
 void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 {
+#if defined(MAVLINK_UDP)
+
+	if (_tx_batch) {
+		if (!_tx_buffer_low) {
+			if (_tx_batch->fill + _buf_fill + packet_len <= sizeof(_tx_batch->buf)) {
+				memcpy(&_tx_batch->buf[_tx_batch->fill + _buf_fill], buf, packet_len);
+				_buf_fill += packet_len;
+
+			} else {
+				perf_count(_send_byte_error_perf);
+			}
+		}
+
+		return;
+	}
+
+#endif // MAVLINK_UDP
+
 	if (!_tx_buffer_low) {
 		if (_buf_fill + packet_len < sizeof(_buf)) {
 			memcpy(&_buf[_buf_fill], buf, packet_len);
@@ -837,6 +879,119 @@ void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 }
 
 #ifdef MAVLINK_UDP
+void Mavlink::send_tx_batch()
+{
+	if (_tx_batch) {
+		LockGuard lg{_send_mutex};
+		send_tx_batch_locked();
+	}
+}
+
+void Mavlink::send_tx_batch_locked()
+{
+	if (_tx_batch->count == 0) {
+		return;
+	}
+
+	int sent = -1;
+
+# if defined(CONFIG_NET)
+
+	if (_src_addr_initialized) {
+# endif // CONFIG_NET
+		sent = send_tx_batch_to(_src_addr);
+# if defined(CONFIG_NET)
+	}
+
+# endif // CONFIG_NET
+
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized() || !is_gcs_connected())) {
+
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
+		}
+
+		if (_broadcast_address_found) {
+			if (send_tx_batch_to(_bcast_addr) < _tx_batch->count) {
+				if (!_broadcast_failed_warned) {
+					PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
+					_broadcast_failed_warned = true;
+				}
+
+			} else {
+				_broadcast_failed_warned = false;
+			}
+		}
+	}
+
+	for (int i = 0; i < _tx_batch->count; i++) {
+		if (i < sent) {
+			_tstatus.tx_message_count++;
+			count_txbytes(_tx_batch->len[i]);
+
+		} else {
+			count_txerrbytes(_tx_batch->len[i]);
+		}
+	}
+
+	if (sent > 0) {
+		_last_write_success_time = _last_write_try_time;
+	}
+
+	_tx_batch->count = 0;
+	_tx_batch->fill = 0;
+}
+
+int Mavlink::send_tx_batch_to(const sockaddr_in &addr)
+{
+	int sent = 0;
+
+# if defined(__PX4_LINUX)
+	// one system call for the whole batch
+	unsigned offset = 0;
+
+	for (int i = 0; i < _tx_batch->count; i++) {
+		_tx_batch->iov[i].iov_base = &_tx_batch->buf[offset];
+		_tx_batch->iov[i].iov_len = _tx_batch->len[i];
+		offset += _tx_batch->len[i];
+
+		_tx_batch->msgs[i] = {};
+		_tx_batch->msgs[i].msg_hdr.msg_name = const_cast<sockaddr_in *>(&addr);
+		_tx_batch->msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+		_tx_batch->msgs[i].msg_hdr.msg_iov = &_tx_batch->iov[i];
+		_tx_batch->msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while (sent < _tx_batch->count) {
+		const int ret = sendmmsg(_socket_fd, &_tx_batch->msgs[sent], _tx_batch->count - sent, 0);
+
+		if (ret <= 0) {
+			break;
+		}
+
+		sent += ret;
+	}
+
+# else
+	unsigned offset = 0;
+
+	for (; sent < _tx_batch->count; sent++) {
+		const int ret = sendto(_socket_fd, &_tx_batch->buf[offset], _tx_batch->len[sent], 0,
+				       (const struct sockaddr *)&addr, sizeof(addr));
+
+		if (ret != (int)_tx_batch->len[sent]) {
+			break;
+		}
+
+		offset += _tx_batch->len[sent];
+	}
+
+# endif // __PX4_LINUX
+
+	return sent;
+}
+
 void Mavlink::find_broadcast_address()
 {
 	struct ifconf ifconf;
@@ -1277,17 +1432,14 @@ Mavlink::close_shell()
 void
 Mavlink::update_rate_mult()
 {
-	float const_rate = 0.0f;
-	float rate = 0.0f;
+	/* bandwidth needed by each priority class at the configured stream rates */
+	float demand[MavlinkStream::PRIORITY_COUNT] {};
+	float demand_total = 0.f;
 
-	/* scale down rates if their theoretical bandwidth is exceeding the link bandwidth */
 	for (const auto &stream : _streams) {
-		if (stream->const_rate()) {
-			const_rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
-
-		} else {
-			rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
-		}
+		const float bandwidth = stream->get_bandwidth();
+		demand[(int)stream->priority()] += bandwidth;
+		demand_total += bandwidth;
 	}
 
 	float mavlink_ulog_streaming_rate_inv = 1.0f;
@@ -1296,13 +1448,8 @@ Mavlink::update_rate_mult()
 		mavlink_ulog_streaming_rate_inv = 1.0f - _mavlink_ulog->current_data_rate();
 	}
 
-	/* scale up and down as the link permits */
-	float bandwidth_mult = (float)(_datarate * mavlink_ulog_streaming_rate_inv - const_rate) / rate;
-
-	/* if we do not have flow control, limit to the set data rate */
-	if (!get_flow_control_enabled()) {
-		bandwidth_mult = fminf(1.0f, bandwidth_mult);
-	}
+	/* link budget for the streams */
+	float budget = _datarate * mavlink_ulog_streaming_rate_inv;
 
 	float hardware_mult = 1.0f;
 	bool log_radio_timeout = false;
@@ -1335,11 +1482,35 @@ Mavlink::update_rate_mult()
 		PX4_ERR("instance %d: RADIO_STATUS timeout", _instance_id);
 	}
 
-	/* pick the minimum from bandwidth mult and hardware mult as limit */
-	_rate_mult = fminf(bandwidth_mult, hardware_mult);
+	/* the measured link throughput (TX errors, RADIO_STATUS) limits the budget further */
+	if (hardware_mult < 1.0f) {
+		budget = fminf(budget, hardware_mult * demand_total);
+	}
+
+	/* assign the budget in priority order, critical streams always keep their configured rate */
+	float remaining = budget;
+	float assigned = 0.f;
+
+	for (int i = 0; i < MavlinkStream::PRIORITY_COUNT; i++) {
+		float mult = 1.0f;
+
+		if ((i != (int)MavlinkStream::Priority::CRITICAL) && (demand[i] > 0.f)) {
+			/* ensure the rate multiplier never drops below 5% so that something is always sent */
+			mult = math::constrain(remaining / demand[i], 0.05f, 1.0f);
+			assigned += demand[i] * mult;
+		}
+
+		_priority_rate_mult[i] = mult;
+		remaining = fmaxf(remaining - demand[i] * mult, 0.f);
+	}
+
+	for (const auto &stream : _streams) {
+		stream->set_rate_mult(_priority_rate_mult[(int)stream->priority()]);
+	}
 
-	/* ensure the rate multiplier never drops below 5% so that something is always sent */
-	_rate_mult = math::constrain(_rate_mult, 0.05f, 1.0f);
+	/* overall multiplier of the rate adjusted streams */
+	const float demand_adjusted = demand_total - demand[(int)MavlinkStream::Priority::CRITICAL];
+	_rate_mult = (demand_adjusted > 0.f) ? (assigned / demand_adjusted) : 1.0f;
 }
 
 void
@@ -1860,7 +2031,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:F:fswxzZp", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:F:fswxzZpBW", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -2080,6 +2251,10 @@ Mavlink::task_main(int argc, char *argv[])
 			_ftp_on = true;
 			break;
 
+		case 'W':
+			_component_worker_on = true;
+			break;
+
 		case 'z':
 			_flow_control = FLOW_CONTROL_ON;
 			break;
@@ -2088,6 +2263,13 @@ Mavlink::task_main(int argc, char *argv[])
 			_flow_control = FLOW_CONTROL_OFF;
 			break;
 
+#if defined(MAVLINK_UDP)
+
+		case 'B':
+			_tx_batch_enabled = true;
+			break;
+#endif // MAVLINK_UDP
+
 		default:
 			err_flag = true;
 			break;
@@ -2152,6 +2334,14 @@ Mavlink::task_main(int argc, char *argv[])
 
 		PX4_INFO("mode: %s, data rate: %d B/s on udp port %hu remote port %hu",
 			 mavlink_mode_str(_mode), _datarate, _network_port, _remote_port);
+
+		if (_tx_batch_enabled) {
+			_tx_batch = new TxBatch();
+
+			if (_tx_batch == nullptr) {
+				PX4_ERR("transmit batch alloc failed");
+			}
+		}
 	}
 
 #endif // MAVLINK_UDP
@@ -2285,6 +2475,9 @@ Mavlink::task_main(int argc, char *argv[])
 			handleStatus();
 			handleCommands();
 			handleAndGetCurrentCommandAck();
+#if defined(MAVLINK_UDP)
+			send_tx_batch();
+#endif // MAVLINK_UDP
 			continue;
 		}
 
@@ -2328,19 +2521,25 @@ Mavlink::task_main(int argc, char *argv[])
 
 		check_requested_subscriptions();
 
-		/* update streams */
-		for (const auto &stream : _streams) {
-			stream->update(t);
+		/* update streams, in priority order so that higher priorities get the TX buffer first */
+		for (int priority = 0; priority < MavlinkStream::PRIORITY_COUNT; priority++) {
+			for (const auto &stream : _streams) {
+				if ((int)stream->priority() != priority) {
+					continue;
+				}
 
-			if (!_first_heartbeat_sent) {
-				if (_mode == MAVLINK_MODE_IRIDIUM) {
-					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
+				stream->update(t);
 
-				} else {
-					if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
-						_first_heartbeat_sent = stream->first_message_sent();
+				if (!_first_heartbeat_sent) {
+					if (_mode == MAVLINK_MODE_IRIDIUM) {
+						if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+							_first_heartbeat_sent = stream->first_message_sent();
+						}
+
+					} else {
+						if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
+							_first_heartbeat_sent = stream->first_message_sent();
+						}
 					}
 				}
 			}
@@ -2407,6 +2606,11 @@ Mavlink::task_main(int argc, char *argv[])
 			}
 		}
 
+#if defined(MAVLINK_UDP)
+		/* send everything queued during this cycle */
+		send_tx_batch();
+#endif // MAVLINK_UDP
+
 		/* update TX/RX rates*/
 		if (t > _bytes_timestamp + 1_s) {
 			if (_bytes_timestamp != 0) {
@@ -2447,6 +2651,16 @@ Mavlink::task_main(int argc, char *argv[])
 		::close(_uart_fd);
 	}
 
+#if defined(MAVLINK_UDP)
+
+	if (_tx_batch) {
+		send_tx_batch();
+		delete _tx_batch;
+		_tx_batch = nullptr;
+	}
+
+#endif // MAVLINK_UDP
+
 	if (_socket_fd >= 0) {
 		close(_socket_fd);
 		_socket_fd = -1;
@@ -2921,7 +3135,9 @@ Mavlink::display_status()
 	printf("\trates:\n");
 	printf("\t  tx: %.1f B/s\n", (double)_tstatus.tx_rate_avg);
 	printf("\t  txerr: %.1f B/s\n", (double)_tstatus.tx_error_rate_avg);
-	printf("\t  tx rate mult: %.3f\n", (double)_rate_mult);
+	printf("\t  tx rate mult: %.3f (critical %.3f, high %.3f, normal %.3f, low %.3f)\n", (double)_rate_mult,
+	       (double)_priority_rate_mult[0], (double)_priority_rate_mult[1], (double)_priority_rate_mult[2],
+	       (double)_priority_rate_mult[3]);
 	printf("\t  tx rate max: %i B/s\n", _datarate);
 	printf("\t  rx: %.1f B/s\n", (double)_tstatus.rx_rate_avg);
 	printf("\t  rx loss: %.1f%%\n", (double)_tstatus.rx_message_lost_rate);
@@ -2956,6 +3172,8 @@ Mavlink::display_status()
 		printf("UDP (%hu, remote port: %hu)\n", _network_port, _remote_port);
 		printf("\tBroadcast enabled: %s\n",
 		       broadcast_enabled() ? "YES" : "NO");
+		printf("\tBatched transmission: %s\n",
+		       _tx_batch ? "YES" : "NO");
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 		printf("\tMulticast enabled: %s\n",
 		       multicast_enabled() ? "YES" : "NO");
@@ -2988,9 +3206,9 @@ Mavlink::display_status()
 void
 Mavlink::display_status_streams()
 {
-	printf("\t%-20s%-16s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]");
+	printf("\t%-20s%-16s %s %s\n", "Name", "Rate Config (current) [Hz]", "Priority", "Message Size (if active) [B]");
 
-	const float rate_mult = _rate_mult;
+	static constexpr const char *priority_str[MavlinkStream::PRIORITY_COUNT] {"critical", "high", "normal", "low"};
 
 	for (const auto &stream : _streams) {
 		const int interval = stream->get_interval();
@@ -3004,11 +3222,11 @@ Mavlink::display_status_streams()
 			float rate = 1000000.0f / (float)interval;
 			// Note that the actual current rate can be lower if the associated uORB topic updates at a
 			// lower rate.
-			float rate_current = stream->const_rate() ? rate : rate * rate_mult;
+			float rate_current = stream->const_rate() ? rate : rate * stream->get_rate_mult();
 			snprintf(rate_str, sizeof(rate_str), "%6.2f (%.3f)", (double)rate, (double)rate_current);
 		}
 
-		printf("\t%-30s%-16s", stream->get_name(), rate_str);
+		printf("\t%-30s%-16s %-8s", stream->get_name(), rate_str, priority_str[(int)stream->priority()]);
 
 		if (size > 0) {
 			printf(" %3u\n", size);
@@ -3328,8 +3546,10 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_FLAG('f', "Enable message forwarding to other Mavlink instances", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('w', "Wait to send, until first message received", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('x', "Enable FTP", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('W', "Handle mission, parameter, FTP and log messages on a separate thread", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('z', "Force hardware flow control always on", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('Z', "Force hardware flow control always off", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('B', "Batch UDP transmission per update cycle (sendmmsg on Linux)", true);
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("stop-all", "Stop all instances");
 
@@ -58,6 +58,11 @@
 #include <netinet/in.h>
 #endif
 
+#if defined(__PX4_LINUX)
+#include <sys/socket.h> // sendmmsg
+#include <sys/uio.h>
+#endif
+
 #include <containers/List.hpp>
 #include <parameters/param.h>
 #include <lib/variable_length_ringbuffer/VariableLengthRingbuffer.hpp>
@@ -343,6 +348,11 @@ public:
 	 */
 	void             	send_finish();
 
+	/**
+	 * Send all messages collected in the transmit batch (UDP batching mode, see send_finish())
+	 */
+	void			send_tx_batch();
+
 	/**
 	 * Resend message as is, don't change sequence number and CRC.
 	 */
@@ -495,6 +505,7 @@ public:
 
 	const events::SendProtocol &get_events_protocol() const { return _events; };
 	bool ftp_enabled() const { return _ftp_on; }
+	bool component_worker_enabled() const { return _component_worker_on; }
 
 	bool hash_check_enabled() const { return _param_mav_hash_chk_en.get(); }
 	bool forward_heartbeats_enabled() const { return _param_mav_hb_forw_en.get(); }
@@ -577,6 +588,7 @@ private:
 
 	bool			_forwarding_on{false};
 	bool			_ftp_on{false};
+	bool			_component_worker_on{false};
 	bool			_use_software_mav_throttling{false};
 
 	int			_uart_fd{-1};
@@ -584,6 +596,7 @@ private:
 	int			_baudrate{57600};
 	int			_datarate{1000};		///< data rate for normal streams (attitude, position, etc.)
 	float			_rate_mult{1.0f};
+	float			_priority_rate_mult[MavlinkStream::PRIORITY_COUNT] {1.0f, 1.0f, 1.0f, 1.0f};
 	float			_high_latency_freq{0.015f};	///< frequency of HIGH_LATENCY2 stream
 
 	bool			_radio_status_available{false};
@@ -633,6 +646,31 @@ private:
 	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
 	unsigned		_buf_fill{0};
 
+#if defined(MAVLINK_UDP)
+	/**
+	 * UDP transmit batch: messages are written directly into the batch buffer and sent once per
+	 * update cycle (or when the batch is full), each message in its own datagram.
+	 */
+	struct TxBatch {
+		static constexpr int MAX_MESSAGES{32};
+
+		uint8_t buf[MAX_MESSAGES * MAVLINK_MAX_PACKET_LEN];
+		uint16_t len[MAX_MESSAGES];
+		unsigned fill{0};
+		int count{0};
+# if defined(__PX4_LINUX)
+		iovec iov[MAX_MESSAGES];
+		mmsghdr msgs[MAX_MESSAGES];
+# endif // __PX4_LINUX
+	};
+
+	TxBatch			*_tx_batch{nullptr};
+	bool			_tx_batch_enabled{false};
+
+	void			send_tx_batch_locked();
+	int			send_tx_batch_to(const sockaddr_in &addr);
+#endif // MAVLINK_UDP
+
 	bool			_tx_buffer_low{false};
 
 	const char 		*_interface_name{nullptr};
@@ -88,6 +88,8 @@ MavlinkReceiver::~MavlinkReceiver()
 	_sensor_baro_pub.unadvertise();
 	_sensor_gps_pub.unadvertise();
 	_sensor_optical_flow_pub.unadvertise();
+
+	perf_free(_component_worker_overflow_perf);
 }
 
 static constexpr vehicle_odometry_s vehicle_odometry_empty {
@@ -115,6 +117,11 @@ MavlinkReceiver::MavlinkReceiver(Mavlink &parent) :
 	_parameters_manager(parent),
 	_mavlink_timesync(parent)
 {
+	for (size_t i = 0; i < message_handlers_count; i++) {
+		if (message_handlers[i].msgid < MESSAGE_HANDLER_INDEX_SIZE) {
+			_message_handler_index[message_handlers[i].msgid] = i + 1;
+		}
+	}
 }
 
 void
@@ -132,250 +139,175 @@ MavlinkReceiver::acknowledge(uint8_t sysid, uint8_t compid, uint16_t command, ui
 	_cmd_ack_pub.publish(command_ack);
 }
 
-void
-MavlinkReceiver::handle_message(mavlink_message_t *msg)
-{
-	switch (msg->msgid) {
-	case MAVLINK_MSG_ID_COMMAND_LONG:
-		handle_message_command_long(msg);
-		break;
-
-	case MAVLINK_MSG_ID_COMMAND_INT:
-		handle_message_command_int(msg);
-		break;
-
-	case MAVLINK_MSG_ID_COMMAND_ACK:
-		handle_message_command_ack(msg);
-		break;
-
-	case MAVLINK_MSG_ID_OPTICAL_FLOW_RAD:
-		handle_message_optical_flow_rad(msg);
-		break;
-
-	case MAVLINK_MSG_ID_PING:
-		handle_message_ping(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SET_MODE:
-		handle_message_set_mode(msg);
-		break;
-
-	case MAVLINK_MSG_ID_ATT_POS_MOCAP:
-		handle_message_att_pos_mocap(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
-		handle_message_set_position_target_local_ned(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
-		handle_message_set_position_target_global_int(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
-		handle_message_set_attitude_target(msg);
-		break;
-
-	case MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE:
-		handle_message_vision_position_estimate(msg);
-		break;
-
-	case MAVLINK_MSG_ID_ODOMETRY:
-		handle_message_odometry(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN:
-		handle_message_set_gps_global_origin(msg);
-		break;
-
-	case MAVLINK_MSG_ID_RADIO_STATUS:
-		handle_message_radio_status(msg);
-		break;
-
-	case MAVLINK_MSG_ID_MANUAL_CONTROL:
-		handle_message_manual_control(msg);
-		break;
-
-	case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
-		handle_message_rc_channels_override(msg);
-		break;
-
-	case MAVLINK_MSG_ID_HEARTBEAT:
-		handle_message_heartbeat(msg);
-		break;
-
-	case MAVLINK_MSG_ID_DISTANCE_SENSOR:
-		handle_message_distance_sensor(msg);
-		break;
-
-	case MAVLINK_MSG_ID_FOLLOW_TARGET:
-		handle_message_follow_target(msg);
-		break;
-
-	case MAVLINK_MSG_ID_LANDING_TARGET:
-		handle_message_landing_target(msg);
-		break;
-
-	case MAVLINK_MSG_ID_CELLULAR_STATUS:
-		handle_message_cellular_status(msg);
-		break;
-
-	case MAVLINK_MSG_ID_ADSB_VEHICLE:
-		handle_message_adsb_vehicle(msg);
-		break;
-
-	case MAVLINK_MSG_ID_COLLISION:
-		handle_message_collision(msg);
-		break;
-
-	case MAVLINK_MSG_ID_GPS_RTCM_DATA:
-		handle_message_gps_rtcm_data(msg);
-		break;
-
-	case MAVLINK_MSG_ID_BATTERY_STATUS:
-		handle_message_battery_status(msg);
-		break;
-
-	case MAVLINK_MSG_ID_SERIAL_CONTROL:
-		handle_message_serial_control(msg);
-		break;
-
-	case MAVLINK_MSG_ID_LOGGING_ACK:
-		handle_message_logging_ack(msg);
-		break;
-
-	case MAVLINK_MSG_ID_PLAY_TUNE:
-		handle_message_play_tune(msg);
-		break;
-
-	case MAVLINK_MSG_ID_PLAY_TUNE_V2:
-		handle_message_play_tune_v2(msg);
-		break;
-
-	case MAVLINK_MSG_ID_OBSTACLE_DISTANCE:
-		handle_message_obstacle_distance(msg);
-		break;
-
-	case MAVLINK_MSG_ID_TUNNEL:
-		handle_message_tunnel(msg);
-		break;
-
-	case MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_BEZIER:
-		handle_message_trajectory_representation_bezier(msg);
-		break;
-
-	case MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_WAYPOINTS:
-		handle_message_trajectory_representation_waypoints(msg);
-		break;
-
-	case MAVLINK_MSG_ID_ONBOARD_COMPUTER_STATUS:
-		handle_message_onboard_computer_status(msg);
-		break;
-
-	case MAVLINK_MSG_ID_GENERATOR_STATUS:
-		handle_message_generator_status(msg);
-		break;
-
-	case MAVLINK_MSG_ID_STATUSTEXT:
-		handle_message_statustext(msg);
-		break;
-
+// Message handler dispatch table. Messages handled by the mission manager, the parameter manager, FTP and the log
+// handler are listed as COMPONENT messages, these may be handled on the component worker thread (see Mavlink -W).
+#define MESSAGE_HANDLER(id, name, filter) \
+	{MAVLINK_MSG_ID_##id, &MavlinkReceiver::handle_message_##name, MessageFilter::filter}
+#define COMPONENT_MESSAGE(id) \
+	{MAVLINK_MSG_ID_##id, &MavlinkReceiver::handle_message_component, MessageFilter::COMPONENT}
+
+const MavlinkReceiver::MessageHandler MavlinkReceiver::message_handlers[] = {
+	MESSAGE_HANDLER(COMMAND_LONG, command_long, ALWAYS),
+	MESSAGE_HANDLER(COMMAND_INT, command_int, ALWAYS),
+	MESSAGE_HANDLER(COMMAND_ACK, command_ack, ALWAYS),
+	MESSAGE_HANDLER(OPTICAL_FLOW_RAD, optical_flow_rad, ALWAYS),
+	MESSAGE_HANDLER(PING, ping, ALWAYS),
+	MESSAGE_HANDLER(SET_MODE, set_mode, ALWAYS),
+	MESSAGE_HANDLER(ATT_POS_MOCAP, att_pos_mocap, ALWAYS),
+	MESSAGE_HANDLER(SET_POSITION_TARGET_LOCAL_NED, set_position_target_local_ned, ALWAYS),
+	MESSAGE_HANDLER(SET_POSITION_TARGET_GLOBAL_INT, set_position_target_global_int, ALWAYS),
+	MESSAGE_HANDLER(SET_ATTITUDE_TARGET, set_attitude_target, ALWAYS),
+	MESSAGE_HANDLER(VISION_POSITION_ESTIMATE, vision_position_estimate, ALWAYS),
+	MESSAGE_HANDLER(ODOMETRY, odometry, ALWAYS),
+	MESSAGE_HANDLER(SET_GPS_GLOBAL_ORIGIN, set_gps_global_origin, ALWAYS),
+	MESSAGE_HANDLER(RADIO_STATUS, radio_status, ALWAYS),
+	MESSAGE_HANDLER(MANUAL_CONTROL, manual_control, ALWAYS),
+	MESSAGE_HANDLER(RC_CHANNELS_OVERRIDE, rc_channels_override, ALWAYS),
+	MESSAGE_HANDLER(HEARTBEAT, heartbeat, ALWAYS),
+	MESSAGE_HANDLER(DISTANCE_SENSOR, distance_sensor, ALWAYS),
+	MESSAGE_HANDLER(FOLLOW_TARGET, follow_target, ALWAYS),
+	MESSAGE_HANDLER(LANDING_TARGET, landing_target, ALWAYS),
+	MESSAGE_HANDLER(CELLULAR_STATUS, cellular_status, ALWAYS),
+	MESSAGE_HANDLER(ADSB_VEHICLE, adsb_vehicle, ALWAYS),
+	MESSAGE_HANDLER(COLLISION, collision, ALWAYS),
+	MESSAGE_HANDLER(GPS_RTCM_DATA, gps_rtcm_data, ALWAYS),
+	MESSAGE_HANDLER(BATTERY_STATUS, battery_status, ALWAYS),
+	MESSAGE_HANDLER(SERIAL_CONTROL, serial_control, ALWAYS),
+	MESSAGE_HANDLER(LOGGING_ACK, logging_ack, ALWAYS),
+	MESSAGE_HANDLER(PLAY_TUNE, play_tune, ALWAYS),
+	MESSAGE_HANDLER(PLAY_TUNE_V2, play_tune_v2, ALWAYS),
+	MESSAGE_HANDLER(OBSTACLE_DISTANCE, obstacle_distance, ALWAYS),
+	MESSAGE_HANDLER(TUNNEL, tunnel, ALWAYS),
+	MESSAGE_HANDLER(TRAJECTORY_REPRESENTATION_BEZIER, trajectory_representation_bezier, ALWAYS),
+	MESSAGE_HANDLER(TRAJECTORY_REPRESENTATION_WAYPOINTS, trajectory_representation_waypoints, ALWAYS),
+	MESSAGE_HANDLER(ONBOARD_COMPUTER_STATUS, onboard_computer_status, ALWAYS),
+	MESSAGE_HANDLER(GENERATOR_STATUS, generator_status, ALWAYS),
+	MESSAGE_HANDLER(STATUSTEXT, statustext, ALWAYS),
 #if !defined(CONSTRAINED_FLASH)
-
-	case MAVLINK_MSG_ID_NAMED_VALUE_FLOAT:
-		handle_message_named_value_float(msg);
-		break;
-
-	case MAVLINK_MSG_ID_NAMED_VALUE_INT:
-		handle_message_named_value_int(msg);
-		break;
-
-	case MAVLINK_MSG_ID_DEBUG:
-		handle_message_debug(msg);
-		break;
-
-	case MAVLINK_MSG_ID_DEBUG_VECT:
-		handle_message_debug_vect(msg);
-		break;
-
-	case MAVLINK_MSG_ID_DEBUG_FLOAT_ARRAY:
-		handle_message_debug_float_array(msg);
-		break;
+	MESSAGE_HANDLER(NAMED_VALUE_FLOAT, named_value_float, ALWAYS),
+	MESSAGE_HANDLER(NAMED_VALUE_INT, named_value_int, ALWAYS),
+	MESSAGE_HANDLER(DEBUG, debug, ALWAYS),
+	MESSAGE_HANDLER(DEBUG_VECT, debug_vect, ALWAYS),
+	MESSAGE_HANDLER(DEBUG_FLOAT_ARRAY, debug_float_array, ALWAYS),
 #endif // !CONSTRAINED_FLASH
+	MESSAGE_HANDLER(GIMBAL_MANAGER_SET_ATTITUDE, gimbal_manager_set_attitude, ALWAYS),
+	MESSAGE_HANDLER(GIMBAL_MANAGER_SET_MANUAL_CONTROL, gimbal_manager_set_manual_control, ALWAYS),
+	MESSAGE_HANDLER(GIMBAL_DEVICE_INFORMATION, gimbal_device_information, ALWAYS),
+	MESSAGE_HANDLER(REQUEST_EVENT, request_event, ALWAYS),
+	MESSAGE_HANDLER(GIMBAL_DEVICE_ATTITUDE_STATUS, gimbal_device_attitude_status, ALWAYS),
+#if defined(MAVLINK_MSG_ID_SET_VELOCITY_LIMITS) // For now only defined if development.xml is used
+	MESSAGE_HANDLER(SET_VELOCITY_LIMITS, set_velocity_limits, ALWAYS),
+#endif
+	MESSAGE_HANDLER(HIL_SENSOR, hil_sensor, HIL),
+	MESSAGE_HANDLER(HIL_STATE_QUATERNION, hil_state_quaternion, HIL),
+	MESSAGE_HANDLER(HIL_OPTICAL_FLOW, hil_optical_flow, HIL),
+	MESSAGE_HANDLER(HIL_GPS, hil_gps, HIL_GPS),
+
+	COMPONENT_MESSAGE(MISSION_ACK),
+	COMPONENT_MESSAGE(MISSION_SET_CURRENT),
+	COMPONENT_MESSAGE(MISSION_REQUEST_LIST),
+	COMPONENT_MESSAGE(MISSION_REQUEST),
+	COMPONENT_MESSAGE(MISSION_REQUEST_INT),
+	COMPONENT_MESSAGE(MISSION_COUNT),
+	COMPONENT_MESSAGE(MISSION_ITEM),
+	COMPONENT_MESSAGE(MISSION_ITEM_INT),
+	COMPONENT_MESSAGE(MISSION_CLEAR_ALL),
+	COMPONENT_MESSAGE(PARAM_REQUEST_LIST),
+	COMPONENT_MESSAGE(PARAM_SET),
+	COMPONENT_MESSAGE(PARAM_REQUEST_READ),
+	COMPONENT_MESSAGE(PARAM_MAP_RC),
+	COMPONENT_MESSAGE(FILE_TRANSFER_PROTOCOL),
+	COMPONENT_MESSAGE(LOG_REQUEST_LIST),
+	COMPONENT_MESSAGE(LOG_REQUEST_DATA),
+	COMPONENT_MESSAGE(LOG_ERASE),
+	COMPONENT_MESSAGE(LOG_REQUEST_END),
+};
 
-	case MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_ATTITUDE:
-		handle_message_gimbal_manager_set_attitude(msg);
-		break;
-
-	case MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_MANUAL_CONTROL:
-		handle_message_gimbal_manager_set_manual_control(msg);
-		break;
-
-	case MAVLINK_MSG_ID_GIMBAL_DEVICE_INFORMATION:
-		handle_message_gimbal_device_information(msg);
-		break;
+#undef MESSAGE_HANDLER
+#undef COMPONENT_MESSAGE
 
-	case MAVLINK_MSG_ID_REQUEST_EVENT:
-		handle_message_request_event(msg);
-		break;
+const size_t MavlinkReceiver::message_handlers_count = sizeof(message_handlers) / sizeof(message_handlers[0]);
 
-	case MAVLINK_MSG_ID_GIMBAL_DEVICE_ATTITUDE_STATUS:
-		handle_message_gimbal_device_attitude_status(msg);
-		break;
+const MavlinkReceiver::MessageHandler *
+MavlinkReceiver::find_message_handler(uint32_t msgid) const
+{
+	if (msgid < MESSAGE_HANDLER_INDEX_SIZE) {
+		const uint8_t index = _message_handler_index[msgid];
+		return (index > 0) ? &message_handlers[index - 1] : nullptr;
+	}
 
-#if defined(MAVLINK_MSG_ID_SET_VELOCITY_LIMITS) // For now only defined if development.xml is used
+	for (size_t i = 0; i < message_handlers_count; i++) {
+		if (message_handlers[i].msgid == msgid) {
+			return &message_handlers[i];
+		}
+	}
 
-	case MAVLINK_MSG_ID_SET_VELOCITY_LIMITS:
-		handle_message_set_velocity_limits(msg);
-		break;
-#endif
+	return nullptr;
+}
 
-	default:
-		break;
+void
+MavlinkReceiver::handle_message(mavlink_message_t *msg)
+{
+	if (!_mavlink.boot_complete() && (hrt_elapsed_time(&_mavlink.get_first_start_time()) > 20_s)) {
+		PX4_ERR("system boot did not complete in 20 seconds");
+		_mavlink.set_boot_complete();
 	}
 
-	/*
-	 * Only decode hil messages in HIL mode.
-	 *
-	 * The HIL mode is enabled by the HIL bit flag
-	 * in the system mode. Either send a set mode
-	 * COMMAND_LONG message or a SET_MODE message
-	 *
-	 * Accept HIL GPS messages if use_hil_gps flag is true.
-	 * This allows to provide fake gps measurements to the system.
-	 */
-	if (_mavlink.get_hil_enabled()) {
-		switch (msg->msgid) {
-		case MAVLINK_MSG_ID_HIL_SENSOR:
-			handle_message_hil_sensor(msg);
-			break;
+	const MessageHandler *handler = find_message_handler(msg->msgid);
 
-		case MAVLINK_MSG_ID_HIL_STATE_QUATERNION:
-			handle_message_hil_state_quaternion(msg);
+	if (handler != nullptr) {
+		switch (handler->filter) {
+		case MessageFilter::ALWAYS:
+			(this->*handler->handle)(msg);
 			break;
 
-		case MAVLINK_MSG_ID_HIL_OPTICAL_FLOW:
-			handle_message_hil_optical_flow(msg);
-			break;
+		/*
+		 * Only decode hil messages in HIL mode.
+		 *
+		 * The HIL mode is enabled by the HIL bit flag
+		 * in the system mode. Either send a set mode
+		 * COMMAND_LONG message or a SET_MODE message
+		 *
+		 * Accept HIL GPS messages if use_hil_gps flag is true.
+		 * This allows to provide fake gps measurements to the system.
+		 */
+		case MessageFilter::HIL:
+			if (_mavlink.get_hil_enabled()) {
+				(this->*handler->handle)(msg);
+			}
 
-		default:
 			break;
-		}
-	}
 
+		case MessageFilter::HIL_GPS:
+			if (_mavlink.get_hil_enabled()
+			    || (_mavlink.get_use_hil_gps() && msg->sysid == mavlink_system.sysid)) {
+				(this->*handler->handle)(msg);
+			}
 
-	if (_mavlink.get_hil_enabled() || (_mavlink.get_use_hil_gps() && msg->sysid == mavlink_system.sysid)) {
-		switch (msg->msgid) {
-		case MAVLINK_MSG_ID_HIL_GPS:
-			handle_message_hil_gps(msg);
 			break;
 
-		default:
+		case MessageFilter::COMPONENT:
+			if (_component_worker_running) {
+				queue_component_message(msg);
+
+			} else {
+				(this->*handler->handle)(msg);
+			}
+
 			break;
 		}
-
 	}
 
+	/* handle packet with timesync component */
+	_mavlink_timesync.handle_message(msg);
+
+	/* handle packet with parent object */
+	_mavlink.handle_message(msg);
+}
+
+void
+MavlinkReceiver::handle_message_component(mavlink_message_t *msg)
+{
 	/* handle packet with mission manager */
 	_mission_manager.handle_message(msg);
 
@@ -383,12 +315,6 @@ MavlinkReceiver::handle_message(mavlink_message_t *msg)
 	if (_mavlink.boot_complete()) {
 		// make sure mavlink app has booted before we start processing parameter sync
 		_parameters_manager.handle_message(msg);
-
-	} else {
-		if (hrt_elapsed_time(&_mavlink.get_first_start_time()) > 20_s) {
-			PX4_ERR("system boot did not complete in 20 seconds");
-			_mavlink.set_boot_complete();
-		}
 	}
 
 	if (_mavlink.ftp_enabled()) {
@@ -398,12 +324,43 @@ MavlinkReceiver::handle_message(mavlink_message_t *msg)
 
 	/* handle packet with log component */
 	_mavlink_log_handler.handle_message(msg);
+}
 
-	/* handle packet with timesync component */
-	_mavlink_timesync.handle_message(msg);
+void
+MavlinkReceiver::queue_component_message(const mavlink_message_t *msg)
+{
+	/* size is 12 bytes plus variable payload */
+	const int size = MAVLINK_NUM_NON_PAYLOAD_BYTES + msg->len;
+	bool queued = false;
 
-	/* handle packet with parent object */
-	_mavlink.handle_message(msg);
+	{
+		LockGuard lg{_component_worker_mutex};
+		queued = _component_worker_buffer.push_back(reinterpret_cast<const uint8_t *>(msg), size);
+	}
+
+	if (queued) {
+		px4_sem_post(&_component_worker_sem);
+
+	} else {
+		perf_count(_component_worker_overflow_perf);
+	}
+}
+
+void
+MavlinkReceiver::update_components()
+{
+	_mission_manager.check_active_mission();
+	_mission_manager.send();
+
+	if (_mavlink.get_mode() != Mavlink::MAVLINK_MODE::MAVLINK_MODE_IRIDIUM) {
+		_parameters_manager.send();
+	}
+
+	if (_mavlink.ftp_enabled()) {
+		_mavlink_ftp.send();
+	}
+
+	_mavlink_log_handler.send();
 }
 
 bool
@@ -3211,19 +3168,8 @@ MavlinkReceiver::run()
 
 		CheckHeartbeats(t);
 
-		if (t - last_send_update > timeout * 1000) {
-			_mission_manager.check_active_mission();
-			_mission_manager.send();
-
-			if (_mavlink.get_mode() != Mavlink::MAVLINK_MODE::MAVLINK_MODE_IRIDIUM) {
-				_parameters_manager.send();
-			}
-
-			if (_mavlink.ftp_enabled()) {
-				_mavlink_ftp.send();
-			}
-
-			_mavlink_log_handler.send();
+		if (!_component_worker_running && (t - last_send_update > timeout * 1000)) {
+			update_components();
 			last_send_update = t;
 		}
 
@@ -3416,6 +3362,10 @@ void MavlinkReceiver::print_detailed_rx_stats() const
 
 void MavlinkReceiver::start()
 {
+	if (_mavlink.component_worker_enabled()) {
+		start_component_worker();
+	}
+
 	pthread_attr_t receiveloop_attr;
 	pthread_attr_init(&receiveloop_attr);
 
@@ -3446,8 +3396,119 @@ void *MavlinkReceiver::start_trampoline(void *context)
 	return nullptr;
 }
 
+void MavlinkReceiver::start_component_worker()
+{
+	// space for COMPONENT_WORKER_QUEUE_LENGTH messages (plus 4 byte length header each) and the empty element marker
+	if (!_component_worker_buffer.allocate(COMPONENT_WORKER_QUEUE_LENGTH * (sizeof(mavlink_message_t) + 4) + 1)) {
+		PX4_ERR("component worker buffer alloc failed");
+		return;
+	}
+
+	pthread_mutex_init(&_component_worker_mutex, nullptr);
+	px4_sem_init(&_component_worker_sem, 0, 0);
+	px4_sem_setprotocol(&_component_worker_sem, SEM_PRIO_NONE);
+
+	pthread_attr_t worker_attr;
+	pthread_attr_init(&worker_attr);
+
+	struct sched_param param;
+	(void)pthread_attr_getschedparam(&worker_attr, &param);
+	param.sched_priority = SCHED_PRIORITY_DEFAULT;
+	(void)pthread_attr_setschedparam(&worker_attr, &param);
+
+	pthread_attr_setstacksize(&worker_attr, PX4_STACK_ADJUSTED(sizeof(mavlink_message_t) + 2840
+				  + MAVLINK_RECEIVER_NET_ADDED_STACK));
+
+	_component_worker_running = (pthread_create(&_component_worker_thread, &worker_attr,
+				     MavlinkReceiver::component_worker_trampoline, (void *)this) == 0);
+
+	pthread_attr_destroy(&worker_attr);
+
+	if (!_component_worker_running) {
+		PX4_ERR("component worker start failed");
+		pthread_mutex_destroy(&_component_worker_mutex);
+		px4_sem_destroy(&_component_worker_sem);
+	}
+}
+
+void *MavlinkReceiver::component_worker_trampoline(void *context)
+{
+	MavlinkReceiver *self = reinterpret_cast<MavlinkReceiver *>(context);
+	self->run_component_worker();
+	return nullptr;
+}
+
+void
+MavlinkReceiver::run_component_worker()
+{
+	/* set thread name */
+	{
+		char thread_name[17];
+		snprintf(thread_name, sizeof(thread_name), "mavlink_wrk_if%d", _mavlink.get_instance_id());
+		px4_prctl(PR_SET_NAME, thread_name, px4_getpid());
+	}
+
+	// wait timeout in ms, the component send() rate matches the receive thread
+	const int timeout = 10;
+
+	hrt_abstime last_send_update = 0;
+
+	while (!_mavlink.should_exit()) {
+
+		struct timespec abstime;
+#if defined(__PX4_NUTTX)
+		clock_gettime(CLOCK_REALTIME, &abstime);
+#else
+		px4_clock_gettime(CLOCK_MONOTONIC, &abstime);
+#endif
+		abstime.tv_nsec += timeout * 1000 * 1000;
+
+		if (abstime.tv_nsec >= 1000 * 1000 * 1000) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= 1000 * 1000 * 1000;
+		}
+
+		// woken up for every queued message
+		px4_sem_timedwait(&_component_worker_sem, &abstime);
+
+		mavlink_message_t msg;
+
+		for (;;) {
+			size_t available_bytes = 0;
+
+			{
+				LockGuard lg{_component_worker_mutex};
+				available_bytes = _component_worker_buffer.pop_front(reinterpret_cast<uint8_t *>(&msg),
+						  sizeof(msg));
+			}
+
+			if (available_bytes == 0) {
+				break;
+			}
+
+			handle_message_component(&msg);
+		}
+
+		const hrt_abstime t = hrt_absolute_time();
+
+		if (t - last_send_update > timeout * 1000) {
+			update_components();
+			last_send_update = t;
+		}
+	}
+}
+
 void MavlinkReceiver::stop()
 {
 	_should_exit.store(true);
 	pthread_join(_thread, nullptr);
+
+	if (_component_worker_running) {
+		px4_sem_post(&_component_worker_sem);
+		pthread_join(_component_worker_thread, nullptr);
+		_component_worker_running = false;
+
+		pthread_mutex_destroy(&_component_worker_mutex);
+		px4_sem_destroy(&_component_worker_sem);
+	}
 }
@@ -51,12 +51,17 @@
 #include "mavlink_timesync.h"
 #include "tune_publisher.h"
 
+#include <containers/LockGuard.hpp>
 #include <geo/geo.h>
 #include <lib/drivers/accelerometer/PX4Accelerometer.hpp>
 #include <lib/drivers/gyroscope/PX4Gyroscope.hpp>
 #include <lib/drivers/magnetometer/PX4Magnetometer.hpp>
 #include <lib/systemlib/mavlink_log.h>
+#include <lib/variable_length_ringbuffer/VariableLengthRingbuffer.hpp>
+#include <perf/perf_counter.h>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/sem.h>
+#include <px4_platform_common/time.h>
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/SubscriptionInterval.hpp>
@@ -142,6 +147,31 @@ private:
 	static void *start_trampoline(void *context);
 	void run();
 
+	void start_component_worker();
+	static void *component_worker_trampoline(void *context);
+	void run_component_worker();
+
+	/**
+	 * Condition under which a message from the dispatch table is handled.
+	 */
+	enum class MessageFilter : uint8_t {
+		ALWAYS,		///< always handled
+		HIL,		///< only handled in HIL mode
+		HIL_GPS,	///< handled in HIL mode or if HIL GPS is used
+		COMPONENT,	///< mission, parameter, FTP and log protocol, handled on the component worker if running
+	};
+
+	struct MessageHandler {
+		uint32_t msgid;
+		void (MavlinkReceiver::*handle)(mavlink_message_t *msg);
+		MessageFilter filter;
+	};
+
+	static const MessageHandler message_handlers[];
+	static const size_t message_handlers_count;
+
+	const MessageHandler *find_message_handler(uint32_t msgid) const;
+
 	void acknowledge(uint8_t sysid, uint8_t compid, uint16_t command, uint8_t result, uint8_t progress = 0);
 
 	/**
@@ -156,6 +186,10 @@ private:
 
 	void handle_message(mavlink_message_t *msg);
 
+	void handle_message_component(mavlink_message_t *msg);
+	void queue_component_message(const mavlink_message_t *msg);
+	void update_components();
+
 	void handle_message_adsb_vehicle(mavlink_message_t *msg);
 	void handle_message_att_pos_mocap(mavlink_message_t *msg);
 	void handle_message_battery_status(mavlink_message_t *msg);
@@ -255,6 +289,20 @@ private:
 	MavlinkTimesync			_mavlink_timesync;
 	MavlinkStatustextHandler	_mavlink_statustext_handler;
 
+	// message ID -> index in message_handlers[] + 1 (0: no handler), higher message IDs are searched linearly
+	static constexpr uint32_t MESSAGE_HANDLER_INDEX_SIZE{512};
+	uint8_t _message_handler_index[MESSAGE_HANDLER_INDEX_SIZE] {};
+
+	// optional worker thread handling mission, parameter, FTP and log protocol messages (Mavlink -W)
+	static constexpr int COMPONENT_WORKER_QUEUE_LENGTH{8};
+	pthread_t		_component_worker_thread{};
+	pthread_mutex_t		_component_worker_mutex{};
+	px4_sem_t		_component_worker_sem{};
+	VariableLengthRingbuffer	_component_worker_buffer{};
+	bool			_component_worker_running{false};
+
+	perf_counter_t _component_worker_overflow_perf{perf_alloc(PC_COUNT, MODULE_NAME": component worker overflow")};
+
 	mavlink_status_t		_status{}; ///< receiver status, used for mavlink_parse_char()
 
 	orb_advert_t _mavlink_log_pub{nullptr};
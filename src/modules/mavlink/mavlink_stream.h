@@ -52,6 +52,18 @@ class MavlinkStream : public ListNode<MavlinkStream *>
 
 public:
 
+	/**
+	 * Stream priority for the link bandwidth scheduler (see Mavlink::update_rate_mult()).
+	 * The link budget is assigned in this order, lower priorities absorb rate cuts first.
+	 */
+	enum class Priority : uint8_t {
+		CRITICAL = 0,	///< always sent at the configured rate
+		HIGH,
+		NORMAL,
+		LOW,		///< bulk data
+	};
+	static constexpr int PRIORITY_COUNT{4};
+
 	MavlinkStream(Mavlink *mavlink);
 	virtual ~MavlinkStream() = default;
 
@@ -87,6 +99,24 @@ public:
 	 */
 	virtual bool const_rate() { return false; }
 
+	/**
+	 * @return stream priority, constant rate streams are critical
+	 */
+	virtual Priority priority() { return const_rate() ? Priority::CRITICAL : Priority::NORMAL; }
+
+	/**
+	 * Set the rate multiplier assigned by the bandwidth scheduler (1 = configured rate)
+	 */
+	void set_rate_mult(const float rate_mult) { _rate_mult = rate_mult; }
+	float get_rate_mult() const { return _rate_mult; }
+
+	/**
+	 * Get the average bandwidth needed at the configured rate
+	 *
+	 * @return bandwidth in bytes/s, 0 for unlimited rate or manually sent streams
+	 */
+	float get_bandwidth() { return (_interval > 0) ? get_size_avg() * 1000000.0f / _interval : 0.f; }
+
 	/**
 	 * Get maximal total messages size on update
 	 */
@@ -138,6 +168,7 @@ protected:
 
 private:
 	hrt_abstime _last_sent{0};
+	float _rate_mult{1.f};
 	bool _first_message_sent{false};
 };
 
@@ -51,6 +51,8 @@ public:
 	const char *get_name() const override { return get_name_static(); }
 	uint16_t get_id() override { return get_id_static(); }
 
+	Priority priority() override { return Priority::HIGH; }
+
 	unsigned get_size() override
 	{
 		if (_lpos_sub.advertised() || _airspeed_validated_sub.advertised()) {
@@ -52,6 +52,9 @@ MulticopterRateControl::MulticopterRateControl(bool vtol) :
 {
 	_vehicle_status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_ROTARY_WING;
 
+	// never wait behind other items queued on wq:rate_ctrl
+	SetRunPriority(UINT8_MAX);
+
 	parameters_updated();
 	_controller_status_pub.advertise();
 }
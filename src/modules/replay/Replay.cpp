@@ -46,14 +46,17 @@
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/shutdown.h>
+#include <lib/mathlib/mathlib.h>
 #include <lib/parameters/param.h>
 #include <uORB/uORBMessageFields.hpp>
 
 #include <cstring>
 #include <float.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <math.h>
+#include <queue>
 #include <time.h>
 #include <sstream>
 #include <stdio.h>
@@ -237,16 +240,16 @@ Replay::readDynamicParams(const char *filename)
 }
 
 bool
-Replay::readFileHeader(std::ifstream &file)
+Replay::readFileHeader()
 {
-	file.seekg(0);
 	ulog_file_header_s msg_header;
-	file.read((char *)&msg_header, sizeof(msg_header));
 
-	if (!file) {
+	if (_file.size() < sizeof(msg_header)) {
 		return false;
 	}
 
+	memcpy(&msg_header, _file.data(), sizeof(msg_header));
+
 	_file_start_time = msg_header.timestamp;
 	//verify it's an ULog file
 	char magic[8];
@@ -261,76 +264,71 @@ Replay::readFileHeader(std::ifstream &file)
 }
 
 bool
-Replay::readFileDefinitions(std::ifstream &file)
+Replay::readFileDefinitions()
 {
 	PX4_INFO("Applying params from ULog file...");
 
 	ulog_message_header_s message_header;
-	file.seekg(sizeof(ulog_file_header_s));
+	uint64_t offset = sizeof(ulog_file_header_s);
 
 	while (true) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+		const uint8_t *message = _file.message(offset, message_header);
 
-		if (!file) {
+		if (!message) {
 			return false;
 		}
 
 		switch (message_header.msg_type) {
 		case (int)ULogMessageType::FLAG_BITS:
-			if (!readFlagBits(file, message_header.msg_size)) {
+			if (!readFlagBits(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::FORMAT:
-			if (!readFormat(file, message_header.msg_size)) {
+			if (!readFormat(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
+			if (!readAndApplyParameter(message, message_header.msg_size)) {
 				return false;
 			}
 
 			break;
 
 		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			_data_section_start = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
+			_data_section_start = offset;
 			return true;
 
 		case (int)ULogMessageType::INFO: //skip
 		case (int)ULogMessageType::INFO_MULTIPLE: //skip
 		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
 		default:
-			PX4_ERR("unknown log definition type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
+			PX4_ERR("unknown log definition type %i, size %i (offset %" PRIu64 ")",
+				(int)message_header.msg_type, (int)message_header.msg_size, offset);
 			break;
 		}
-	}
 
-	return true;
+		offset += ULOG_MSG_HEADER_LEN + message_header.msg_size;
+	}
 }
 
 bool
-Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
+Replay::readFlagBits(const uint8_t *message, uint16_t msg_size)
 {
 	if (msg_size != 40) {
 		PX4_ERR("unsupported message length for FLAG_BITS message (%i)", msg_size);
 		return false;
 	}
 
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-	//uint8_t *compat_flags = message;
-	uint8_t *incompat_flags = message + 8;
+	//const uint8_t *compat_flags = message;
+	const uint8_t *incompat_flags = message + 8;
 
 	// handle & validate the flags
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
@@ -366,18 +364,9 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readFormat(std::ifstream &file, uint16_t msg_size)
+Replay::readFormat(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	char *format = (char *)_read_buffer.data();
-	file.read(format, msg_size);
-	format[msg_size] = 0;
-
-	if (!file) {
-		return false;
-	}
-
-	string str_format(format);
+	string str_format((const char *)message, msg_size);
 	size_t pos = str_format.find(':');
 
 	if (pos == string::npos) {
@@ -419,27 +408,21 @@ string Replay::getOrbFields(const orb_metadata *meta)
 }
 
 bool
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+Replay::readAndAddSubscription(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size + 1);
-	uint8_t *message = _read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read((char *)message, msg_size);
-	message[msg_size] = 0;
-
-	if (!file) {
+	if (msg_size < 4) {
 		return false;
 	}
 
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
+	uint8_t multi_id = message[0];
+	uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
+	string topic_name((const char *)message + 3, msg_size - 3);
+
+	if (msg_id < _subscriptions.size() && _subscriptions[msg_id]) {
+		PX4_WARN("msg_id %i used for multiple topics, ignoring %s", msg_id, topic_name.c_str());
 		return true;
 	}
 
-	_subscription_file_pos = file.tellg();
-
-	uint8_t multi_id = *(uint8_t *)message;
-	uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
-	string topic_name((char *)message + 3);
 	const orb_metadata *orb_meta = findTopic(topic_name);
 
 	if (!orb_meta) {
@@ -527,6 +510,7 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	Subscription *subscription = new Subscription();
 	subscription->orb_meta = orb_meta;
 	subscription->multi_id = multi_id;
+	subscription->msg_id = msg_id;
 	subscription->compat = compat;
 
 	//find the timestamp offset
@@ -545,18 +529,11 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	}
 
 	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
-
-	if (!nextDataMessage(file, *subscription, msg_id)) {
-		delete subscription;
-		return false;
-	}
-
-	file.seekg(cur_pos);
+	subscription->next_index = 0;
 
-	if (!subscription->orb_meta) {
+	if (!loadDataMessage(*subscription)) {
 		//no message found. This is not a fatal error
+		delete subscription->compat;
 		delete subscription;
 		return true;
 	}
@@ -606,52 +583,49 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 	return false;
 }
 
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+void
+Replay::handleAdditionalMessages(uint64_t end_position)
 {
-	ulog_message_header_s message_header;
+	const std::vector<uint64_t> &messages = _file.additionalMessages();
 
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	while (_next_additional_message < messages.size() && messages[_next_additional_message] < end_position) {
+		ulog_message_header_s message_header;
+		const uint8_t *message = _file.message(messages[_next_additional_message], message_header);
 
-		if (!file) {
-			return false;
-		}
+		if (message) {
+			switch (message_header.msg_type) {
+			case (int)ULogMessageType::PARAMETER:
+				readAndApplyParameter(message, message_header.msg_size);
+				break;
 
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
-				return false;
-			}
+			case (int)ULogMessageType::DROPOUT:
+				readDropout(message, message_header.msg_size);
+				break;
 
-			break;
-
-		case (int)ULogMessageType::DROPOUT:
-			readDropout(file, message_header.msg_size);
-			break;
-
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+			default:
+				break;
+			}
 		}
-	}
 
-	return true;
+		_next_additional_message++;
+	}
 }
 
 bool
-Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
+Replay::readAndApplyParameter(const uint8_t *message, uint16_t msg_size)
 {
-	_read_buffer.reserve(msg_size);
-	uint8_t *message = (uint8_t *)_read_buffer.data();
-	file.read((char *)message, msg_size);
-
-	if (!file) {
+	if (msg_size < 1) {
 		return false;
 	}
 
 	uint8_t key_len = message[0];
-	string key((char *)message + 1, key_len);
+
+	// key and 4 byte value
+	if (msg_size < 1 + key_len + 4) {
+		return false;
+	}
+
+	string key((const char *)message + 1, key_len);
 
 	size_t pos = key.find(' ');
 
@@ -683,99 +657,94 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 }
 
 bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+Replay::readDropout(const uint8_t *message, uint16_t msg_size)
 {
 	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
+
+	if (msg_size < sizeof(duration)) {
+		return false;
+	}
+
+	memcpy(&duration, message, sizeof(duration));
 
 	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
+	return true;
 }
 
-bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
+uint64_t
+Replay::readTimestamp(const Subscription &subscription, uint64_t offset) const
 {
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	uint64_t timestamp = 0;
+	const uint64_t timestamp_pos = offset + ULOG_MSG_HEADER_LEN + 2 + subscription.timestamp_offset; //skip header & msg id
 
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
+	if (timestamp_pos + sizeof(timestamp) <= _file.size()) {
+		memcpy(&timestamp, _file.data() + timestamp_pos, sizeof(timestamp));
 	}
 
-	uint16_t file_msg_id;
-	bool done = false;
+	return timestamp;
+}
 
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+bool
+Replay::loadDataMessage(Subscription &subscription)
+{
+	const std::vector<uint64_t> &messages = _file.dataMessages(subscription.msg_id);
+	const uint16_t expected_size = subscription.orb_meta->o_size_no_padding + 2;
 
-		if (!file) {
-			break;
-		}
+	while (subscription.next_index < messages.size()) {
+		const uint64_t offset = messages[subscription.next_index];
+		ulog_message_header_s message_header;
 
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
-			break;
+		if (_file.message(offset, message_header) && message_header.msg_size == expected_size) {
+			subscription.next_read_pos = offset;
+			subscription.next_timestamp = readTimestamp(subscription, offset);
+			return true;
 		}
 
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			readAndAddSubscription(file, message_header.msg_size);
-			break;
+		//sanity check failed!
+		PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+			subscription.orb_meta->o_name, message_header.msg_size, expected_size);
+		subscription.next_index++;
+	}
 
-		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
-
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						done = true;
-
-					} else { //sanity check failed!
-						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-					}
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
+	return false;
+}
 
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-				}
-			}
+bool
+Replay::nextDataMessage(Subscription &subscription)
+{
+	if (!subscription.orb_meta) {
+		return false;
+	}
 
-			break;
+	subscription.next_index++;
+	return loadDataMessage(subscription);
+}
 
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
-		case (int)ULogMessageType::PARAMETER:
-		case (int)ULogMessageType::DROPOUT:
-		case (int)ULogMessageType::INFO:
-		case (int)ULogMessageType::INFO_MULTIPLE:
-		case (int)ULogMessageType::SYNC:
-		case (int)ULogMessageType::LOGGING:
-		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+void
+Replay::seek(uint64_t timestamp)
+{
+	uint64_t first_read_pos = UINT64_MAX;
 
-		default:
-			//this really should not happen
-			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+	for (Subscription *subscription : _subscriptions) {
+		if (!subscription || !subscription->orb_meta) {
+			continue;
 		}
-	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
+		// the data messages of a topic are in chronological order
+		const std::vector<uint64_t> &messages = _file.dataMessages(subscription->msg_id);
+		auto it = std::lower_bound(messages.begin() + subscription->next_index, messages.end(), timestamp,
+		[this, subscription](uint64_t offset, uint64_t t) { return readTimestamp(*subscription, offset) < t; });
+		subscription->next_index = it - messages.begin();
+
+		if (loadDataMessage(*subscription)) {
+			first_read_pos = math::min(first_read_pos, subscription->next_read_pos);
+		}
 	}
 
-	return file.good();
+	// apply the parameter changes that were skipped
+	handleAdditionalMessages(first_read_pos);
 }
 
 const orb_metadata *
@@ -851,7 +820,7 @@ Replay::sizeOfFullType(const std::string &type_name_full)
 }
 
 bool
-Replay::readDefinitionsAndApplyParams(std::ifstream &file)
+Replay::readDefinitionsAndApplyParams()
 {
 	// log reader currently assumes little endian
 	int num = 1;
@@ -861,18 +830,18 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 		return false;
 	}
 
-	if (!file.is_open()) {
+	if (!_file.open(_replay_file)) {
 		PX4_ERR("Failed to open replay file");
 		return false;
 	}
 
-	if (!readFileHeader(file)) {
+	if (!readFileHeader()) {
 		PX4_ERR("Failed to read file header. Not a valid ULog file");
 		return false;
 	}
 
 	//initialize the formats and apply the parameters from the log file
-	if (!readFileDefinitions(file)) {
+	if (!readFileDefinitions()) {
 		PX4_ERR("Failed to read ULog definitions section. Broken file?");
 		return false;
 	}
@@ -885,9 +854,7 @@ Replay::readDefinitionsAndApplyParams(std::ifstream &file)
 void
 Replay::run()
 {
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
-
-	if (!readDefinitionsAndApplyParams(replay_file)) {
+	if (!readDefinitionsAndApplyParams()) {
 		return;
 	}
 
@@ -898,68 +865,79 @@ Replay::run()
 		_speed_factor = atof(speedup);
 	}
 
-	onEnterMainLoop();
+	// index the data section once, instead of searching the file for the next message of each subscription
+	_file.buildIndex(_data_section_start, _read_until_file_position);
 
-	_replay_start_time = hrt_absolute_time();
+	for (uint64_t offset : _file.subscriptionMessages()) {
+		ulog_message_header_s message_header;
+		const uint8_t *message = _file.message(offset, message_header);
 
-	PX4_INFO("Replay in progress...");
+		if (!message || !readAndAddSubscription(message, message_header.msg_size)) {
+			PX4_ERR("Failed to read subscription");
+			return;
+		}
+	}
 
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
+	const char *start_time = getenv(replay::ENV_START_TIME);
 
-	//we know the next message must be an ADD_LOGGED_MSG
-	replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	if (start_time) {
+		const uint64_t seek_time = _file_start_time + (uint64_t)(atof(start_time) * 1e6);
+		PX4_INFO("Seeking to %.3lf s", (double)(seek_time - _file_start_time) / 1.e6);
+		seek(seek_time);
 
-	if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
-		PX4_ERR("Failed to read subscription");
-		return;
+		// the replay starts at the seek time
+		_file_start_time = seek_time;
 	}
 
+	onEnterMainLoop();
+
+	_replay_start_time = hrt_absolute_time();
+
+	PX4_INFO("Replay in progress...");
+
 	const uint64_t timestamp_offset = getTimestampOffset();
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
 
-	while (!should_exit() && replay_file) {
+	//Messages from different subscriptions don't need to be in chronological order, so we keep
+	//the next message of each subscription in a min-heap ordered by timestamp
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
 
-		//Find the next message to publish. Messages from different subscriptions don't need
-		//to be in chronological order, so we need to check all subscriptions
-		uint64_t next_file_time = 0;
-		int next_msg_id = -1;
-		bool first_time = true;
+	for (const Subscription *subscription : _subscriptions) {
+		if (subscription && subscription->orb_meta && !subscription->ignored) {
+			queue.push(QueueEntry{subscription->next_timestamp, subscription->msg_id});
+		}
+	}
 
-		for (size_t i = 0; i < _subscriptions.size(); ++i) {
-			const Subscription *subscription = _subscriptions[i];
+	while (!should_exit() && !queue.empty()) {
 
-			if (!subscription) {
-				continue;
-			}
+		const QueueEntry next = queue.top();
+		queue.pop();
 
-			if (subscription->orb_meta && !subscription->ignored) {
-				if (first_time || subscription->next_timestamp < next_file_time) {
-					first_time = false;
-					next_msg_id = (int)i;
-					next_file_time = subscription->next_timestamp;
-				}
-			}
+		Subscription &sub = *_subscriptions[next.msg_id];
+
+		if (!sub.orb_meta || sub.ignored) {
+			continue;
 		}
 
-		if (next_msg_id == -1) {
-			break; //no active subscription anymore. We're done.
+		if (sub.next_timestamp != next.timestamp) {
+			//the subscription was advanced outside of the main loop
+			queue.push(QueueEntry{sub.next_timestamp, sub.msg_id});
+			continue;
 		}
 
-		Subscription &sub = *_subscriptions[next_msg_id];
+		const uint64_t next_file_time = sub.next_timestamp;
 
 		if (next_file_time == 0 || next_file_time < _file_start_time) {
 			//someone didn't set the timestamp properly. Consider the message invalid
-			nextDataMessage(replay_file, sub, next_msg_id);
+			if (nextDataMessage(sub)) {
+				queue.push(QueueEntry{sub.next_timestamp, sub.msg_id});
+			}
+
 			continue;
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		handleAdditionalMessages(sub.next_read_pos);
 
 		// Perform scheduled parameter changes
 		while (_next_param_change < _dynamic_parameter_schedule.size() &&
@@ -975,14 +953,16 @@ Replay::run()
 		const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
 
 		// It's time to publish
-		readTopicDataToBuffer(sub, replay_file);
+		readTopicDataToBuffer(sub);
 		memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
 
-		if (handleTopicUpdate(sub, _read_buffer.data(), replay_file)) {
+		if (handleTopicUpdate(sub, _read_buffer.data())) {
 			++nr_published_messages;
 		}
 
-		nextDataMessage(replay_file, sub, next_msg_id);
+		if (nextDataMessage(sub) && !sub.ignored) {
+			queue.push(QueueEntry{sub.next_timestamp, sub.msg_id});
+		}
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -1011,7 +991,7 @@ Replay::run()
 	onExitMainLoop();
 
 	if (!should_exit()) {
-		replay_file.close();
+		_file.close();
 		px4_shutdown_request();
 		// we need to ensure the shutdown logic gets updated and eventually triggers shutdown
 		hrt_abstime t = hrt_absolute_time();
@@ -1026,17 +1006,16 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+	memcpy(_read_buffer.data(), _file.data() + sub.next_read_pos + ULOG_MSG_HEADER_LEN + 2, msg_read_size); //skip header & msg id
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data)
 {
 	return publishTopic(sub, data);
 }
@@ -1182,9 +1161,7 @@ Replay::applyParams(bool quiet)
 		return -ENOMEM;
 	}
 
-	ifstream replay_file(_replay_file, ios::in | ios::binary);
-
-	if (!r->readDefinitionsAndApplyParams(replay_file)) {
+	if (!r->readDefinitionsAndApplyParams()) {
 		ret = -1;
 	}
 
@@ -1231,6 +1208,9 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+Optionally `replay_start` can be set to a time in seconds (relative to the start of the log) to start the replay
+from. The log is memory mapped and indexed when the replay starts, so seeking doesn't need to read the skipped part.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
@@ -34,13 +34,13 @@
 #pragma once
 
 #include <algorithm>
-#include <fstream>
 #include <map>
 #include <vector>
 #include <set>
 #include <string>
 
 #include "definitions.hpp"
+#include "ULogFile.hpp"
 
 #include <px4_platform_common/module.h>
 #include <uORB/topics/uORBTopics.hpp>
@@ -52,7 +52,8 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
+ * to match the starting time of replay. The data section of the (memory mapped) file is indexed per
+ * subscription, and the next message of each subscription is kept in a min-heap to find the next message
  * to replay. This is necessary because data messages from different subscriptions don't need to be in
  * monotonic increasing order.
  */
@@ -131,11 +132,13 @@ protected:
 		const orb_metadata *orb_meta = nullptr; ///< if nullptr, this subscription is invalid
 		orb_advert_t orb_advert = nullptr;
 		uint8_t multi_id;
+		uint16_t msg_id;
 		int timestamp_offset; ///< marks the field of the timestamp
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
+		size_t next_index = 0; ///< index into the data messages of msg_id
+		uint64_t next_read_pos; ///< file offset of the next message
 		uint64_t next_timestamp; ///< timestamp of the file
 
 		CompatBase *compat = nullptr;
@@ -190,22 +193,25 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data);
 
 	/**
 	 * read a topic from the file (offset given by the subscription) into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * This also takes care of new subscriptions and parameter updates. When reaching EOF,
-	 * the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
-	 * @return false on file error
+	 * Advance the subscription to its next data message and read the timestamp.
+	 * When reaching the end, the subscription is set to invalid.
+	 * @return false if there are no more messages
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	bool nextDataMessage(Subscription &subscription);
+
+	/**
+	 * Move all subscriptions to their first message with a timestamp >= timestamp
+	 * and apply the parameter changes in between.
+	 */
+	void seek(uint64_t timestamp);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -240,47 +246,65 @@ private:
 
 	std::map<std::string, std::string> _file_formats; ///< all formats we read from the file
 
+	struct QueueEntry {
+		uint64_t timestamp;
+		uint16_t msg_id;
+
+		bool operator>(const QueueEntry &other) const
+		{
+			return timestamp > other.timestamp || (timestamp == other.timestamp && msg_id > other.msg_id);
+		}
+	};
+
+	ULogFile _file;
+
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
+	uint64_t _data_section_start; ///< first ADD_LOGGED_MSG message
 
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	size_t _next_additional_message{0}; ///< index of the next parameter/dropout message to handle
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
 	float _accumulated_delay{0.f};
 
-	bool readFileHeader(std::ifstream &file);
+	bool readFileHeader();
 
 	/**
 	 * Read definitions section: check formats, apply parameters and store
 	 * the start of the data section.
 	 * @return true on success
 	 */
-	bool readFileDefinitions(std::ifstream &file);
+	bool readFileDefinitions();
 
-	///file parsing methods. They return false, when further parsing should be aborted.
-	bool readFormat(std::ifstream &file, uint16_t msg_size);
-	bool readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
-	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
+	///message parsing methods. They return false, when further parsing should be aborted.
+	bool readFormat(const uint8_t *message, uint16_t msg_size);
+	bool readAndAddSubscription(const uint8_t *message, uint16_t msg_size);
+	bool readFlagBits(const uint8_t *message, uint16_t msg_size);
 
 	/**
-	 * Read the file header and definitions sections. Apply the parameters from this section
-	 * and apply user-defined overridden parameters.
+	 * Open the replay file, read the file header and definitions sections. Apply the parameters from
+	 * this section and apply user-defined overridden parameters.
 	 * @return true on success
 	 */
-	bool readDefinitionsAndApplyParams(std::ifstream &file);
+	bool readDefinitionsAndApplyParams();
 
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Handle the additional messages not handled yet, with file offset < end_position.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
-	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
-	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	void handleAdditionalMessages(uint64_t end_position);
+	bool readDropout(const uint8_t *message, uint16_t msg_size);
+	bool readAndApplyParameter(const uint8_t *message, uint16_t msg_size);
+
+	/**
+	 * Load the data message at the subscription index (or the next valid one) and read the timestamp
+	 * @return false if there are no more messages
+	 */
+	bool loadDataMessage(Subscription &subscription);
+
+	uint64_t readTimestamp(const Subscription &subscription, uint64_t offset) const;
 
 	static const orb_metadata *findTopic(const std::string &name);
 
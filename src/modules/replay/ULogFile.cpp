@@ -0,0 +1,484 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ULogFile.hpp"
+
+#include <px4_platform_common/log.h>
+#define HEATSHRINK_DYNAMIC_ALLOC 0 // same as the heatshrink library build
+#include <lib/heatshrink/heatshrink/heatshrink_decoder.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+constexpr uint64_t ULogFile::data_start;
+
+static bool decompress_frame(heatshrink_decoder &hsd, const uint8_t *in, size_t in_size, uint8_t *out,
+			     size_t out_size)
+{
+	size_t in_len = 0;
+	size_t out_len = 0;
+
+	heatshrink_decoder_reset(&hsd);
+
+	while (true) {
+		size_t count = 0;
+
+		if (in_len < in_size) {
+			uint8_t *in_data = const_cast<uint8_t *>(&in[in_len]); // the decoder does not modify the input
+
+			if (heatshrink_decoder_sink(&hsd, in_data, in_size - in_len, &count) < 0) {
+				return false;
+			}
+
+			in_len += count;
+		}
+
+		const HSD_poll_res pres = heatshrink_decoder_poll(&hsd, &out[out_len], out_size - out_len, &count);
+		out_len += count;
+
+		if (pres != HSDR_POLL_EMPTY && pres != HSDR_POLL_MORE) {
+			return false;
+		}
+
+		if (pres == HSDR_POLL_MORE && out_len == out_size) {
+			// more data than announced in the frame header
+			return false;
+		}
+
+		if (in_len == in_size) {
+			const HSD_finish_res fres = heatshrink_decoder_finish(&hsd);
+
+			if (fres == HSDR_FINISH_DONE) {
+				return out_len == out_size;
+
+			} else if (fres != HSDR_FINISH_MORE) {
+				return false;
+			}
+		}
+	}
+}
+
+bool
+ULogFile::open(const char *file_name)
+{
+	close();
+
+	_fd = ::open(file_name, O_RDONLY);
+
+	if (_fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat(_fd, &st) != 0 || st.st_size <= 0) {
+		close();
+		return false;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+
+	if (data == MAP_FAILED) {
+		PX4_ERR("mmap failed (%i)", errno);
+		close();
+		return false;
+	}
+
+	// replay reads the file mostly front to back
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+	_data = (const uint8_t *)data;
+	_size = st.st_size;
+
+	if (!decompress() || !expandDeltas()) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool
+ULogFile::readFlagBits(ulog_message_flag_bits_s &flag_bits, uint64_t &data_end) const
+{
+	if (_size < data_start) {
+		return false;
+	}
+
+	memcpy(&flag_bits, _data + sizeof(ulog_file_header_s), sizeof(flag_bits));
+
+	if (flag_bits.msg_type != (uint8_t)ULogMessageType::FLAG_BITS) {
+		return false;
+	}
+
+	// data appended by the hardfault handler is not encoded
+	data_end = _size;
+
+	if ((flag_bits.incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK)
+	    && flag_bits.appended_offsets[0] >= data_start && flag_bits.appended_offsets[0] < _size) {
+		data_end = flag_bits.appended_offsets[0];
+	}
+
+	return true;
+}
+
+FILE *
+ULogFile::createDecodedFile() const
+{
+	// the decoded data can be several times larger than the log: stream it into an (unlinked) temporary file
+	// instead of memory, it is then mapped the same way as the log itself
+	FILE *decoded = tmpfile();
+
+	if (!decoded) {
+		PX4_ERR("failed to create a temporary file (%i)", errno);
+		return nullptr;
+	}
+
+	fwrite(_data, 1, data_start, decoded);
+	return decoded;
+}
+
+bool
+ULogFile::replaceData(FILE *decoded, ulog_message_flag_bits_s &flag_bits, uint64_t data_end, uint8_t decoded_flag)
+{
+	const off_t decoded_end = ftello(decoded);
+
+	if (decoded_end < 0) {
+		PX4_ERR("failed to write the decoded log (%i)", errno);
+		fclose(decoded);
+		return false;
+	}
+
+	// move the appended data behind the decoded data
+	for (int i = 0; i < 3; ++i) {
+		if (flag_bits.appended_offsets[i] >= data_end) {
+			flag_bits.appended_offsets[i] = flag_bits.appended_offsets[i] - data_end + decoded_end;
+		}
+	}
+
+	fwrite(_data + data_end, 1, _size - data_end, decoded);
+
+	flag_bits.incompat_flags[0] &= ~decoded_flag;
+
+	if (fseeko(decoded, sizeof(ulog_file_header_s), SEEK_SET) != 0
+	    || fwrite(&flag_bits, sizeof(flag_bits), 1, decoded) != 1
+	    || fflush(decoded) != 0 || ferror(decoded)) {
+		PX4_ERR("failed to write the decoded log (%i)", errno);
+		fclose(decoded);
+		return false;
+	}
+
+	const uint64_t decoded_size = decoded_end + (_size - data_end);
+	void *data = mmap(nullptr, decoded_size, PROT_READ, MAP_PRIVATE, fileno(decoded), 0);
+
+	if (data == MAP_FAILED) {
+		PX4_ERR("mmap failed (%i)", errno);
+		fclose(decoded);
+		return false;
+	}
+
+	madvise(data, decoded_size, MADV_SEQUENTIAL);
+
+	munmap((void *)_data, _size);
+
+	if (_decoded_file) {
+		fclose(_decoded_file);
+	}
+
+	_decoded_file = decoded;
+	_data = (const uint8_t *)data;
+	_size = decoded_size;
+	return true;
+}
+
+bool
+ULogFile::decompress()
+{
+	ulog_message_flag_bits_s flag_bits;
+	uint64_t data_end;
+
+	if (!readFlagBits(flag_bits, data_end)
+	    || !(flag_bits.incompat_flags[0] & ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK)) {
+		return true;
+	}
+
+	FILE *decompressed = createDecodedFile();
+
+	if (!decompressed) {
+		return false;
+	}
+
+	heatshrink_decoder hsd;
+	std::vector<uint8_t> frame_data(UINT16_MAX); // one frame at a time
+	uint64_t offset = data_start;
+	ulog_compressed_frame_header_s frame;
+
+	while (offset + sizeof(frame) <= data_end) {
+		memcpy(&frame, _data + offset, sizeof(frame));
+		offset += sizeof(frame);
+
+		if (offset + frame.compressed_size > data_end) {
+			PX4_WARN("log ends with an incomplete frame");
+			break;
+		}
+
+		if (frame.compressed_size == frame.uncompressed_size) {
+			fwrite(_data + offset, 1, frame.compressed_size, decompressed);
+
+		} else if (decompress_frame(hsd, _data + offset, frame.compressed_size, frame_data.data(),
+					    frame.uncompressed_size)) {
+			fwrite(frame_data.data(), 1, frame.uncompressed_size, decompressed);
+
+		} else {
+			PX4_ERR("corrupt compressed frame (offset %" PRIu64 ")", offset);
+			break;
+		}
+
+		offset += frame.compressed_size;
+	}
+
+	return replaceData(decompressed, flag_bits, data_end, ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK);
+}
+
+bool
+ULogFile::expandDeltas()
+{
+	ulog_message_flag_bits_s flag_bits;
+	uint64_t data_end;
+
+	if (!readFlagBits(flag_bits, data_end)
+	    || !(flag_bits.incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DELTA_MASK)) {
+		return true;
+	}
+
+	FILE *expanded = createDecodedFile();
+
+	if (!expanded) {
+		return false;
+	}
+
+	// last sample (including the msg_id) per msg_id
+	std::vector<std::vector<uint8_t>> last_samples;
+	uint64_t offset = data_start;
+	ulog_message_header_s header;
+	const uint8_t *payload;
+
+	while ((payload = message(offset, header)) != nullptr
+	       && offset + ULOG_MSG_HEADER_LEN + header.msg_size <= data_end) {
+
+		const uint64_t message_size = ULOG_MSG_HEADER_LEN + header.msg_size;
+		const bool is_data = header.msg_type == (uint8_t)ULogMessageType::DATA;
+		const bool is_delta = header.msg_type == (uint8_t)ULogMessageType::DATA_DELTA;
+		uint16_t msg_id;
+
+		if (!(is_data || is_delta) || header.msg_size < sizeof(msg_id)) {
+			fwrite(_data + offset, 1, message_size, expanded);
+
+		} else {
+			memcpy(&msg_id, payload, sizeof(msg_id));
+
+			if (last_samples.size() <= msg_id) {
+				last_samples.resize(msg_id + 1);
+			}
+
+			std::vector<uint8_t> &sample = last_samples[msg_id];
+
+			if (is_data) {
+				sample.assign(payload, payload + header.msg_size);
+				fwrite(_data + offset, 1, message_size, expanded);
+
+			} else if (!sample.empty()
+				   && applyDelta(payload + sizeof(msg_id), header.msg_size - sizeof(msg_id), sample)) {
+				header.msg_type = (uint8_t)ULogMessageType::DATA;
+				header.msg_size = sample.size();
+				fwrite(&header, 1, ULOG_MSG_HEADER_LEN, expanded);
+				fwrite(sample.data(), 1, sample.size(), expanded);
+
+			} else {
+				// cannot be decoded without the previous sample, skip until the next keyframe
+				sample.clear();
+			}
+		}
+
+		offset += message_size;
+	}
+
+	return replaceData(expanded, flag_bits, data_end, ULOG_INCOMPAT_FLAG0_DELTA_MASK);
+}
+
+bool
+ULogFile::applyDelta(const uint8_t *delta, size_t size, std::vector<uint8_t> &sample)
+{
+	// the sample starts with the msg_id
+	size_t pos = sizeof(uint16_t);
+	size_t i = 0;
+
+	while (i + 2 <= size) {
+		const size_t unchanged = delta[i];
+		const size_t changed = delta[i + 1];
+		i += 2;
+		pos += unchanged;
+
+		if (i + changed > size || pos + changed > sample.size()) {
+			return false;
+		}
+
+		for (size_t k = 0; k < changed; ++k) {
+			sample[pos++] ^= delta[i++];
+		}
+	}
+
+	return i == size;
+}
+
+void
+ULogFile::close()
+{
+	if (_data) {
+		munmap((void *)_data, _size);
+	}
+
+	_data = nullptr;
+	_size = 0;
+
+	if (_decoded_file) {
+		fclose(_decoded_file);
+		_decoded_file = nullptr;
+	}
+
+	if (_fd >= 0) {
+		::close(_fd);
+		_fd = -1;
+	}
+
+	_data_messages.clear();
+	_subscription_messages.clear();
+	_additional_messages.clear();
+}
+
+const uint8_t *
+ULogFile::message(uint64_t offset, ulog_message_header_s &header) const
+{
+	if (offset + ULOG_MSG_HEADER_LEN > _size) {
+		return nullptr;
+	}
+
+	memcpy(&header, _data + offset, ULOG_MSG_HEADER_LEN);
+
+	if (offset + ULOG_MSG_HEADER_LEN + header.msg_size > _size) {
+		return nullptr;
+	}
+
+	return _data + offset + ULOG_MSG_HEADER_LEN;
+}
+
+void
+ULogFile::buildIndex(uint64_t data_section_start, uint64_t end)
+{
+	_data_messages.clear();
+	_subscription_messages.clear();
+	_additional_messages.clear();
+
+	uint64_t offset = data_section_start;
+	ulog_message_header_s header;
+	const uint8_t *payload;
+
+	while ((payload = message(offset, header)) != nullptr) {
+		if (offset + ULOG_MSG_HEADER_LEN + header.msg_size > end) {
+			break;
+		}
+
+		switch (header.msg_type) {
+		case (int)ULogMessageType::DATA:
+			if (header.msg_size >= sizeof(uint16_t)) {
+				uint16_t msg_id;
+				memcpy(&msg_id, payload, sizeof(msg_id));
+
+				if (_data_messages.size() <= msg_id) {
+					_data_messages.resize(msg_id + 1);
+				}
+
+				_data_messages[msg_id].push_back(offset);
+			}
+
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			_subscription_messages.push_back(offset);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			_additional_messages.push_back(offset);
+			break;
+
+		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
+		case (int)ULogMessageType::INFO:
+		case (int)ULogMessageType::INFO_MULTIPLE:
+		case (int)ULogMessageType::SYNC:
+		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::LOGGING_TAGGED:
+		case (int)ULogMessageType::PARAMETER_DEFAULT:
+			break;
+
+		default:
+			//this really should not happen
+			PX4_ERR("unknown log message type %i, size %i (offset %" PRIu64 ")",
+				(int)header.msg_type, (int)header.msg_size, offset);
+			break;
+		}
+
+		offset += ULOG_MSG_HEADER_LEN + header.msg_size;
+	}
+}
+
+const std::vector<uint64_t> &
+ULogFile::dataMessages(uint16_t msg_id) const
+{
+	static const std::vector<uint64_t> empty;
+
+	if (msg_id < _data_messages.size()) {
+		return _data_messages[msg_id];
+	}
+
+	return empty;
+}
+
+} //namespace px4
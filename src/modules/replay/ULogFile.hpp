@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <logger/messages.h>
+
+namespace px4
+{
+
+/**
+ * @class ULogFile
+ * Read-only, memory mapped ULog file with an index of the data section: the file offsets of the data messages
+ * of each msg_id, and of the subscription, parameter and dropout messages. This allows replay to find the
+ * next message of a subscription or a timestamp without scanning the file.
+ * Compressed and delta encoded logs (ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK, ULOG_INCOMPAT_FLAG0_DELTA_MASK) are
+ * decoded when opening, so that readers see a regular ULog file. The decoded data is streamed into a temporary
+ * file which is then memory mapped instead of the log, so the memory use does not grow with the log size.
+ */
+class ULogFile
+{
+public:
+	ULogFile() = default;
+	~ULogFile() { close(); }
+
+	ULogFile(const ULogFile &) = delete;
+	ULogFile &operator=(const ULogFile &) = delete;
+
+	/**
+	 * Map a file into memory (or decode it)
+	 * @return true on success, false if the file cannot be read or decoded
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	bool isOpen() const { return _data != nullptr; }
+
+	const uint8_t *data() const { return _data; }
+	uint64_t size() const { return _size; }
+
+	/**
+	 * Get a message
+	 * @param offset file offset of the message header
+	 * @param header returned message header
+	 * @return pointer to the message payload or nullptr if the message is incomplete
+	 */
+	const uint8_t *message(uint64_t offset, ulog_message_header_s &header) const;
+
+	/**
+	 * Index the messages of the data section
+	 * @param data_section_start file offset of the first message of the data section
+	 * @param end file offset where to stop (e.g. start of appended data)
+	 */
+	void buildIndex(uint64_t data_section_start, uint64_t end);
+
+	/** file offsets of the data messages of msg_id, in file order */
+	const std::vector<uint64_t> &dataMessages(uint16_t msg_id) const;
+
+	/** file offsets of the ADD_LOGGED_MSG messages in the data section */
+	const std::vector<uint64_t> &subscriptionMessages() const { return _subscription_messages; }
+
+	/** file offsets of the PARAMETER and DROPOUT messages in the data section */
+	const std::vector<uint64_t> &additionalMessages() const { return _additional_messages; }
+
+private:
+	static constexpr uint64_t data_start = sizeof(ulog_file_header_s) + sizeof(ulog_message_flag_bits_s);
+
+	/**
+	 * Read the flag bits message
+	 * @param data_end returned end of the data (start of appended data)
+	 * @return false if there is no flag bits message
+	 */
+	bool readFlagBits(ulog_message_flag_bits_s &flag_bits, uint64_t &data_end) const;
+
+	/**
+	 * Create the temporary file for the decoded data, starting with the file header and flag bits
+	 * @return nullptr on failure
+	 */
+	FILE *createDecodedFile() const;
+
+	/**
+	 * Replace the file data after the flag bits message with decoded data and clear the decoded_flag incompat bit
+	 * @param decoded file header, flag bits and decoded data. Appended data is moved behind it. Closed on failure,
+	 *                otherwise owned by this class.
+	 * @return false if the decoded data could not be written or mapped
+	 */
+	bool replaceData(FILE *decoded, ulog_message_flag_bits_s &flag_bits, uint64_t data_end, uint8_t decoded_flag);
+
+	/**
+	 * Decompress the file if it is compressed (@see ulog_compressed_frame_header_s).
+	 * The data section ends at the first incomplete or corrupt frame.
+	 * @return false on failure to store the decompressed data
+	 */
+	bool decompress();
+
+	/**
+	 * Convert delta encoded data messages into data messages (@see ulog_message_data_delta_s).
+	 * Messages that cannot be decoded are dropped until the next full sample.
+	 * @return false on failure to store the expanded data
+	 */
+	bool expandDeltas();
+
+	/**
+	 * Apply a delta to a sample
+	 * @return false if the delta does not match the sample
+	 */
+	static bool applyDelta(const uint8_t *delta, size_t size, std::vector<uint8_t> &sample);
+
+	int _fd{-1};
+	const uint8_t *_data{nullptr};
+	uint64_t _size{0};
+	FILE *_decoded_file{nullptr}; ///< temporary file mapped instead of the log if it is compressed or delta encoded
+
+	std::vector<std::vector<uint64_t>> _data_messages;
+	std::vector<uint64_t> _subscription_messages;
+	std::vector<uint64_t> _additional_messages;
+};
+
+} //namespace px4
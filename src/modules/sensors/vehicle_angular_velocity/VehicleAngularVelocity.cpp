@@ -172,14 +172,16 @@ void VehicleAngularVelocity::ResetFilters(const hrt_abstime &time_now_us)
 			_lp_filter_velocity[axis].reset(angular_velocity_uncalibrated(axis));
 
 			// angular velocity notch 0
-			_notch_filter0_velocity[axis].setParameters(_filter_sample_rate_hz, _param_imu_gyro_nf0_frq.get(),
-					_param_imu_gyro_nf0_bw.get());
-			_notch_filter0_velocity[axis].reset();
+			auto nf0 = _notch_filter_velocity.filter(NOTCH_FILTER0, axis);
+			nf0.setParameters(_filter_sample_rate_hz, _param_imu_gyro_nf0_frq.get(),
+					  _param_imu_gyro_nf0_bw.get());
+			nf0.reset();
 
 			// angular velocity notch 1
-			_notch_filter1_velocity[axis].setParameters(_filter_sample_rate_hz, _param_imu_gyro_nf1_frq.get(),
-					_param_imu_gyro_nf1_bw.get());
-			_notch_filter1_velocity[axis].reset();
+			auto nf1 = _notch_filter_velocity.filter(NOTCH_FILTER1, axis);
+			nf1.setParameters(_filter_sample_rate_hz, _param_imu_gyro_nf1_frq.get(),
+					  _param_imu_gyro_nf1_bw.get());
+			nf1.reset();
 
 			// angular acceleration low pass
 			if ((_param_imu_dgyro_cutoff.get() > 0.f)
@@ -405,7 +407,8 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 		}
 
 		// gyro notch filter 0 frequency or bandwidth changed
-		for (auto &nf : _notch_filter0_velocity) {
+		for (int axis = 0; axis < 3; axis++) {
+			const auto nf = _notch_filter_velocity.filter(NOTCH_FILTER0, axis);
 			const bool nf_freq_changed = (fabsf(nf.getNotchFreq() - _param_imu_gyro_nf0_frq.get()) > 0.01f);
 			const bool nf_bw_changed   = (fabsf(nf.getBandwidth() - _param_imu_gyro_nf0_bw.get()) > 0.01f);
 
@@ -416,7 +419,8 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 		}
 
 		// gyro notch filter 1 frequency or bandwidth changed
-		for (auto &nf : _notch_filter1_velocity) {
+		for (int axis = 0; axis < 3; axis++) {
+			const auto nf = _notch_filter_velocity.filter(NOTCH_FILTER1, axis);
 			const bool nf_freq_changed = (fabsf(nf.getNotchFreq() - _param_imu_gyro_nf1_frq.get()) > 0.01f);
 			const bool nf_bw_changed   = (fabsf(nf.getBandwidth() - _param_imu_gyro_nf1_bw.get()) > 0.01f);
 
@@ -537,7 +541,7 @@ void VehicleAngularVelocity::DisableDynamicNotchEscRpm()
 		for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
 			for (int axis = 0; axis < 3; axis++) {
 				for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
-					_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].disable();
+					_dynamic_notch_filter_esc_rpm[harmonic].filter(esc, axis).disable();
 					_esc_available.set(esc, false);
 					perf_count(_dynamic_notch_filter_esc_rpm_disable_perf);
 				}
@@ -555,7 +559,7 @@ void VehicleAngularVelocity::DisableDynamicNotchFFT()
 	if (_dynamic_notch_fft_available) {
 		for (int axis = 0; axis < 3; axis++) {
 			for (int peak = 0; peak < MAX_NUM_FFT_PEAKS; peak++) {
-				_dynamic_notch_filter_fft[axis][peak].disable();
+				_dynamic_notch_filter_fft.filter(peak, axis).disable();
 				perf_count(_dynamic_notch_filter_fft_disable_perf);
 			}
 		}
@@ -601,7 +605,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 
 						// update filter parameters if frequency changed or forced
 						for (int axis = 0; axis < 3; axis++) {
-							auto &nf = _dynamic_notch_filter_esc_rpm[harmonic][axis][esc];
+							auto nf = _dynamic_notch_filter_esc_rpm[harmonic].filter(esc, axis);
 
 							const float notch_freq_delta = fabsf(nf.getNotchFreq() - frequency_hz);
 
@@ -637,7 +641,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(const hrt_abstime &time_no
 				// disable notch filters from highest frequency to lowest
 				for (int harmonic = _esc_rpm_harmonics - 1; harmonic >= 0; harmonic--) {
 					for (int axis = 0; axis < 3; axis++) {
-						auto &nf = _dynamic_notch_filter_esc_rpm[harmonic][axis][esc];
+						auto nf = _dynamic_notch_filter_esc_rpm[harmonic].filter(esc, axis);
 
 						if (nf.getNotchFreq() > 0.f) {
 							if (nf.initialized() && !axis_init[axis]) {
@@ -693,7 +697,7 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 
 					const float peak_freq = peak_frequencies[axis][peak];
 
-					auto &nf = _dynamic_notch_filter_fft[axis][peak];
+					auto nf = _dynamic_notch_filter_fft.filter(peak, axis);
 
 					if (peak_freq > peak_freq_min) {
 						// update filter parameters if frequency changed or forced
@@ -722,44 +726,31 @@ void VehicleAngularVelocity::UpdateDynamicNotchFFT(const hrt_abstime &time_now_u
 #endif // !CONSTRAINED_FLASH
 }
 
-float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
+void VehicleAngularVelocity::NotchFilterAngularVelocity(float data[][math::NOTCH_FILTER_BANK_LANES], int N)
 {
+	// all notch filter banks filter the three axes together, disabled stages are skipped
 #if !defined(CONSTRAINED_FLASH)
 
 	// Apply dynamic notch filter from ESC RPM
 	if (_dynamic_notch_filter_esc_rpm) {
-		for (int esc = 0; esc < MAX_NUM_ESCS; esc++) {
-			if (_esc_available[esc]) {
-				for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
-					if (_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].getNotchFreq() > 0.f) {
-						_dynamic_notch_filter_esc_rpm[harmonic][axis][esc].applyArray(data, N);
-					}
-				}
-			}
+		for (int harmonic = 0; harmonic < _esc_rpm_harmonics; harmonic++) {
+			_dynamic_notch_filter_esc_rpm[harmonic].applyArray(data, N);
 		}
 	}
 
 	// Apply dynamic notch filter from FFT
 	if (_dynamic_notch_fft_available) {
-		for (int peak = MAX_NUM_FFT_PEAKS - 1; peak >= 0; peak--) {
-			if (_dynamic_notch_filter_fft[axis][peak].getNotchFreq() > 0.f) {
-				_dynamic_notch_filter_fft[axis][peak].applyArray(data, N);
-			}
-		}
+		_dynamic_notch_filter_fft.applyArray(data, N);
 	}
 
 #endif // !CONSTRAINED_FLASH
 
-	// Apply general notch filter 0 (IMU_GYRO_NF0_FRQ)
-	if (_notch_filter0_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter0_velocity[axis].applyArray(data, N);
-	}
-
-	// Apply general notch filter 1 (IMU_GYRO_NF1_FRQ)
-	if (_notch_filter1_velocity[axis].getNotchFreq() > 0.f) {
-		_notch_filter1_velocity[axis].applyArray(data, N);
-	}
+	// Apply general notch filters (IMU_GYRO_NF0_FRQ, IMU_GYRO_NF1_FRQ)
+	_notch_filter_velocity.applyArray(data, N);
+}
 
+float VehicleAngularVelocity::FilterAngularVelocity(int axis, float data[], int N)
+{
 	// Apply general low-pass filter (IMU_GYRO_CUTOFF)
 	_lp_filter_velocity[axis].applyArray(data, N);
 
@@ -830,7 +821,6 @@ void VehicleAngularVelocity::Run()
 
 			const float inverse_dt_s = 1e6f / sensor_fifo_data.dt;
 			const int N = sensor_fifo_data.samples;
-			static constexpr int FIFO_SIZE_MAX = sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0]);
 
 			if ((sensor_fifo_data.dt > 0) && (N > 0) && (N <= FIFO_SIZE_MAX)) {
 				Vector3f angular_velocity_uncalibrated;
@@ -838,12 +828,22 @@ void VehicleAngularVelocity::Run()
 
 				int16_t *raw_data_array[] {sensor_fifo_data.x, sensor_fifo_data.y, sensor_fifo_data.z};
 
+				// copy raw int16 sensor samples to interleaved float array for filtering
+				float (*data_xyz)[math::NOTCH_FILTER_BANK_LANES] = _fifo_data_xyz;
+
+				for (int n = 0; n < N; n++) {
+					for (int axis = 0; axis < 3; axis++) {
+						data_xyz[n][axis] = sensor_fifo_data.scale * raw_data_array[axis][n];
+					}
+				}
+
+				NotchFilterAngularVelocity(data_xyz, N);
+
 				for (int axis = 0; axis < 3; axis++) {
-					// copy raw int16 sensor samples to float array for filtering
 					float data[FIFO_SIZE_MAX];
 
 					for (int n = 0; n < N; n++) {
-						data[n] = sensor_fifo_data.scale * raw_data_array[axis][n];
+						data[n] = data_xyz[n][axis];
 					}
 
 					// save last filtered sample
@@ -885,11 +885,16 @@ void VehicleAngularVelocity::Run()
 				Vector3f angular_velocity_uncalibrated;
 				Vector3f angular_acceleration_uncalibrated;
 
-				float raw_data_array[] {sensor_data.x, sensor_data.y, sensor_data.z};
+				// copy sensor sample to interleaved float array for filtering
+				float data_xyz[1][math::NOTCH_FILTER_BANK_LANES] {};
+				data_xyz[0][0] = sensor_data.x;
+				data_xyz[0][1] = sensor_data.y;
+				data_xyz[0][2] = sensor_data.z;
+
+				NotchFilterAngularVelocity(data_xyz);
 
 				for (int axis = 0; axis < 3; axis++) {
-					// copy sensor sample to float array for filtering
-					float data[1] {raw_data_array[axis]};
+					float data[1] {data_xyz[0][axis]};
 
 					// save last filtered sample
 					angular_velocity_uncalibrated(axis) = FilterAngularVelocity(axis, data);
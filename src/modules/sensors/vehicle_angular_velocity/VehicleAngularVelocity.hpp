@@ -39,7 +39,7 @@
 #include <lib/matrix/matrix/math.hpp>
 #include <lib/mathlib/math/filter/AlphaFilter.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
-#include <lib/mathlib/math/filter/NotchFilter.hpp>
+#include <lib/mathlib/math/filter/NotchFilterBank.hpp>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_config.h>
@@ -78,6 +78,7 @@ private:
 	bool CalibrateAndPublish(const hrt_abstime &timestamp_sample, const matrix::Vector3f &angular_velocity_uncalibrated,
 				 const matrix::Vector3f &angular_acceleration_uncalibrated);
 
+	inline void NotchFilterAngularVelocity(float data[][math::NOTCH_FILTER_BANK_LANES], int N = 1);
 	inline float FilterAngularVelocity(int axis, float data[], int N = 1);
 	inline float FilterAngularAcceleration(int axis, float inverse_dt_s, float data[], int N = 1);
 
@@ -130,8 +131,15 @@ private:
 
 	// angular velocity filters
 	math::LowPassFilter2p<float> _lp_filter_velocity[3] {};
-	math::NotchFilter<float> _notch_filter0_velocity[3] {};
-	math::NotchFilter<float> _notch_filter1_velocity[3] {};
+
+	// stage 0: IMU_GYRO_NF0_FRQ, stage 1: IMU_GYRO_NF1_FRQ
+	static constexpr int NOTCH_FILTER0 = 0;
+	static constexpr int NOTCH_FILTER1 = 1;
+	math::NotchFilterBank<2> _notch_filter_velocity{};
+
+	// interleaved FIFO samples for the notch filter banks (kept off the work queue stack)
+	static constexpr int FIFO_SIZE_MAX = sizeof(sensor_gyro_fifo_s::x) / sizeof(sensor_gyro_fifo_s::x[0]);
+	float _fifo_data_xyz[FIFO_SIZE_MAX][math::NOTCH_FILTER_BANK_LANES] {};
 
 #if !defined(CONSTRAINED_FLASH)
 
@@ -145,7 +153,8 @@ private:
 	// ESC RPM
 	static constexpr int MAX_NUM_ESCS = sizeof(esc_status_s::esc) / sizeof(esc_status_s::esc[0]);
 
-	using NotchFilterHarmonic = math::NotchFilter<float>[3][MAX_NUM_ESCS];
+	// one bank (stage per ESC) for each harmonic
+	using NotchFilterHarmonic = math::NotchFilterBank<MAX_NUM_ESCS>;
 	NotchFilterHarmonic *_dynamic_notch_filter_esc_rpm{nullptr};
 
 	int _esc_rpm_harmonics{0};
@@ -160,7 +169,7 @@ private:
 	static constexpr int MAX_NUM_FFT_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x)
 			/ sizeof(sensor_gyro_fft_s::peak_frequencies_x[0]);
 
-	math::NotchFilter<float> _dynamic_notch_filter_fft[3][MAX_NUM_FFT_PEAKS] {};
+	math::NotchFilterBank<MAX_NUM_FFT_PEAKS> _dynamic_notch_filter_fft{};
 
 	perf_counter_t _dynamic_notch_filter_fft_disable_perf{nullptr};
 	perf_counter_t _dynamic_notch_filter_fft_update_perf{nullptr};
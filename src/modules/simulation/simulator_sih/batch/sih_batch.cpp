@@ -0,0 +1,399 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Simulate many independent SIH multicopters in parallel, each stepped together with the
+ * attitude and rate controllers as fast as possible, and print a CSV summary of each run.
+ *
+ * Usage: sih_batch [-j <threads>] [-n <runs>] [-s <seed>] [-t <duration_s>] [-r <rate_hz>]
+ *                  [-o <summary.csv>] [-p <PARAM>=<value>]... [-u <PARAM>=<fraction>]... [-f <sweep_file>]
+ *
+ * Every line of the sweep file is one configuration, given as whitespace separated <PARAM>=<value>
+ * pairs (empty lines and lines starting with '#' are skipped). Each configuration is simulated
+ * -n times with consecutive noise seeds, -u varies a parameter uniformly by +-fraction in each run.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <inttypes.h>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+#include "sih_batch_run.h"
+
+namespace
+{
+
+struct Run {
+	size_t configuration{0};
+	uint32_t seed{0};
+	std::map<std::string, float> params;
+
+	bool success{false};
+	std::string error;
+	SihBatchRun::Summary summary{};
+};
+
+void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-j <threads>] [-n <runs>] [-s <seed>] [-t <duration_s>] [-r <rate_hz>]\n"
+		"          [-o <summary.csv>] [-p <PARAM>=<value>]... [-u <PARAM>=<fraction>]...\n"
+		"          [-f <sweep_file>]\n", name);
+	fprintf(stderr, "  -j <threads>          number of runs simulated in parallel (default: number of CPUs)\n");
+	fprintf(stderr, "  -n <runs>             runs per configuration, each with another noise seed (default: 1)\n");
+	fprintf(stderr, "  -s <seed>             seed of the first run (default: 1)\n");
+	fprintf(stderr, "  -t <duration_s>       simulated time per run (default: %.0f)\n",
+		(double)SihBatchRun::min_duration_s);
+	fprintf(stderr, "  -r <rate_hz>          simulation and control rate (default: 400)\n");
+	fprintf(stderr, "  -o <summary.csv>      write the summary to a file instead of stdout\n");
+	fprintf(stderr, "  -p <PARAM>=<value>    set a parameter for all runs\n");
+	fprintf(stderr, "  -u <PARAM>=<fraction> vary a parameter uniformly by +-fraction of its value in every run\n");
+	fprintf(stderr, "  -f <sweep_file>       one configuration of <PARAM>=<value> pairs per line\n");
+}
+
+bool parseParameter(const std::string &arg, std::map<std::string, float> &params)
+{
+	const size_t separator = arg.find('=');
+
+	if (separator == std::string::npos || separator == 0) {
+		fprintf(stderr, "invalid parameter %s, expected <PARAM>=<value>\n", arg.c_str());
+		return false;
+	}
+
+	const std::string name = arg.substr(0, separator);
+	const char *value = arg.c_str() + separator + 1;
+	char *end = nullptr;
+	const float parsed = strtof(value, &end);
+
+	if (end == value || *end != '\0') {
+		fprintf(stderr, "invalid value in %s\n", arg.c_str());
+		return false;
+	}
+
+	for (const std::string &known : SihBatchRun::parameterNames()) {
+		if (known == name) {
+			params[name] = parsed;
+			return true;
+		}
+	}
+
+	fprintf(stderr, "unsupported parameter %s\n", name.c_str());
+	return false;
+}
+
+bool readSweepFile(const char *file_name, std::vector<std::map<std::string, float>> &configurations)
+{
+	std::ifstream file(file_name);
+
+	if (!file) {
+		fprintf(stderr, "failed to open %s\n", file_name);
+		return false;
+	}
+
+	std::string line;
+
+	while (std::getline(file, line)) {
+		std::istringstream tokens(line);
+		std::string token;
+		std::map<std::string, float> params;
+
+		if (!(tokens >> token) || token[0] == '#') {
+			continue;
+		}
+
+		do {
+			if (!parseParameter(token, params)) {
+				return false;
+			}
+		} while (tokens >> token);
+
+		configurations.push_back(params);
+	}
+
+	return true;
+}
+
+void printHeader(FILE *out, const std::set<std::string> &param_columns)
+{
+	fprintf(out, "run,configuration,seed");
+
+	for (const std::string &name : param_columns) {
+		fprintf(out, ",%s", name.c_str());
+	}
+
+	fprintf(out, ",duration_s,crashed");
+
+	for (const char *name : {"roll", "pitch", "yaw"}) {
+		fprintf(out, ",%s_rise_s,%s_overshoot_pct", name, name);
+	}
+
+	fprintf(out, ",att_err_rms_deg,rate_err_rms_deg_s,alt_err_rms_m,max_tilt_deg,saturation_pct\n");
+}
+
+void printRun(FILE *out, size_t index, const Run &run, const std::set<std::string> &param_columns)
+{
+	fprintf(out, "%zu,%zu,%" PRIu32, index, run.configuration, run.seed);
+
+	for (const std::string &name : param_columns) {
+		const auto it = run.params.find(name);
+
+		if (it != run.params.end()) {
+			fprintf(out, ",%g", (double)it->second);
+
+		} else {
+			fprintf(out, ",");
+		}
+	}
+
+	const SihBatchRun::Summary &summary = run.summary;
+	fprintf(out, ",%.3f,%d", (double)summary.duration_s, summary.crashed ? 1 : 0);
+
+	for (const SihBatchRun::StepResponse *response : {&summary.roll, &summary.pitch, &summary.yaw}) {
+		fprintf(out, ",%.3f,%.1f", (double)response->rise_time_s, (double)response->overshoot_pct);
+	}
+
+	fprintf(out, ",%.3f,%.2f,%.3f,%.1f,%.1f\n", (double)summary.attitude_error_rms_deg,
+		(double)summary.rate_error_rms_deg_s, (double)summary.altitude_error_rms_m,
+		(double)summary.max_tilt_deg, (double)summary.saturation_pct);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	unsigned num_threads = std::thread::hardware_concurrency();
+	unsigned runs_per_configuration = 1;
+	uint32_t first_seed = 1;
+	float duration_s = SihBatchRun::min_duration_s;
+	int rate_hz = 400;
+	const char *output_file = nullptr;
+	const char *sweep_file = nullptr;
+	std::map<std::string, float> param_overrides;
+	std::map<std::string, float> param_dispersions;
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "j:n:s:t:r:o:p:u:f:h")) != -1) {
+		switch (ch) {
+		case 'j':
+			num_threads = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'n':
+			runs_per_configuration = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 's':
+			first_seed = strtoul(optarg, nullptr, 10);
+			break;
+
+		case 't':
+			duration_s = strtof(optarg, nullptr);
+			break;
+
+		case 'r':
+			rate_hz = atoi(optarg);
+			break;
+
+		case 'o':
+			output_file = optarg;
+			break;
+
+		case 'p':
+			if (!parseParameter(optarg, param_overrides)) {
+				usage(argv[0]);
+				return 1;
+			}
+
+			break;
+
+		case 'u':
+			if (!parseParameter(optarg, param_dispersions)) {
+				usage(argv[0]);
+				return 1;
+			}
+
+			break;
+
+		case 'f':
+			sweep_file = optarg;
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind < argc || runs_per_configuration == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	// the defaults come from the parameter metadata of the build, which only contains the built modules
+	for (const std::string &name : SihBatchRun::parameterNames()) {
+		if (!PX4_ISFINITE(SihBatchRun::parameterDefault(name))) {
+			fprintf(stderr, "parameter %s is not part of this build\n", name.c_str());
+			return 1;
+		}
+	}
+
+	std::vector<std::map<std::string, float>> configurations;
+
+	if (sweep_file) {
+		if (!readSweepFile(sweep_file, configurations)) {
+			return 1;
+		}
+
+	} else {
+		configurations.emplace_back();
+	}
+
+	// all runs are set up front, so that the result only depends on the seed and not on the scheduling
+	std::vector<Run> runs;
+	std::set<std::string> param_columns;
+
+	for (size_t configuration = 0; configuration < configurations.size(); configuration++) {
+		for (unsigned i = 0; i < runs_per_configuration; i++) {
+			Run run;
+			run.configuration = configuration;
+			run.seed = first_seed + runs.size();
+			run.params = param_overrides;
+
+			for (const auto &param : configurations[configuration]) {
+				run.params[param.first] = param.second;
+			}
+
+			std::mt19937 generator(run.seed);
+			std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+			for (const auto &dispersion : param_dispersions) {
+				if (run.params.find(dispersion.first) == run.params.end()) {
+					// not set explicitly, disperse the default
+					run.params[dispersion.first] = SihBatchRun::parameterDefault(dispersion.first);
+				}
+
+				run.params[dispersion.first] *= 1.f + dispersion.second * distribution(generator);
+			}
+
+			for (const auto &param : run.params) {
+				param_columns.insert(param.first);
+			}
+
+			runs.push_back(run);
+		}
+	}
+
+	FILE *out = stdout;
+
+	if (output_file) {
+		out = fopen(output_file, "w");
+
+		if (!out) {
+			fprintf(stderr, "failed to open %s\n", output_file);
+			return 1;
+		}
+	}
+
+	// every worker takes the next run until all are done, the runs are independent
+	std::atomic<size_t> next_run{0};
+
+	auto worker = [&]() {
+		size_t index;
+
+		while ((index = next_run.fetch_add(1)) < runs.size()) {
+			Run &run = runs[index];
+			SihBatchRun batch_run(run.params, run.seed, duration_s, rate_hz);
+
+			run.success = batch_run.run();
+			run.error = batch_run.error();
+			run.summary = batch_run.summary();
+		}
+	};
+
+	if (num_threads == 0) {
+		num_threads = 1;
+	}
+
+	if (num_threads > runs.size()) {
+		num_threads = runs.size();
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+
+	for (unsigned i = 1; i < num_threads; i++) {
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printHeader(out, param_columns);
+
+	int failed = 0;
+	double simulated_s = 0.;
+
+	for (size_t i = 0; i < runs.size(); i++) {
+		if (runs[i].success) {
+			printRun(out, i, runs[i], param_columns);
+			simulated_s += runs[i].summary.duration_s;
+
+		} else {
+			fprintf(stderr, "run %zu: %s\n", i, runs[i].error.c_str());
+			failed++;
+		}
+	}
+
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	fprintf(stderr, "%zu runs on %u threads: %.1f s simulated in %.2f s (%.0fx realtime)\n",
+		runs.size(), num_threads, simulated_s, elapsed_s, simulated_s / elapsed_s);
+
+	return (failed > 0) ? 1 : 0;
+}
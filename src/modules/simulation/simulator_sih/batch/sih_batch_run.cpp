@@ -0,0 +1,372 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "sih_batch_run.h"
+
+#include <parameters/px4_parameters.hpp>
+#include <string.h>
+
+using namespace matrix;
+
+namespace
+{
+
+// parameters of sih_params.c, mc_att_control_params.c, mc_rate_control_params.c and imu_gyro_parameters.c
+// used by the runs, their defaults are taken from the parameter metadata generated for the build
+const char *const parameter_names[] = {
+	"SIH_VEHICLE_TYPE",
+	"SIH_MASS",
+	"SIH_IXX",
+	"SIH_IYY",
+	"SIH_IZZ",
+	"SIH_IXY",
+	"SIH_IXZ",
+	"SIH_IYZ",
+	"SIH_T_MAX",
+	"SIH_Q_MAX",
+	"SIH_L_ROLL",
+	"SIH_L_PITCH",
+	"SIH_KDV",
+	"SIH_KDW",
+	"SIH_LOC_H0",
+	"SIH_T_TAU",
+	"MC_ROLL_P",
+	"MC_PITCH_P",
+	"MC_YAW_P",
+	"MC_YAW_WEIGHT",
+	"MC_ROLLRATE_MAX",
+	"MC_PITCHRATE_MAX",
+	"MC_YAWRATE_MAX",
+	"MC_ROLLRATE_P",
+	"MC_ROLLRATE_I",
+	"MC_ROLLRATE_D",
+	"MC_ROLLRATE_FF",
+	"MC_ROLLRATE_K",
+	"MC_RR_INT_LIM",
+	"MC_PITCHRATE_P",
+	"MC_PITCHRATE_I",
+	"MC_PITCHRATE_D",
+	"MC_PITCHRATE_FF",
+	"MC_PITCHRATE_K",
+	"MC_PR_INT_LIM",
+	"MC_YAWRATE_P",
+	"MC_YAWRATE_I",
+	"MC_YAWRATE_D",
+	"MC_YAWRATE_FF",
+	"MC_YAWRATE_K",
+	"MC_YR_INT_LIM",
+	"IMU_GYRO_CUTOFF",
+	"IMU_DGYRO_CUTOFF",
+};
+
+std::map<std::string, float> loadParameterDefaults()
+{
+	std::map<std::string, float> defaults;
+
+	for (const char *name : parameter_names) {
+		defaults[name] = NAN;
+
+		for (size_t i = 0; i < sizeof(px4::parameters) / sizeof(px4::parameters[0]); i++) {
+			const param_info_s &info = px4::parameters[i];
+
+			if (strcmp(info.name, name) == 0) {
+				const bool is_int = (px4::parameters_type[i] == PARAM_TYPE_INT32);
+				defaults[name] = is_int ? (float)info.val.i : info.val.f;
+				break;
+			}
+		}
+	}
+
+	return defaults;
+}
+
+const std::map<std::string, float> &parameterDefaults()
+{
+	static const std::map<std::string, float> defaults = loadParameterDefaults();
+	return defaults;
+}
+
+// setpoint sequence
+constexpr float takeoff_altitude = 5.f;  // [m]
+constexpr float sequence_start = 3.f;    // [s] after takeoff
+constexpr float roll_step_start = 3.f;
+constexpr float roll_step_end = 5.f;
+constexpr float pitch_step_start = 7.f;
+constexpr float pitch_step_end = 9.f;
+constexpr float yaw_step_start = 11.f;
+constexpr float tilt_step = math::radians(20.f);
+constexpr float yaw_step = math::radians(90.f);
+
+// altitude controller
+constexpr float altitude_p = 1.f;        // [1/s]
+constexpr float vertical_speed_p = 0.2f; // [1/(m/s)]
+constexpr float vertical_speed_max = 2.f;
+
+constexpr float crash_tilt = math::radians(80.f);
+
+} // namespace
+
+SihBatchRun::SihBatchRun(const std::map<std::string, float> &params, uint32_t seed, float duration_s, int rate_hz) :
+	_seed(seed),
+	_duration_s(duration_s),
+	_rate_hz(rate_hz)
+{
+	_params = parameterDefaults();
+
+	for (const auto &param : params) {
+		_params[param.first] = param.second;
+	}
+}
+
+std::vector<std::string> SihBatchRun::parameterNames()
+{
+	std::vector<std::string> names;
+
+	for (const char *name : parameter_names) {
+		names.emplace_back(name);
+	}
+
+	return names;
+}
+
+float SihBatchRun::parameterDefault(const std::string &name)
+{
+	const auto it = parameterDefaults().find(name);
+	return (it != parameterDefaults().end()) ? it->second : NAN;
+}
+
+float SihBatchRun::param(const char *name) const
+{
+	const auto it = _params.find(name);
+	return (it != _params.end()) ? it->second : NAN;
+}
+
+void SihBatchRun::configure()
+{
+	SihModel::Parameters model_params{};
+	model_params.vehicle = SihModel::VehicleType::MC;
+	model_params.mass = param("SIH_MASS");
+	model_params.ixx = param("SIH_IXX");
+	model_params.iyy = param("SIH_IYY");
+	model_params.izz = param("SIH_IZZ");
+	model_params.ixy = param("SIH_IXY");
+	model_params.ixz = param("SIH_IXZ");
+	model_params.iyz = param("SIH_IYZ");
+	model_params.t_max = param("SIH_T_MAX");
+	model_params.q_max = param("SIH_Q_MAX");
+	model_params.l_roll = param("SIH_L_ROLL");
+	model_params.l_pitch = param("SIH_L_PITCH");
+	model_params.kdv = param("SIH_KDV");
+	model_params.kdw = param("SIH_KDW");
+	model_params.h0 = param("SIH_LOC_H0");
+	model_params.t_tau = param("SIH_T_TAU");
+	_model.set_parameters(model_params);
+	_model.init_variables(_seed);
+
+	// same as in mc_att_control and mc_rate_control
+	_attitude_control.setProportionalGain(Vector3f(param("MC_ROLL_P"), param("MC_PITCH_P"), param("MC_YAW_P")),
+					      param("MC_YAW_WEIGHT"));
+	_attitude_control.setRateLimit(Vector3f(math::radians(param("MC_ROLLRATE_MAX")),
+						math::radians(param("MC_PITCHRATE_MAX")),
+						math::radians(param("MC_YAWRATE_MAX"))));
+
+	const Vector3f rate_k(param("MC_ROLLRATE_K"), param("MC_PITCHRATE_K"), param("MC_YAWRATE_K"));
+	_rate_control.setPidGains(
+		rate_k.emult(Vector3f(param("MC_ROLLRATE_P"), param("MC_PITCHRATE_P"), param("MC_YAWRATE_P"))),
+		rate_k.emult(Vector3f(param("MC_ROLLRATE_I"), param("MC_PITCHRATE_I"), param("MC_YAWRATE_I"))),
+		rate_k.emult(Vector3f(param("MC_ROLLRATE_D"), param("MC_PITCHRATE_D"), param("MC_YAWRATE_D"))));
+	_rate_control.setIntegratorLimit(
+		Vector3f(param("MC_RR_INT_LIM"), param("MC_PR_INT_LIM"), param("MC_YR_INT_LIM")));
+	_rate_control.setFeedForwardGain(Vector3f(param("MC_ROLLRATE_FF"), param("MC_PITCHRATE_FF"),
+					 param("MC_YAWRATE_FF")));
+
+	_gyro_filter.set_cutoff_frequency(_rate_hz, param("IMU_GYRO_CUTOFF"));
+	_angular_accel_filter.set_cutoff_frequency(_rate_hz, param("IMU_DGYRO_CUTOFF"));
+
+	_hover_thrust = model_params.mass * CONSTANTS_ONE_G / (4.f * model_params.t_max);
+}
+
+Quatf SihBatchRun::attitudeSetpoint(float t) const
+{
+	const float roll = (t >= roll_step_start && t < roll_step_end) ? tilt_step : 0.f;
+	const float pitch = (t >= pitch_step_start && t < pitch_step_end) ? tilt_step : 0.f;
+	const float yaw = (t >= yaw_step_start) ? yaw_step : 0.f;
+	return Quatf(Eulerf(roll, pitch, yaw));
+}
+
+void SihBatchRun::mix(float thrust, const Vector3f &torque, float outputs[SihModel::NB_MOTORS]) const
+{
+	// motor order and torque directions of SihModel::generate_force_and_torques()
+	static constexpr float roll_factor[4] = {-1.f, 1.f, 1.f, -1.f};
+	static constexpr float pitch_factor[4] = {1.f, -1.f, 1.f, -1.f};
+	static constexpr float yaw_factor[4] = {1.f, 1.f, -1.f, -1.f};
+
+	for (int i = 0; i < 4; i++) {
+		const float output = thrust + M_SQRT1_2_F * (roll_factor[i] * torque(0) + pitch_factor[i] * torque(1))
+				     + yaw_factor[i] * torque(2);
+		outputs[i] = math::constrain(output, 0.f, 1.f);
+	}
+
+	for (int i = 4; i < SihModel::NB_MOTORS; i++) {
+		outputs[i] = 0.f;
+	}
+}
+
+void SihBatchRun::updateStepResponse(StepResponse &response, float t, float t_start, float value, float target) const
+{
+	if (!PX4_ISFINITE(response.rise_time_s) && value >= 0.9f * target) {
+		response.rise_time_s = t - t_start;
+	}
+
+	response.overshoot_pct = math::max(response.overshoot_pct, (value - target) / target * 100.f);
+}
+
+bool SihBatchRun::run()
+{
+	if (lroundf(param("SIH_VEHICLE_TYPE")) != 0) {
+		_error = "only the multicopter (SIH_VEHICLE_TYPE 0) is supported";
+		return false;
+	}
+
+	if (_rate_hz < 100 || _rate_hz > 2000) {
+		_error = "rate must be between 100 and 2000 Hz";
+		return false;
+	}
+
+	if (_duration_s < min_duration_s) {
+		_error = "duration too short for the setpoint sequence";
+		return false;
+	}
+
+	configure();
+
+	const float dt = 1.f / _rate_hz;
+	const uint32_t steps = (uint32_t)lroundf(_duration_s * _rate_hz);
+
+	float outputs[SihModel::NB_MOTORS] {};
+	Vector3f rate_prev{};
+
+	double attitude_error_sum_sq = 0.;
+	double rate_error_sum_sq = 0.;
+	double altitude_error_sum_sq = 0.;
+	uint32_t sequence_steps = 0;
+	uint32_t saturated_steps = 0;
+
+	for (uint32_t step = 1; step <= steps; step++) {
+		_model.update_motors(outputs, dt);
+		_model.generate_force_and_torques();
+		_model.equations_of_motion(dt);
+
+		Vector3f accel;
+		Vector3f gyro;
+		_model.reconstruct_sensors_signals(accel, gyro);
+
+		const float t = step * dt;
+		_summary.steps = step;
+		_summary.duration_s = t;
+
+		// gyro filtering as in vehicle_angular_velocity (without notch filters)
+		const Vector3f rate = _gyro_filter.apply(gyro);
+		const Vector3f angular_accel = _angular_accel_filter.apply((rate - rate_prev) / dt);
+		rate_prev = rate;
+
+		// the attitude controller uses the true attitude, there is no estimator in the loop
+		const Quatf &q = _model.attitude();
+		const Quatf q_sp = attitudeSetpoint(t);
+		_attitude_control.setAttitudeSetpoint(q_sp, 0.f);
+		const Vector3f rate_sp = _attitude_control.update(q);
+		const Vector3f torque = _rate_control.update(rate, rate_sp, angular_accel, dt, _model.grounded());
+
+		// vertical speed and thrust control to hold the takeoff altitude
+		const float altitude_error = -takeoff_altitude - _model.position()(2);
+		const float vz_sp = math::constrain(altitude_p * altitude_error, -vertical_speed_max,
+						    vertical_speed_max);
+		const float tilt_cos = Dcmf(q)(2, 2);
+		const float thrust = (_hover_thrust + vertical_speed_p * (_model.velocity()(2) - vz_sp))
+				     / math::max(tilt_cos, 0.5f);
+
+		mix(math::constrain(thrust, 0.f, 1.f), torque, outputs);
+
+		const float tilt = acosf(math::constrain(tilt_cos, -1.f, 1.f));
+		_summary.max_tilt_deg = math::max(_summary.max_tilt_deg, math::degrees(tilt));
+
+		if (t < sequence_start) {
+			continue;
+		}
+
+		if (_model.grounded() || tilt > crash_tilt || !q.isAllFinite()) {
+			_summary.crashed = true;
+			break;
+		}
+
+		const Eulerf euler(q);
+		const float roll = euler.phi();
+		const float pitch = euler.theta();
+		const float yaw = euler.psi();
+
+		if (t >= roll_step_start && t < roll_step_end) {
+			updateStepResponse(_summary.roll, t, roll_step_start, roll, tilt_step);
+
+		} else if (t >= pitch_step_start && t < pitch_step_end) {
+			updateStepResponse(_summary.pitch, t, pitch_step_start, pitch, tilt_step);
+
+		} else if (t >= yaw_step_start) {
+			updateStepResponse(_summary.yaw, t, yaw_step_start, yaw, yaw_step);
+		}
+
+		const Quatf q_error = q_sp.inversed() * q;
+		const float attitude_error = 2.f * acosf(math::constrain(fabsf(q_error(0)), 0.f, 1.f));
+		const float rate_error = (rate_sp - _model.angular_velocity()).norm();
+
+		attitude_error_sum_sq += (double)(attitude_error * attitude_error);
+		rate_error_sum_sq += (double)(rate_error * rate_error);
+		altitude_error_sum_sq += (double)(altitude_error * altitude_error);
+		sequence_steps++;
+
+		for (int i = 0; i < 4; i++) {
+			if (outputs[i] <= 0.f || outputs[i] >= 1.f) {
+				saturated_steps++;
+				break;
+			}
+		}
+	}
+
+	if (sequence_steps > 0) {
+		_summary.attitude_error_rms_deg = math::degrees((float)sqrt(attitude_error_sum_sq / sequence_steps));
+		_summary.rate_error_rms_deg_s = math::degrees((float)sqrt(rate_error_sum_sq / sequence_steps));
+		_summary.altitude_error_rms_m = (float)sqrt(altitude_error_sum_sq / sequence_steps);
+		_summary.saturation_pct = 100.f * saturated_steps / sequence_steps;
+	}
+
+	return true;
+}
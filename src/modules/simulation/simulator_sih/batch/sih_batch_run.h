@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * One closed loop run of the SIH multicopter model, without uORB, work queues or
+ * lockstep: the model is stepped together with the PX4 attitude and rate controllers
+ * as fast as possible through a fixed setpoint sequence (hover, roll, pitch and yaw steps).
+ */
+#ifndef SIH_BATCH_RUN_H
+#define SIH_BATCH_RUN_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <AttitudeControl.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2p.hpp>
+#include <rate_control.hpp>
+
+#include "../sih_model.hpp"
+
+class SihBatchRun
+{
+public:
+	/** response to an attitude step in one axis */
+	struct StepResponse {
+		float rise_time_s{NAN};    ///< time to reach 90% of the step
+		float overshoot_pct{0.f};  ///< maximum overshoot in percent of the step
+	};
+
+	struct Summary {
+		float duration_s{0.f};      ///< simulated time, shorter than requested if crashed
+		uint32_t steps{0};
+
+		StepResponse roll;
+		StepResponse pitch;
+		StepResponse yaw;
+
+		float attitude_error_rms_deg{NAN};
+		float rate_error_rms_deg_s{NAN};
+		float altitude_error_rms_m{NAN};
+		float max_tilt_deg{0.f};
+		float saturation_pct{0.f};  ///< share of the steps with at least one motor saturated
+		bool crashed{false};
+	};
+
+	/**
+	 * @param params SIH_*, MC_* and IMU_* parameter values, unset ones use their default
+	 * @param seed seed of the sensor noise
+	 * @param duration_s simulated time
+	 * @param rate_hz simulation and control loop rate
+	 */
+	SihBatchRun(const std::map<std::string, float> &params, uint32_t seed, float duration_s, int rate_hz);
+	~SihBatchRun() = default;
+
+	/**
+	 * Run the whole setpoint sequence
+	 * @return false if the configuration cannot be simulated, error() contains the reason
+	 */
+	bool run();
+
+	const Summary &summary() const { return _summary; }
+	const std::string &error() const { return _error; }
+
+	/** names of the parameters that can be set */
+	static std::vector<std::string> parameterNames();
+
+	/** default value of a parameter, NAN if unknown */
+	static float parameterDefault(const std::string &name);
+
+	/** minimal duration to include all steps of the setpoint sequence */
+	static constexpr float min_duration_s = 14.f;
+
+private:
+	float param(const char *name) const;
+
+	void configure();
+
+	/** attitude setpoint (and altitude setpoint) of the sequence at time t */
+	matrix::Quatf attitudeSetpoint(float t) const;
+
+	/** simple quadrotor X mixer, normalized like the control allocation for the sihsim_quadx geometry */
+	void mix(float thrust, const matrix::Vector3f &torque, float outputs[SihModel::NB_MOTORS]) const;
+
+	void updateStepResponse(StepResponse &response, float t, float t_start, float value, float target) const;
+
+	std::map<std::string, float> _params;
+	const uint32_t _seed;
+	const float _duration_s;
+	const int _rate_hz;
+
+	SihModel _model;
+	AttitudeControl _attitude_control;
+	RateControl _rate_control;
+	math::LowPassFilter2p<matrix::Vector3f> _gyro_filter;
+	math::LowPassFilter2p<matrix::Vector3f> _angular_accel_filter;
+
+	float _hover_thrust{0.5f};
+
+	Summary _summary{};
+	std::string _error;
+};
+
+#endif // !SIH_BATCH_RUN_H
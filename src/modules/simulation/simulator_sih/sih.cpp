@@ -214,7 +214,7 @@ void Sih::sensor_step()
 
 	equations_of_motion(dt);
 
-	reconstruct_sensors_signals(now);
+	publish_sensors_signals(now);
 
 	if ((_vehicle == VehicleType::FW || _vehicle == VehicleType::TS) && now - _airspeed_time >= 50_ms) {
 		_airspeed_time = now;
@@ -235,47 +235,32 @@ void Sih::sensor_step()
 
 void Sih::parameters_updated()
 {
-	_T_MAX = _sih_t_max.get();
-	_Q_MAX = _sih_q_max.get();
-	_L_ROLL = _sih_l_roll.get();
-	_L_PITCH = _sih_l_pitch.get();
-	_KDV = _sih_kdv.get();
-	_KDW = _sih_kdw.get();
-	_H0 = _sih_h0.get();
+	SihModel::Parameters params{};
+	params.vehicle = _vehicle; // the vehicle type is only read at startup
+	params.mass = _sih_mass.get();
+	params.ixx = _sih_ixx.get();
+	params.iyy = _sih_iyy.get();
+	params.izz = _sih_izz.get();
+	params.ixy = _sih_ixy.get();
+	params.ixz = _sih_ixz.get();
+	params.iyz = _sih_iyz.get();
+	params.t_max = _sih_t_max.get();
+	params.q_max = _sih_q_max.get();
+	params.l_roll = _sih_l_roll.get();
+	params.l_pitch = _sih_l_pitch.get();
+	params.kdv = _sih_kdv.get();
+	params.kdw = _sih_kdw.get();
+	params.h0 = _sih_h0.get();
+	params.t_tau = _sih_thrust_tau.get();
+	set_parameters(params);
 
 	_LAT0 = (double)_sih_lat0.get();
 	_LON0 = (double)_sih_lon0.get();
 	_COS_LAT0 = cosl((long double)radians(_LAT0));
 
-	_MASS = _sih_mass.get();
-
-	_W_I = Vector3f(0.0f, 0.0f, _MASS * CONSTANTS_ONE_G);
-
-	_I = diag(Vector3f(_sih_ixx.get(), _sih_iyy.get(), _sih_izz.get()));
-	_I(0, 1) = _I(1, 0) = _sih_ixy.get();
-	_I(0, 2) = _I(2, 0) = _sih_ixz.get();
-	_I(1, 2) = _I(2, 1) = _sih_iyz.get();
-
-	// guards against too small determinants
-	_Im1 = 100.0f * inv(static_cast<typeof _I>(100.0f * _I));
-
 	_distance_snsr_min = _sih_distance_snsr_min.get();
 	_distance_snsr_max = _sih_distance_snsr_max.get();
 	_distance_snsr_override = _sih_distance_snsr_override.get();
-
-	_T_TAU = _sih_thrust_tau.get();
-}
-
-void Sih::init_variables()
-{
-	srand(1234);    // initialize the random seed once before calling generate_wgn()
-
-	_p_I = Vector3f(0.0f, 0.0f, 0.0f);
-	_v_I = Vector3f(0.0f, 0.0f, 0.0f);
-	_q = Quatf(1.0f, 0.0f, 0.0f, 0.0f);
-	_w_B = Vector3f(0.0f, 0.0f, 0.0f);
-
-	_u[0] = _u[1] = _u[2] = _u[3] = 0.0f;
 }
 
 void Sih::read_motors(const float dt)
@@ -284,161 +269,15 @@ void Sih::read_motors(const float dt)
 
 	if (_actuator_out_sub.update(&actuators_out)) {
 		_last_actuator_output_time = actuators_out.timestamp;
-
-		for (int i = 0; i < NB_MOTORS; i++) { // saturate the motor signals
-			if ((_vehicle == VehicleType::FW && i < 3) || (_vehicle == VehicleType::TS && i > 3)) {
-				_u[i] = actuators_out.output[i];
-
-			} else {
-				float u_sp = actuators_out.output[i];
-				_u[i] = _u[i] + dt / _T_TAU * (u_sp - _u[i]); // first order transfer function with time constant tau
-			}
-		}
-	}
-}
-
-void Sih::generate_force_and_torques()
-{
-	if (_vehicle == VehicleType::MC) {
-		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (+_u[0] + _u[1] + _u[2] + _u[3]));
-		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (-_u[0] + _u[1] + _u[2] - _u[3]),
-				 _L_PITCH * _T_MAX * (+_u[0] - _u[1] + _u[2] - _u[3]),
-				 _Q_MAX * (+_u[0] + _u[1] - _u[2] - _u[3]));
-		_Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
-		_Ma_B = -_KDW * _w_B;   // first order angular damper
-
-	} else if (_vehicle == VehicleType::FW) {
-		_T_B = Vector3f(_T_MAX * _u[3], 0.0f, 0.0f); 	// forward thruster
-		// _Mt_B = Vector3f(_Q_MAX*_u[3], 0.0f,0.0f); 	// thruster torque
-		_Mt_B = Vector3f();
-		generate_fw_aerodynamics();
-
-	} else if (_vehicle == VehicleType::TS) {
-		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (_u[0] + _u[1]));
-		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (_u[1] - _u[0]), 0.0f, _Q_MAX * (_u[1] - _u[0]));
-		generate_ts_aerodynamics();
-
-		// _Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
-		// _Ma_B = -_KDW * _w_B;   // first order angular damper
-	}
-}
-
-void Sih::generate_fw_aerodynamics()
-{
-	_v_B = _C_IB.transpose() * _v_I; 	// velocity in body frame [m/s]
-	float altitude = _H0 - _p_I(2);
-	_wing_l.update_aero(_v_B, _w_B, altitude, _u[0]*FLAP_MAX);
-	_wing_r.update_aero(_v_B, _w_B, altitude, -_u[0]*FLAP_MAX);
-	_tailplane.update_aero(_v_B, _w_B, altitude, _u[1]*FLAP_MAX, _T_MAX * _u[3]);
-	_fin.update_aero(_v_B, _w_B, altitude, _u[2]*FLAP_MAX, _T_MAX * _u[3]);
-	_fuselage.update_aero(_v_B, _w_B, altitude);
-
-	// sum of aerodynamic forces
-	_Fa_I = _C_IB * (_wing_l.get_Fa() + _wing_r.get_Fa() + _tailplane.get_Fa() + _fin.get_Fa() + _fuselage.get_Fa()) - _KDV
-		* _v_I;
-
-	// aerodynamic moments
-	_Ma_B = _wing_l.get_Ma() + _wing_r.get_Ma() + _tailplane.get_Ma() + _fin.get_Ma() + _fuselage.get_Ma() - _KDW * _w_B;
-}
-
-void Sih::generate_ts_aerodynamics()
-{
-	// velocity in body frame [m/s]
-	_v_B = _C_IB.transpose() * _v_I;
-
-	// the aerodynamic is resolved in a frame like a standard aircraft (nose-right-belly)
-	Vector3f v_ts = _C_BS.transpose() * _v_B;
-	Vector3f w_ts = _C_BS.transpose() * _w_B;
-	float altitude = _H0 - _p_I(2);
-
-	Vector3f Fa_ts{};
-	Vector3f Ma_ts{};
-
-	for (int i = 0; i < NB_TS_SEG; i++) {
-		if (i <= NB_TS_SEG / 2) {
-			_ts[i].update_aero(v_ts, w_ts, altitude, _u[5]*TS_DEF_MAX, _T_MAX * _u[1]);
-
-		} else {
-			_ts[i].update_aero(v_ts, w_ts, altitude, -_u[4]*TS_DEF_MAX, _T_MAX * _u[0]);
-		}
-
-		Fa_ts += _ts[i].get_Fa();
-		Ma_ts += _ts[i].get_Ma();
-	}
-
-	_Fa_I = _C_IB * _C_BS * Fa_ts - _KDV * _v_I; 	// sum of aerodynamic forces
-	_Ma_B = _C_BS * Ma_ts - _KDW * _w_B; 	// aerodynamic moments
-}
-
-void Sih::equations_of_motion(const float dt)
-{
-	_C_IB = matrix::Dcm<float>(_q); // body to inertial transformation
-
-	// Equations of motion of a rigid body
-	_p_I_dot = _v_I;                        // position differential
-	_v_I_dot = (_W_I + _Fa_I + _C_IB * _T_B) / _MASS;   // conservation of linear momentum
-	// _q_dot = _q.derivative1(_w_B);              // attitude differential
-	_dq = Quatf::expq(0.5f * dt * _w_B);
-	_w_B_dot = _Im1 * (_Mt_B + _Ma_B - _w_B.cross(_I * _w_B)); // conservation of angular momentum
-
-	// fake ground, avoid free fall
-	if (_p_I(2) > 0.0f && (_v_I_dot(2) > 0.0f || _v_I(2) > 0.0f)) {
-		if (_vehicle == VehicleType::MC || _vehicle == VehicleType::TS) {
-			if (!_grounded) {    // if we just hit the floor
-				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
-				_v_I_dot = -_v_I / dt;
-
-			} else {
-				_v_I_dot.setZero();
-			}
-
-			_v_I.setZero();
-			_w_B.setZero();
-			_grounded = true;
-
-		} else if (_vehicle == VehicleType::FW) {
-			if (!_grounded) {    // if we just hit the floor
-				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
-				_v_I_dot(2) = -_v_I(2) / dt;
-
-			} else {
-				// we only allow negative acceleration in order to takeoff
-				_v_I_dot(2) = fminf(_v_I_dot(2), 0.0f);
-			}
-
-			// integration: Euler forward
-			_p_I = _p_I + _p_I_dot * dt;
-			_v_I = _v_I + _v_I_dot * dt;
-			Eulerf RPY = Eulerf(_q);
-			RPY(0) = 0.0f;	// no roll
-			RPY(1) = radians(0.0f); // pitch slightly up if needed to get some lift
-			_q = Quatf(RPY);
-			_w_B.setZero();
-			_grounded = true;
-		}
-
-	} else {
-		// integration: Euler forward
-		_p_I = _p_I + _p_I_dot * dt;
-		_v_I = _v_I + _v_I_dot * dt;
-		_q = _q * _dq;
-		_q.normalize();
-		// integration Runge-Kutta 4
-		// rk4_update(_p_I, _v_I, _q, _w_B);
-		_w_B = constrain(_w_B + _w_B_dot * dt, -6.0f * M_PI_F, 6.0f * M_PI_F);
-		_grounded = false;
+		update_motors(actuators_out.output, dt);
 	}
 }
 
-void Sih::reconstruct_sensors_signals(const hrt_abstime &time_now_us)
+void Sih::publish_sensors_signals(const hrt_abstime &time_now_us)
 {
-	// The sensor signals reconstruction and noise levels are from [1]
-	// [1] Bulka, Eitan, and Meyer Nahon. "Autonomous fixed-wing aerobatics: from theory to flight."
-	//     In 2018 IEEE International Conference on Robotics and Automation (ICRA), pp. 6573-6580. IEEE, 2018.
-
-	// IMU
-	Vector3f acc = _C_IB.transpose() * (_v_I_dot - Vector3f(0.0f, 0.0f, CONSTANTS_ONE_G)) + noiseGauss3f(0.5f, 1.7f, 1.4f);
-	Vector3f gyro = _w_B + noiseGauss3f(0.14f, 0.07f, 0.03f);
+	Vector3f acc;
+	Vector3f gyro;
+	reconstruct_sensors_signals(acc, gyro);
 
 	// update IMU every iteration
 	_px4_accel.update(time_now_us, acc(0), acc(1), acc(2));
@@ -566,40 +405,6 @@ void Sih::publish_ground_truth(const hrt_abstime &time_now_us)
 	}
 }
 
-float Sih::generate_wgn()   // generate white Gaussian noise sample with std=1
-{
-	// algorithm 1:
-	// float temp=((float)(rand()+1))/(((float)RAND_MAX+1.0f));
-	// return sqrtf(-2.0f*logf(temp))*cosf(2.0f*M_PI_F*rand()/RAND_MAX);
-	// algorithm 2: from BlockRandGauss.hpp
-	static float V1, V2, S;
-	static bool phase = true;
-	float X;
-
-	if (phase) {
-		do {
-			float U1 = (float)rand() / (float)RAND_MAX;
-			float U2 = (float)rand() / (float)RAND_MAX;
-			V1 = 2.0f * U1 - 1.0f;
-			V2 = 2.0f * U2 - 1.0f;
-			S = V1 * V1 + V2 * V2;
-		} while (S >= 1.0f || fabsf(S) < 1e-8f);
-
-		X = V1 * float(sqrtf(-2.0f * float(logf(S)) / S));
-
-	} else {
-		X = V2 * float(sqrtf(-2.0f * float(logf(S)) / S));
-	}
-
-	phase = !phase;
-	return X;
-}
-
-Vector3f Sih::noiseGauss3f(float stdx, float stdy, float stdz)
-{
-	return Vector3f(generate_wgn() * stdx, generate_wgn() * stdy, generate_wgn() * stdz);
-}
-
 int Sih::print_status()
 {
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -0,0 +1,280 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file sih_model.cpp
+ * Vehicle model of the Simulator in Hardware
+ */
+
+#include "sih_model.hpp"
+
+using namespace math;
+using namespace matrix;
+
+void SihModel::set_parameters(const Parameters &params)
+{
+	_vehicle = params.vehicle;
+
+	_T_MAX = params.t_max;
+	_Q_MAX = params.q_max;
+	_L_ROLL = params.l_roll;
+	_L_PITCH = params.l_pitch;
+	_KDV = params.kdv;
+	_KDW = params.kdw;
+	_H0 = params.h0;
+	_T_TAU = params.t_tau;
+
+	_MASS = params.mass;
+
+	_W_I = Vector3f(0.0f, 0.0f, _MASS * CONSTANTS_ONE_G);
+
+	_I = diag(Vector3f(params.ixx, params.iyy, params.izz));
+	_I(0, 1) = _I(1, 0) = params.ixy;
+	_I(0, 2) = _I(2, 0) = params.ixz;
+	_I(1, 2) = _I(2, 1) = params.iyz;
+
+	// guards against too small determinants
+	_Im1 = 100.0f * inv(static_cast<typeof _I>(100.0f * _I));
+}
+
+void SihModel::init_variables(uint32_t seed)
+{
+	// initialize the random seed once before calling generate_wgn() (xorshift needs a non-zero state)
+	_rand_state = (seed != 0) ? seed : 1234;
+	_wgn_phase = true;
+
+	_p_I = Vector3f(0.0f, 0.0f, 0.0f);
+	_v_I = Vector3f(0.0f, 0.0f, 0.0f);
+	_q = Quatf(1.0f, 0.0f, 0.0f, 0.0f);
+	_w_B = Vector3f(0.0f, 0.0f, 0.0f);
+
+	_u[0] = _u[1] = _u[2] = _u[3] = 0.0f;
+}
+
+void SihModel::update_motors(const float outputs[NB_MOTORS], const float dt)
+{
+	for (int i = 0; i < NB_MOTORS; i++) { // saturate the motor signals
+		if ((_vehicle == VehicleType::FW && i < 3) || (_vehicle == VehicleType::TS && i > 3)) {
+			_u[i] = outputs[i];
+
+		} else {
+			float u_sp = outputs[i];
+			_u[i] = _u[i] + dt / _T_TAU * (u_sp - _u[i]); // first order transfer function with time constant tau
+		}
+	}
+}
+
+void SihModel::generate_force_and_torques()
+{
+	if (_vehicle == VehicleType::MC) {
+		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (+_u[0] + _u[1] + _u[2] + _u[3]));
+		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (-_u[0] + _u[1] + _u[2] - _u[3]),
+				 _L_PITCH * _T_MAX * (+_u[0] - _u[1] + _u[2] - _u[3]),
+				 _Q_MAX * (+_u[0] + _u[1] - _u[2] - _u[3]));
+		_Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
+		_Ma_B = -_KDW * _w_B;   // first order angular damper
+
+	} else if (_vehicle == VehicleType::FW) {
+		_T_B = Vector3f(_T_MAX * _u[3], 0.0f, 0.0f); 	// forward thruster
+		// _Mt_B = Vector3f(_Q_MAX*_u[3], 0.0f,0.0f); 	// thruster torque
+		_Mt_B = Vector3f();
+		generate_fw_aerodynamics();
+
+	} else if (_vehicle == VehicleType::TS) {
+		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (_u[0] + _u[1]));
+		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (_u[1] - _u[0]), 0.0f, _Q_MAX * (_u[1] - _u[0]));
+		generate_ts_aerodynamics();
+
+		// _Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
+		// _Ma_B = -_KDW * _w_B;   // first order angular damper
+	}
+}
+
+void SihModel::generate_fw_aerodynamics()
+{
+	_v_B = _C_IB.transpose() * _v_I; 	// velocity in body frame [m/s]
+	float altitude = _H0 - _p_I(2);
+	_wing_l.update_aero(_v_B, _w_B, altitude, _u[0]*FLAP_MAX);
+	_wing_r.update_aero(_v_B, _w_B, altitude, -_u[0]*FLAP_MAX);
+	_tailplane.update_aero(_v_B, _w_B, altitude, _u[1]*FLAP_MAX, _T_MAX * _u[3]);
+	_fin.update_aero(_v_B, _w_B, altitude, _u[2]*FLAP_MAX, _T_MAX * _u[3]);
+	_fuselage.update_aero(_v_B, _w_B, altitude);
+
+	// sum of aerodynamic forces
+	_Fa_I = _C_IB * (_wing_l.get_Fa() + _wing_r.get_Fa() + _tailplane.get_Fa() + _fin.get_Fa() + _fuselage.get_Fa()) - _KDV
+		* _v_I;
+
+	// aerodynamic moments
+	_Ma_B = _wing_l.get_Ma() + _wing_r.get_Ma() + _tailplane.get_Ma() + _fin.get_Ma() + _fuselage.get_Ma() - _KDW * _w_B;
+}
+
+void SihModel::generate_ts_aerodynamics()
+{
+	// velocity in body frame [m/s]
+	_v_B = _C_IB.transpose() * _v_I;
+
+	// the aerodynamic is resolved in a frame like a standard aircraft (nose-right-belly)
+	Vector3f v_ts = _C_BS.transpose() * _v_B;
+	Vector3f w_ts = _C_BS.transpose() * _w_B;
+	float altitude = _H0 - _p_I(2);
+
+	Vector3f Fa_ts{};
+	Vector3f Ma_ts{};
+
+	for (int i = 0; i < NB_TS_SEG; i++) {
+		if (i <= NB_TS_SEG / 2) {
+			_ts[i].update_aero(v_ts, w_ts, altitude, _u[5]*TS_DEF_MAX, _T_MAX * _u[1]);
+
+		} else {
+			_ts[i].update_aero(v_ts, w_ts, altitude, -_u[4]*TS_DEF_MAX, _T_MAX * _u[0]);
+		}
+
+		Fa_ts += _ts[i].get_Fa();
+		Ma_ts += _ts[i].get_Ma();
+	}
+
+	_Fa_I = _C_IB * _C_BS * Fa_ts - _KDV * _v_I; 	// sum of aerodynamic forces
+	_Ma_B = _C_BS * Ma_ts - _KDW * _w_B; 	// aerodynamic moments
+}
+
+void SihModel::equations_of_motion(const float dt)
+{
+	_C_IB = matrix::Dcm<float>(_q); // body to inertial transformation
+
+	// Equations of motion of a rigid body
+	_p_I_dot = _v_I;                        // position differential
+	_v_I_dot = (_W_I + _Fa_I + _C_IB * _T_B) / _MASS;   // conservation of linear momentum
+	// _q_dot = _q.derivative1(_w_B);              // attitude differential
+	_dq = Quatf::expq(0.5f * dt * _w_B);
+	_w_B_dot = _Im1 * (_Mt_B + _Ma_B - _w_B.cross(_I * _w_B)); // conservation of angular momentum
+
+	// fake ground, avoid free fall
+	if (_p_I(2) > 0.0f && (_v_I_dot(2) > 0.0f || _v_I(2) > 0.0f)) {
+		if (_vehicle == VehicleType::MC || _vehicle == VehicleType::TS) {
+			if (!_grounded) {    // if we just hit the floor
+				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
+				_v_I_dot = -_v_I / dt;
+
+			} else {
+				_v_I_dot.setZero();
+			}
+
+			_v_I.setZero();
+			_w_B.setZero();
+			_grounded = true;
+
+		} else if (_vehicle == VehicleType::FW) {
+			if (!_grounded) {    // if we just hit the floor
+				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
+				_v_I_dot(2) = -_v_I(2) / dt;
+
+			} else {
+				// we only allow negative acceleration in order to takeoff
+				_v_I_dot(2) = fminf(_v_I_dot(2), 0.0f);
+			}
+
+			// integration: Euler forward
+			_p_I = _p_I + _p_I_dot * dt;
+			_v_I = _v_I + _v_I_dot * dt;
+			Eulerf RPY = Eulerf(_q);
+			RPY(0) = 0.0f;	// no roll
+			RPY(1) = radians(0.0f); // pitch slightly up if needed to get some lift
+			_q = Quatf(RPY);
+			_w_B.setZero();
+			_grounded = true;
+		}
+
+	} else {
+		// integration: Euler forward
+		_p_I = _p_I + _p_I_dot * dt;
+		_v_I = _v_I + _v_I_dot * dt;
+		_q = _q * _dq;
+		_q.normalize();
+		// integration Runge-Kutta 4
+		// rk4_update(_p_I, _v_I, _q, _w_B);
+		_w_B = constrain(_w_B + _w_B_dot * dt, -6.0f * M_PI_F, 6.0f * M_PI_F);
+		_grounded = false;
+	}
+}
+
+void SihModel::reconstruct_sensors_signals(Vector3f &accel, Vector3f &gyro)
+{
+	// The sensor signals reconstruction and noise levels are from [1]
+	// [1] Bulka, Eitan, and Meyer Nahon. "Autonomous fixed-wing aerobatics: from theory to flight."
+	//     In 2018 IEEE International Conference on Robotics and Automation (ICRA), pp. 6573-6580. IEEE, 2018.
+
+	// IMU
+	accel = _C_IB.transpose() * (_v_I_dot - Vector3f(0.0f, 0.0f, CONSTANTS_ONE_G)) + noiseGauss3f(0.5f, 1.7f, 1.4f);
+	gyro = _w_B + noiseGauss3f(0.14f, 0.07f, 0.03f);
+}
+
+float SihModel::random_uniform()
+{
+	// xorshift32, uniform in [0, 1]
+	_rand_state ^= _rand_state << 13;
+	_rand_state ^= _rand_state >> 17;
+	_rand_state ^= _rand_state << 5;
+	return (float)(_rand_state >> 8) / (float)((1 << 24) - 1);
+}
+
+float SihModel::generate_wgn()   // generate white Gaussian noise sample with std=1
+{
+	// algorithm 1:
+	// float temp=((float)(rand()+1))/(((float)RAND_MAX+1.0f));
+	// return sqrtf(-2.0f*logf(temp))*cosf(2.0f*M_PI_F*rand()/RAND_MAX);
+	// algorithm 2: from BlockRandGauss.hpp
+	float X;
+
+	if (_wgn_phase) {
+		do {
+			float U1 = random_uniform();
+			float U2 = random_uniform();
+			_wgn_V1 = 2.0f * U1 - 1.0f;
+			_wgn_V2 = 2.0f * U2 - 1.0f;
+			_wgn_S = _wgn_V1 * _wgn_V1 + _wgn_V2 * _wgn_V2;
+		} while (_wgn_S >= 1.0f || fabsf(_wgn_S) < 1e-8f);
+
+		X = _wgn_V1 * float(sqrtf(-2.0f * float(logf(_wgn_S)) / _wgn_S));
+
+	} else {
+		X = _wgn_V2 * float(sqrtf(-2.0f * float(logf(_wgn_S)) / _wgn_S));
+	}
+
+	_wgn_phase = !_wgn_phase;
+	return X;
+}
+
+Vector3f SihModel::noiseGauss3f(float stdx, float stdy, float stdz)
+{
+	return Vector3f(generate_wgn() * stdx, generate_wgn() * stdy, generate_wgn() * stdz);
+}
@@ -0,0 +1,209 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file sih_model.hpp
+ * Vehicle model of the Simulator in Hardware, independent of uORB and parameters
+ * so that it can also be stepped outside of the simulator_sih module (see batch/).
+ */
+
+// The sensor signals reconstruction and noise levels are from [1]
+// [1] Bulka E, and Nahon M, "Autonomous fixed-wing aerobatics: from theory to flight."
+//     In 2018 IEEE International Conference on Robotics and Automation (ICRA), pp. 6573-6580. IEEE, 2018.
+// The aerodynamic model is from [2]
+// [2] Khan W, supervised by Nahon M, "Dynamics modeling of agile fixed-wing unmanned aerial vehicles."
+//     McGill University (Canada), PhD thesis, 2016.
+// The quaternion integration are from [3]
+// [3] Sveier A, Sjøberg AM, Egeland O. "Applied Runge–Kutta–Munthe-Kaas Integration for the Quaternion Kinematics."
+//     Journal of Guidance, Control, and Dynamics. 2019 Dec;42(12):2747-54.
+// The tailsitter model is from [4]
+// [4] Chiappinelli R, supervised by Nahon M, "Modeling and control of a flying wing tailsitter unmanned aerial vehicle."
+//     McGill University (Canada), Masters Thesis, 2018.
+
+#pragma once
+
+#include "aero.hpp"
+
+#include <stdint.h>
+
+#include <matrix/matrix/math.hpp>   // matrix, vectors, dcm, quaterions
+#include <conversion/rotation.h>    // math::radians,
+#include <lib/atmosphere/atmosphere.h>        // to get the physical constants
+#include <lib/geo/geo.h>                      // CONSTANTS_ONE_G
+
+class SihModel
+{
+public:
+	enum class VehicleType {MC, FW, TS};
+
+	static constexpr uint16_t NB_MOTORS = 6;
+
+	// physical parameters of the model, the defaults are the ones of sih_params.c
+	struct Parameters {
+		VehicleType vehicle{VehicleType::MC};
+		float mass{1.0f};                 // [kg]
+		float ixx{0.025f}, iyy{0.025f}, izz{0.030f}; // inertia [kg*m^2]
+		float ixy{0.0f}, ixz{0.0f}, iyz{0.0f};
+		float t_max{5.0f};                // max thrust per motor [N]
+		float q_max{0.1f};                // max torque per motor [Nm]
+		float l_roll{0.2f};               // roll arm [m]
+		float l_pitch{0.2f};              // pitch arm [m]
+		float kdv{1.0f};                  // first order drag coefficient [N/(m/s)]
+		float kdw{0.025f};                // first order angular damper [Nm/(rad/s)]
+		float h0{489.4f};                 // initial AMSL altitude [m]
+		float t_tau{0.05f};               // motor time constant [s]
+	};
+
+	void set_parameters(const Parameters &params);
+
+	// reset the state, seed initializes the sensor noise generator
+	void init_variables(uint32_t seed = 1234);
+
+	// apply new motor signals from the mixer, dt is the time since the previous ones
+	void update_motors(const float outputs[NB_MOTORS], const float dt);
+
+	// generate the motors thrust and torque in the body frame
+	void generate_force_and_torques();
+
+	// apply the equations of motion of a rigid body and integrate one step
+	void equations_of_motion(const float dt);
+
+	// reconstruct the noisy IMU signals
+	void reconstruct_sensors_signals(matrix::Vector3f &accel, matrix::Vector3f &gyro);
+
+	float generate_wgn();    // generate white Gaussian noise sample
+
+	// generate white Gaussian noise sample as a 3D vector with specified std
+	matrix::Vector3f noiseGauss3f(float stdx, float stdy, float stdz);
+
+	VehicleType vehicle() const { return _vehicle; }
+	bool grounded() const { return _grounded; }
+	const matrix::Vector3f &position() const { return _p_I; }
+	const matrix::Vector3f &velocity() const { return _v_I; }
+	const matrix::Quatf &attitude() const { return _q; }
+	const matrix::Vector3f &angular_velocity() const { return _w_B; }
+	const float *motors() const { return _u; }
+
+protected:
+	// hard constants
+	static constexpr float T1_C = 15.0f;                        // ground temperature in Celsius
+	static constexpr float T1_K = T1_C - atmosphere::kAbsoluteNullCelsius;   // ground temperature in Kelvin
+	static constexpr float TEMP_GRADIENT = -6.5f / 1000.0f;    // temperature gradient in degrees per metre
+	// Aerodynamic coefficients
+	static constexpr float RHO = 1.225f; 		// air density at sea level [kg/m^3]
+	static constexpr float SPAN = 0.86f; 	// wing span [m]
+	static constexpr float MAC = 0.21f; 	// wing mean aerodynamic chord [m]
+	static constexpr float RP = 0.1f; 	// radius of the propeller [m]
+	static constexpr float FLAP_MAX = M_PI_F / 12.0f; // 15 deg, maximum control surface deflection
+
+	void generate_fw_aerodynamics();
+	void generate_ts_aerodynamics();
+
+	bool        _grounded{true};// whether the vehicle is on the ground
+
+	matrix::Vector3f    _T_B{};           // thrust force in body frame [N]
+	matrix::Vector3f    _Fa_I{};          // aerodynamic force in inertial frame [N]
+	matrix::Vector3f    _Mt_B{};          // thruster moments in the body frame [Nm]
+	matrix::Vector3f    _Ma_B{};          // aerodynamic moments in the body frame [Nm]
+	matrix::Vector3f    _p_I{};           // inertial position [m]
+	matrix::Vector3f    _v_I{};           // inertial velocity [m/s]
+	matrix::Vector3f    _v_B{};           // body frame velocity [m/s]
+	matrix::Vector3f    _p_I_dot{};       // inertial position differential
+	matrix::Vector3f    _v_I_dot{};       // inertial velocity differential
+	matrix::Quatf       _q{};             // quaternion attitude
+	matrix::Dcmf        _C_IB{};          // body to inertial transformation
+	matrix::Vector3f    _w_B{};           // body rates in body frame [rad/s]
+	matrix::Quatf       _dq{};            // quaternion differential
+	matrix::Vector3f    _w_B_dot{};       // body rates differential
+	float       _u[NB_MOTORS] {};         // thruster signals
+
+	VehicleType _vehicle = VehicleType::MC;
+
+	// aerodynamic segments for the fixedwing
+	AeroSeg _wing_l = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, -SPAN / 4.0f, 0.0f), 3.0f,
+				  SPAN / MAC, MAC / 3.0f);
+	AeroSeg _wing_r = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, SPAN / 4.0f, 0.0f), -3.0f,
+				  SPAN / MAC, MAC / 3.0f);
+	AeroSeg _tailplane = AeroSeg(0.3f, 0.1f, 0.0f, matrix::Vector3f(-0.4f, 0.0f, 0.0f), 0.0f, -1.0f, 0.05f, RP);
+	AeroSeg _fin = AeroSeg(0.25, 0.18, 0.0f, matrix::Vector3f(-0.45f, 0.0f, -0.1f), -90.0f, -1.0f, 0.12f, RP);
+	AeroSeg _fuselage = AeroSeg(0.2, 0.8, 0.0f, matrix::Vector3f(0.0f, 0.0f, 0.0f), -90.0f);
+
+	// aerodynamic segments for the tailsitter
+	static constexpr const int NB_TS_SEG = 11;
+	static constexpr const float TS_AR = 3.13f;
+	static constexpr const float TS_CM = 0.115f;	// longitudinal position of the CM from trailing edge
+	static constexpr const float TS_RP = 0.0625f;	// propeller radius [m]
+	static constexpr const float TS_DEF_MAX = math::radians(39.0f); 	// max deflection
+	matrix::Dcmf _C_BS = matrix::Dcmf(matrix::Eulerf(0.0f, math::radians(90.0f), 0.0f)); // segment to body 90 deg pitch
+	AeroSeg _ts[NB_TS_SEG] = {
+		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM, -0.239f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM, -0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
+		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM, -0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
+		AeroSeg(0.0750f, 0.231f, 0.0f, matrix::Vector3f(0.173f - TS_CM,  0.000f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM,  0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
+		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM,  0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
+		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM,  0.239f, 0.0f), 0.0f, TS_AR)
+	};
+
+	// AeroSeg _ts[NB_TS_SEG] = {
+	// 	AeroSeg(0.0225f, 0.110f, -90.0f, matrix::Vector3f(0.0f, -0.239f, TS_CM-0.083f), 0.0f, TS_AR),
+	// 	AeroSeg(0.0383f, 0.125f, -90.0f, matrix::Vector3f(0.0f, -0.208f, TS_CM-0.094f), 0.0f, TS_AR, 0.063f),
+	// 	AeroSeg(0.0884f, 0.148f, -90.0f, matrix::Vector3f(0.0f, -0.143f, TS_CM-0.111f), 0.0f, TS_AR, 0.063f, TS_RP),
+	// 	AeroSeg(0.0633f, 0.176f, -90.0f, matrix::Vector3f(0.0f, -0.068f, TS_CM-0.132f), 0.0f, TS_AR, 0.063f),
+	// 	AeroSeg(0.0750f, 0.231f, -90.0f, matrix::Vector3f(0.0f,  0.000f, TS_CM-0.173f), 0.0f, TS_AR),
+	// 	AeroSeg(0.0633f, 0.176f, -90.0f, matrix::Vector3f(0.0f,  0.068f, TS_CM-0.132f), 0.0f, TS_AR, 0.063f),
+	// 	AeroSeg(0.0884f, 0.148f, -90.0f, matrix::Vector3f(0.0f,  0.143f, TS_CM-0.111f), 0.0f, TS_AR, 0.063f, TS_RP),
+	// 	AeroSeg(0.0383f, 0.125f, -90.0f, matrix::Vector3f(0.0f,  0.208f, TS_CM-0.094f), 0.0f, TS_AR, 0.063f),
+	// 	AeroSeg(0.0225f, 0.110f, -90.0f, matrix::Vector3f(0.0f,  0.239f, TS_CM-0.083f), 0.0f, TS_AR)
+	// 	};
+
+	// parameters
+	float _MASS, _T_MAX, _Q_MAX, _L_ROLL, _L_PITCH, _KDV, _KDW, _H0, _T_TAU;
+	matrix::Vector3f _W_I;  // weight of the vehicle in inertial frame [N]
+	matrix::Matrix3f _I;    // vehicle inertia matrix
+	matrix::Matrix3f _Im1;  // inverse of the inertia matrix
+
+private:
+	float random_uniform();
+
+	// white Gaussian noise generator state, one per model so that instances can run in parallel
+	uint32_t _rand_state{1234};
+	float _wgn_V1{0.f}, _wgn_V2{0.f}, _wgn_S{0.f};
+	bool _wgn_phase{true};
+};
@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_microbench_uorb_contention.cpp
+ * Microbenchmark uORB copy latency with concurrent publisher and subscribers.
+ *
+ * Run with and without CONFIG_ORB_SEQLOCK to compare the locked and the
+ * lock-free (seqlock) copy paths.
+ */
+
+#include <unit_test.h>
+
+#include <pthread.h>
+
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_config.h>
+
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/orb_test_large.h>
+#include <uORB/topics/orb_test_medium.h>
+
+namespace MicroBenchORBContention
+{
+
+static constexpr int MAX_READERS = 8;
+static constexpr int COPIES_PER_READER = 10000;
+
+class MicroBenchORBContention : public UnitTest
+{
+public:
+	bool run_tests() override;
+
+private:
+
+	struct ReaderContext {
+		MicroBenchORBContention *bench;
+		const orb_metadata *meta;
+		perf_counter_t perf;
+	};
+
+	bool time_px4_uorb_contention_large();
+	bool time_px4_uorb_contention_medium_queue();
+
+	bool run_contention(const orb_metadata *meta, int num_readers);
+
+	static void *publisher_thread(void *arg);
+	static void *reader_thread(void *arg);
+
+	px4::atomic_bool _should_exit{false};
+	const orb_metadata *_pub_meta{nullptr};
+};
+
+bool MicroBenchORBContention::run_tests()
+{
+	ut_run_test(time_px4_uorb_contention_large);
+	ut_run_test(time_px4_uorb_contention_medium_queue);
+
+	return (_tests_failed == 0);
+}
+
+ut_declare_test_c(test_microbench_uorb_contention, MicroBenchORBContention)
+
+void *MicroBenchORBContention::publisher_thread(void *arg)
+{
+	MicroBenchORBContention *bench = static_cast<MicroBenchORBContention *>(arg);
+
+	// orb_test_large is the largest of the test topics, use it as publish buffer for both
+	orb_test_large_s msg{};
+	orb_advert_t pub = orb_advertise(bench->_pub_meta, &msg);
+
+	while (!bench->_should_exit.load()) {
+		msg.timestamp = hrt_absolute_time();
+		msg.val++;
+		orb_publish(bench->_pub_meta, pub, &msg);
+	}
+
+	orb_unadvertise(pub);
+
+	return nullptr;
+}
+
+void *MicroBenchORBContention::reader_thread(void *arg)
+{
+	ReaderContext *ctx = static_cast<ReaderContext *>(arg);
+
+	orb_test_large_s msg{};
+	uORB::Subscription sub{ctx->meta};
+
+	for (int i = 0; i < COPIES_PER_READER; i++) {
+		perf_begin(ctx->perf);
+		sub.copy(&msg);
+		perf_end(ctx->perf);
+	}
+
+	return nullptr;
+}
+
+bool MicroBenchORBContention::run_contention(const orb_metadata *meta, int num_readers)
+{
+	_should_exit.store(false);
+	_pub_meta = meta;
+
+	pthread_t publisher{};
+
+	if (pthread_create(&publisher, nullptr, &publisher_thread, this) != 0) {
+		PX4_ERR("publisher pthread_create failed");
+		return false;
+	}
+
+	// give the publisher time to advertise
+	px4_usleep(10000);
+
+	pthread_t readers[MAX_READERS] {};
+	ReaderContext contexts[MAX_READERS] {};
+	char perf_names[MAX_READERS][48] {};
+
+	for (int i = 0; i < num_readers; i++) {
+		snprintf(perf_names[i], sizeof(perf_names[i]), "%s copy %d/%d readers", meta->o_name, i, num_readers);
+		contexts[i] = ReaderContext{this, meta, perf_alloc(PC_ELAPSED, perf_names[i])};
+		pthread_create(&readers[i], nullptr, &reader_thread, &contexts[i]);
+	}
+
+	for (int i = 0; i < num_readers; i++) {
+		pthread_join(readers[i], nullptr);
+	}
+
+	_should_exit.store(true);
+	pthread_join(publisher, nullptr);
+
+	for (int i = 0; i < num_readers; i++) {
+		perf_print_counter(contexts[i].perf);
+		perf_free(contexts[i].perf);
+	}
+
+	printf("\n");
+
+	return true;
+}
+
+bool MicroBenchORBContention::time_px4_uorb_contention_large()
+{
+#if defined(CONFIG_ORB_SEQLOCK)
+	printf("copy path: seqlock\n");
+#else
+	printf("copy path: locked\n");
+#endif // CONFIG_ORB_SEQLOCK
+
+	for (int num_readers = 1; num_readers <= MAX_READERS; num_readers *= 2) {
+		ut_assert_true(run_contention(ORB_ID(orb_test_large), num_readers));
+	}
+
+	return true;
+}
+
+bool MicroBenchORBContention::time_px4_uorb_contention_medium_queue()
+{
+	for (int num_readers = 1; num_readers <= MAX_READERS; num_readers *= 2) {
+		ut_assert_true(run_contention(ORB_ID(orb_test_medium_queue), num_readers));
+	}
+
+	return true;
+}
+
+} // namespace MicroBenchORBContention
@@ -57,6 +57,9 @@ int uorb_main(int argc, char *argv[])
 
 	} else if (!strcmp(argv[1], "top")) {
 		return uorb_top(argv + 2, argc - 2);
+
+	} else if (!strcmp(argv[1], "latency")) {
+		return uorb_latency(argv + 2, argc - 2);
 	}
 
 	usage();
@@ -84,6 +87,11 @@ modules are allowed to publish which topics. This is used for system-wide replay
 ### Examples
 Monitor topic publication rates. Besides `top`, this is an important command for general system inspection:
 $ uorb top
+
+If compiled with CONFIG_ORB_LATENCY_STATS, histograms of the time from publication until the message is copied
+by a subscriber and until each callback is dispatched are recorded per topic, together with the number of queued
+messages lost by subscribers:
+$ uorb latency sensor_gyro vehicle_angular_velocity
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
@@ -92,4 +100,6 @@ $ uorb top
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics with subscribers", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('1', "run only once, then exit", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("latency", "Print topic latency histograms and lost messages");
+	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match", true);
 }